@@ -27,12 +27,14 @@
 #endif
 #include <getopt.h>
 
+#include <string>
 #include <vector>
+#include <iosfwd>
 #include <stdexcept>
 
 #include "sys.hpp"
 
-extern const char program[];
+extern const char program[] EXT_VISIBLE;
 extern const char verdate[];
 extern const char license[];
 
@@ -75,6 +77,12 @@ public:
     char *const *argv;
     size_t       ext_argc;
     char *const *ext_argv;
+    // stev: the streams which the actions write their output and
+    // their errors to -- 'std::cout' and 'std::cerr' by default;
+    // the options of the extension functions take those of their
+    // parent, thus each request of 'tree --serve' has its own
+    std::ostream *out;
+    std::ostream *err;
 
 protected:
     options_t();
@@ -128,6 +136,10 @@ protected:
     virtual void dump_opts() const;
     virtual const char* act_name() const;
     void dump() const;
+
+private:
+    // stev: the copy of 'argv[0]' which 'home_dir' refers into
+    std::string home_buf;
 };
 
 class input_options_t : public options_t
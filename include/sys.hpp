@@ -33,6 +33,8 @@
 #include <limits>
 #include <string>
 #include <memory>
+#include <map>
+#include <mutex>
 #include <stdexcept>
 #include <algorithm>
 #include <functional>
@@ -66,7 +68,12 @@
 #define UINTPTR_FORMAT \
     "0x%0" STRINGIFY(UINTPTR_FMT_WIDTH) PRIxPTR
 
-#define EXT_FUNC_ENTRY extern "C"
+// stev: the type libraries are built having their symbols hidden;
+// they export their entry points and the few symbols 'EXT_VISIBLE'
+// marks for the modules depending on them -- e.g. their printers
+#define EXT_VISIBLE __attribute__ ((visibility("default")))
+
+#define EXT_FUNC_ENTRY extern "C" EXT_VISIBLE
 
 namespace Sys {
 
@@ -320,6 +327,10 @@ inline std::string format(const char *fmt, ...)
     return str;
 }
 
+// stev: the identity of the file 'file': its device, inode,
+// size and modification time; empty if 'file' is not found
+std::string file_stamp(const char* file);
+
 class file_t
 {
 public:
@@ -357,6 +368,21 @@ private:
 
 typedef int ext_func_result_t;
 
+#ifdef STATIC_EXT_FUNCS
+// stev: the extension functions linked statically into the program,
+// as defined by the program itself: 'mod' is the name of the module
+// sans the '.so' suffix and relative to the program's source dir
+struct static_ext_func_t
+{
+    const char* mod;
+    const char* func;
+    void*       ptr;
+};
+
+extern const static_ext_func_t static_ext_funcs[];
+extern const size_t n_static_ext_funcs;
+#endif
+
 class base_ext_func_t
 {
 public:
@@ -392,6 +418,10 @@ public:
     bool is_loaded() const
     { return mod_func; }
 
+    // stev: the identity of the file of the module loaded:
+    // its path, device, inode, size and modification time
+    std::string stamp() const;
+
 protected:
     void *mod_func;
 
@@ -400,6 +430,8 @@ private:
 
     void error(const char* msg, ...) PRINTF_FMT(2);
 
+    // stev: when STATIC_EXT_FUNCS is defined 'handle'
+    // is the entry of 'static_ext_funcs' loaded
     void *handle;
 };
 
@@ -419,28 +451,46 @@ public:
     }
 };
 
+// stev: the functions loaded are kept till the end of the process,
+// one per name -- thus being shared by the threads -- for any next
+// call naming them again
+
+template<typename O, typename P>
+const ext_func_t<O, P>& load_ext_func(
+    const P* opt, const char* prefix = nullptr)
+{
+    static std::map<std::string, std::unique_ptr<ext_func_t<O, P>>> funcs;
+    static std::mutex mutex;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& ext_func = funcs[std::string(opt->ext_func_name)
+        .append(1, 0).append(prefix ? prefix : "")];
+    if (!ext_func) {
+        std::unique_ptr<ext_func_t<O, P>> func(new ext_func_t<O, P>);
+        func->load(
+            opt->home_dir,
+            opt->ext_func_name,
+#ifdef DEBUG
+            opt->debug,
+#endif
+            prefix);
+        ext_func = std::move(func);
+    }
+
+    return *ext_func;
+}
+
 template<typename O, typename P>
 ext_func_result_t run_ext_func(
     const O* obj, const P* opt, const char* prefix = nullptr)
 {
-    static ext_func_t<O, P> ext_func;
-
     // stev: opt->ext_func_name == nullptr means: 
     // do not run any extension func; only return
     // zero -- indicating a successful completion
     if (opt->ext_func_name == nullptr)
         return 0;
 
-    if (!ext_func.is_loaded())
-        ext_func.load(
-            opt->home_dir,
-            opt->ext_func_name,
-#ifdef DEBUG
-            opt->debug,
-#endif
-            prefix);
-
-    return ext_func.call(obj, opt);
+    return load_ext_func<O>(opt, prefix).call(obj, opt);
 }
 
 template<typename O, typename P>
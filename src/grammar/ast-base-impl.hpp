@@ -41,11 +41,28 @@ struct Arg<R, const char*> : public ArgResult<const char*>
 
     static const char* alloc(BaseAST<R>* self, const char* arg)
     {
-        auto sz = 1 + strlen(arg);
+        return Arg<R, str_t>::alloc(self, str_t(arg)).ptr;
+    }
+};
+
+template<typename R>
+struct Arg<R, str_t> : public ArgResult<str_t>
+{
+    static str_t alloc(BaseAST<R>* self, const str_t& arg)
+    {
+        auto cons = self->cons.get();
+        if (cons != nullptr) {
+            if (auto str = cons->find_str(arg))
+                return str_t(str, arg.len);
+        }
         auto ptr = static_cast<char*>(
-            self->raw_alloc.template allocate<char>(sz));
-        memcpy(ptr, arg, sz);
-        return ptr;
+            self->raw_alloc.template allocate<char>(arg.len + 1));
+        memcpy(ptr, arg.ptr, arg.len);
+        ptr[arg.len] = 0;
+        str_t res(ptr, arg.len);
+        if (cons != nullptr)
+            cons->insert_str(res);
+        return res;
     }
 };
 
@@ -98,9 +115,18 @@ struct Arg<R, const std::list<const T*>*> :
         auto sz = arg ? arg->size() : 0;
         T const** ptrs = nullptr;
         if (sz) {
+            auto cons = self->cons.get();
+            ConsTable::key_t key;
+            if (cons != nullptr) {
+                key = ConsTable::list_key(arg->begin(), arg->end());
+                if (auto list = cons->find_list(key))
+                    return list_t(sz, static_cast<T const* const*>(list));
+            }
             ptrs = static_cast<T const**>(
                 self->raw_alloc.template allocate<T const*>(sz));
             std::copy(arg->begin(), arg->end(), ptrs);
+            if (cons != nullptr)
+                cons->insert_list(std::move(key), ptrs);
         }
         return list_t(sz, ptrs);
     }
@@ -123,6 +149,15 @@ struct Arg<R, std::pair<size_t, T const* const*>> :
     static list_t alloc(AST* self, const list_t arg)
     {
         check(self, arg);
+        auto cons = self->cons.get();
+        if (cons == nullptr || arg.first == 0)
+            return arg;
+        // stev: the list was already allocated by the caller;
+        // when sharing it, that memory is left unused
+        auto key = ConsTable::list_key(arg.second, arg.second + arg.first);
+        if (auto list = cons->find_list(key))
+            return list_t(arg.first, static_cast<T const* const*>(list));
+        cons->insert_list(std::move(key), arg.second);
         return arg;
     }
 };
@@ -40,7 +40,10 @@ PoolAllocator::PoolAllocator(
     destr(_destr),
     nobjs(_nobjs),
     pool_sz(_pool_sz),
-    nptrs(0)
+    nptrs(0),
+    padding(0),
+    rollbacks(0),
+    high_water(0)
 {
     auto n = nobjs * sizeof(char*);
     auto p = realloc(n + pool_sz);
@@ -133,6 +136,12 @@ bool PoolAllocator::find(const void* what, size_t& index) const
 
 PoolAllocator::~PoolAllocator()
     noexcept
+{
+    destroy();
+}
+
+void PoolAllocator::destroy()
+    noexcept
 {
 #ifdef DEBUG
     if (debug) {
@@ -168,6 +177,10 @@ void* PoolAllocator::allocate(size_t nbytes, size_t align)
     auto r = ptr + align;
     ptr = r + nbytes;
     ptrs[nptrs ++] = r;
+    padding += align;
+    auto n = Ext::ptr_diff(ptr, pool);
+    if (high_water < n)
+        high_water = n;
 #ifdef DEBUG
     if (debug) {
         using namespace std;
@@ -177,12 +190,175 @@ void* PoolAllocator::allocate(size_t nbytes, size_t align)
     return r;
 }
 
+void PoolAllocator::clear()
+    noexcept
+{
+    destroy();
+    ptr = pool;
+    nptrs = 0;
+    padding = 0;
+    rollbacks = 0;
+    high_water = 0;
+}
+
 void PoolAllocator::rollback(void* obj)
 {
     if (nptrs < 1 || ptrs[nptrs - 1] != obj)
         throw BadRollback(this, obj);
     ptr = static_cast<char*>(obj);
     nptrs --;
+    rollbacks ++;
+}
+
+PoolAllocator::stats_t PoolAllocator::stats() const
+{
+    stats_t r;
+    r.n_obj = nptrs;
+    r.max_obj = nobjs;
+    r.n_bytes = Ext::ptr_diff(ptr, pool);
+    r.max_bytes = pool_sz;
+    r.n_padding = padding;
+    r.n_rollback = rollbacks;
+    r.high_water = high_water;
+    return r;
+}
+
+void PoolAllocator::swap(PoolAllocator& alloc) noexcept
+{
+    // stev: the name, the destructor function and
+    // the debug flag remain with each allocator
+    mem_t t(std::move(static_cast<mem_t&>(alloc)));
+    static_cast<mem_t&>(alloc) = std::move(static_cast<mem_t&>(*this));
+    static_cast<mem_t&>(*this) = std::move(t);
+    std::swap(nobjs, alloc.nobjs);
+    std::swap(pool_sz, alloc.pool_sz);
+    std::swap(pool, alloc.pool);
+    std::swap(ptr, alloc.ptr);
+    std::swap(ptrs, alloc.ptrs);
+    std::swap(nptrs, alloc.nptrs);
+    std::swap(padding, alloc.padding);
+    std::swap(rollbacks, alloc.rollbacks);
+    std::swap(high_water, alloc.high_water);
+}
+
+void mem_stats_t::print(std::ostream& ost, const char* prefix) const
+{
+    using namespace std;
+    for (auto p : {&node, &raw}) {
+        ost << prefix
+            << "pool=" << p->name
+            << " objs=" << p->stats.n_obj
+            << " max-objs=" << p->stats.max_obj
+            << " bytes=" << p->stats.n_bytes
+            << " max-bytes=" << p->stats.max_bytes
+            << " padding=" << p->stats.n_padding
+            << " rollbacks=" << p->stats.n_rollback
+            << " high-water=" << p->stats.high_water
+            << endl;
+    }
+    for (const auto& t : types) {
+        ost << prefix
+            << "type=" << t.name
+            << " count=" << t.count
+            << " bytes=" << t.bytes
+            << endl;
+    }
+}
+
+void fingerprint_t::add(const char* str, size_t n)
+{
+    add(static_cast<uint64_t>(n));
+    for (; n >= 8; n -= 8, str += 8) {
+        uint64_t v;
+        memcpy(&v, str, 8);
+        add(v);
+    }
+    if (n) {
+        uint64_t v = 0;
+        memcpy(&v, str, n);
+        add(v);
+    }
+}
+
+void fingerprint_t::print(std::ostream& ost) const
+{
+    using namespace std;
+    auto f = ost.flags();
+    auto c = ost.fill();
+    ost << hex << setfill('0')
+        << setw(16) << hi
+        << setw(16) << lo;
+    ost.fill(c);
+    ost.flags(f);
+}
+
+void ConsTable::stats_t::print(std::ostream& ost) const
+{
+    using namespace std;
+    auto f = ost.flags();
+    auto p = ost.precision();
+    ost << "nodes: " << n_node
+        << " shared: " << n_shared
+        << " ratio: " << fixed << setprecision(2)
+        << 100 * ratio() << '%'
+        << " strings: " << n_str
+        << " shared: " << n_shared_str
+        << " lists: " << n_list
+        << " shared: " << n_shared_list;
+    ost.precision(p);
+    ost.flags(f);
+}
+
+const void* ConsTable::find_node(const key_t& key)
+{
+    stat.n_node ++;
+    auto r = nodes.find(key);
+    if (r == nodes.end())
+        return nullptr;
+    stat.n_shared ++;
+    return r->second;
+}
+
+void ConsTable::insert_node(key_t&& key, const void* node)
+{
+    nodes.emplace(std::move(key), node);
+}
+
+const char* ConsTable::find_str(const str_t& str)
+{
+    stat.n_str ++;
+    auto r = strs.find(str);
+    if (r == strs.end())
+        return nullptr;
+    stat.n_shared_str ++;
+    return r->second;
+}
+
+void ConsTable::insert_str(const str_t& str)
+{
+    strs.emplace(str, str.ptr);
+}
+
+const void* ConsTable::find_list(const key_t& key)
+{
+    stat.n_list ++;
+    auto r = lists.find(key);
+    if (r == lists.end())
+        return nullptr;
+    stat.n_shared_list ++;
+    return r->second;
+}
+
+void ConsTable::insert_list(key_t&& key, const void* list)
+{
+    lists.emplace(std::move(key), list);
+}
+
+void ConsTable::clear()
+{
+    nodes.clear();
+    lists.clear();
+    strs.clear();
 }
 
 } // namespace AST
@@ -21,13 +21,20 @@
 #include "config.h"
 
 #include <cstddef>
+#include <cstdint>
 
 #include <new>
 #include <iterator>
 #include <algorithm>
+#include <limits>
 #include <unordered_map>
 #include <iomanip>
 #include <utility>
+#include <typeinfo>
+#include <vector>
+#include <memory>
+#include <string>
+#include <type_traits>
 
 #include "sys.hpp"
 #include "std-ext.hpp"
@@ -109,6 +116,17 @@ public:
         std::string msg;
     };
 
+    struct stats_t
+    {
+        size_t n_obj;      // objects allocated
+        size_t max_obj;    // objects reserved
+        size_t n_bytes;    // bytes used, padding included
+        size_t max_bytes;  // bytes reserved
+        size_t n_padding;  // bytes lost to alignment
+        size_t n_rollback; // rollbacks done
+        size_t high_water; // maximum of 'n_bytes' so far
+    };
+
     template<typename T>
     void* allocate()
     { return allocate(sizeof(T), alignof(T)); }
@@ -118,22 +136,34 @@ public:
     { return allocate(sizeof(T) * n, alignof(T[0])); }
 
     void rollback(void* obj);
+    void swap(PoolAllocator& alloc) noexcept;
+
+    // stev: destroy the objects allocated so far and make
+    // the whole pool available again, keeping its memory
+    void clear() noexcept;
     bool find(const void* what) const;
     bool find(const void* what, size_t&) const;
     size_t size() const { return nptrs; }
+    void* last() const { return nptrs ? ptrs[nptrs - 1] : nullptr; }
+    void* operator[](size_t k) const
+    { SYS_ASSERT(k < nptrs); return ptrs[k]; }
+
+    const char* pool_name() const { return name; }
+    stats_t stats() const;
 
     iterator begin() const { return iterator(ptrs); }
     iterator end() const   { return iterator(ptrs + nptrs); }
 
-protected:
 #ifdef DEBUG
     bool is_debug() const { return debug; }
 #endif
-    const char* pool_name() const { return name; }
+
+protected:
     void** base() const { return ptrs; }
 
 private:
     void* allocate(size_t nbytes, size_t align);
+    void destroy() noexcept;
 
 #ifdef DEBUG
     bool        debug;
@@ -146,6 +176,9 @@ private:
     char       *ptr;
     void      **ptrs;
     size_t      nptrs;
+    size_t      padding;
+    size_t      rollbacks;
+    size_t      high_water;
 };
 
 template<typename R, typename T = const R*>
@@ -178,6 +211,259 @@ struct base_enum_t
     }
 };
 
+struct hash_t : Ext::unary_func_t<size_t, const char*>
+{
+    size_t operator()(const char* key) const // hash pjw
+    {
+        unsigned r = 0, t;
+        for (const char* p = key; *p; p ++) {
+            r = (r << 4) + *p;
+            t = r & 0xf0000000;
+            if (t) {
+                r ^= t >> 24;
+                r ^= t;
+            }
+        }
+        return r;
+    }
+};
+
+struct eq_t : Ext::binary_func_t<bool, const char*>
+{
+    bool operator()(const char* key1, const char* key2) const
+    {
+        return strcmp(key1, key2) == 0;
+    }
+};
+
+struct cmp_t : Ext::binary_func_t<int, const char*>
+{
+    bool operator()(const char* key1, const char* key2) const
+    {
+        return strcmp(key1, key2) < 0;
+    }
+};
+
+// stev: 'str_t' is the type of the string arguments of AST nodes
+// which carry along their length; the strings are still allocated
+// NUL-terminated in 'raw_alloc', thus 'str_t' converts implicitly
+// to 'const char*' for the sake of the consumers that only need a
+// C string; comparisons are length-first followed by 'memcmp'
+
+struct str_t
+{
+    str_t() : ptr(""), len(0) {}
+
+    str_t(const char* _ptr, size_t _len) :
+        ptr(_ptr), len(_len)
+    {}
+
+    explicit str_t(const char* _ptr) :
+        ptr(_ptr), len(strlen(_ptr))
+    {}
+
+    const char* data() const { return ptr; }
+    size_t size() const { return len; }
+
+    operator const char*() const { return ptr; }
+
+    bool equals(const str_t& v) const
+    { return len == v.len && memcmp(ptr, v.ptr, len) == 0; }
+
+    bool equals(const char* v, size_t n) const
+    { return len == n && memcmp(ptr, v, len) == 0; }
+
+    const char* ptr;
+    size_t len;
+};
+
+inline std::ostream& operator<<(std::ostream& ost, const str_t& obj)
+{ ost.write(obj.ptr, obj.len); return ost; }
+
+// stev: 'fingerprint_t' is a 128-bit structural hash of a node:
+// it is computed out of the type of the node and its arguments --
+// strings by content, lists in order and child nodes by their own
+// fingerprints; it therefore depends only on the shape of the tree
+// rooted at the node and not on the addresses of its nodes
+
+struct fingerprint_t
+{
+    fingerprint_t() : lo(0), hi(0) {}
+
+    bool operator==(const fingerprint_t& v) const
+    { return lo == v.lo && hi == v.hi; }
+    bool operator!=(const fingerprint_t& v) const
+    { return lo != v.lo || hi != v.hi; }
+
+    void add(uint64_t val)
+    {
+        lo = mix(lo ^ val);
+        hi = mix((hi + val) * 0x9e3779b97f4a7c15ULL + 1);
+    }
+
+    void add(const char* str)
+    { add(str, strlen(str)); }
+
+    void add(const char* str, size_t len);
+
+    void add(const fingerprint_t& val)
+    { add(val.lo); add(val.hi); }
+
+    void print(std::ostream& ost) const;
+
+    uint64_t lo;
+    uint64_t hi;
+
+private:
+    static uint64_t mix(uint64_t val)
+    {
+        // stev: the finalizer of SplitMix64
+        val ^= val >> 30;
+        val *= 0xbf58476d1ce4e5b9ULL;
+        val ^= val >> 27;
+        val *= 0x94d049bb133111ebULL;
+        val ^= val >> 31;
+        return val;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& ost, const fingerprint_t& obj)
+{ obj.print(ost); return ost; }
+
+// stev: when hash-consing is enabled, 'BaseAST::new_node' returns
+// the node already allocated having the same type and the same
+// arguments -- if any -- instead of allocating a new one; since
+// the node arguments are themselves hash-consed (strings and lists
+// included), comparing them amounts to comparing bit patterns
+
+class ConsTable
+{
+public:
+    ConsTable(const ConsTable&) = delete;
+    ConsTable& operator=(const ConsTable&) = delete;
+
+    ConsTable() {}
+
+    typedef std::string key_t;
+
+    struct stats_t
+    {
+        stats_t() :
+            n_node(0), n_shared(0),
+            n_str(0), n_shared_str(0),
+            n_list(0), n_shared_list(0)
+        {}
+
+        double ratio() const
+        { return n_node ? double(n_shared) / n_node : 0; }
+
+        void print(std::ostream& ost) const;
+
+        size_t n_node;
+        size_t n_shared;
+        size_t n_str;
+        size_t n_shared_str;
+        size_t n_list;
+        size_t n_shared_list;
+    };
+
+    template<typename T, typename... A>
+    static key_t node_key(const A&... args)
+    {
+        key_t key;
+        add(key, &typeid(T));
+        using expand_t = int[];
+        (void) expand_t{0, (add(key, args), 0)...};
+        return key;
+    }
+
+    template<typename I>
+    static key_t list_key(I ptr, I end)
+    {
+        key_t key;
+        for (; ptr != end; ++ ptr)
+            add(key, *ptr);
+        return key;
+    }
+
+    const void* find_node(const key_t& key);
+    void insert_node(key_t&& key, const void* node);
+
+    const char* find_str(const str_t& str);
+    void insert_str(const str_t& str);
+
+    const void* find_list(const key_t& key);
+    void insert_list(key_t&& key, const void* list);
+
+    // stev: forget the nodes, strings and lists
+    // recorded so far, but keep the statistics
+    void clear();
+
+    // stev: as 'clear', but the statistics too
+    void reset()
+    { clear(); stat = stats_t(); }
+
+    const stats_t& stats() const
+    { return stat; }
+
+private:
+    template<typename T>
+    static void add(key_t& key, const T& arg)
+    { key.append(reinterpret_cast<const char*>(&arg), sizeof(T)); }
+
+    typedef std::unordered_map<key_t, const void*> table_t;
+    struct str_hash_t : Ext::unary_func_t<size_t, str_t>
+    {
+        size_t operator()(const str_t& key) const // hash fnv-1a
+        {
+            size_t r = 2166136261u;
+            for (auto p = key.ptr, e = p + key.len; p < e; p ++)
+                r = (r ^ static_cast<unsigned char>(*p)) * 16777619u;
+            return r;
+        }
+    };
+
+    struct str_eq_t : Ext::binary_func_t<bool, str_t>
+    {
+        bool operator()(const str_t& key1, const str_t& key2) const
+        { return key1.equals(key2); }
+    };
+
+    typedef std::unordered_map<str_t, const char*, str_hash_t, str_eq_t> str_table_t;
+
+    table_t     nodes;
+    table_t     lists;
+    str_table_t strs;
+    stats_t     stat;
+};
+
+// stev: the memory statistics of an AST: those of its two
+// pools, followed by the count of nodes of each type -- sorted
+// by type name -- and the number of bytes these nodes occupy;
+// 'print' outputs one 'key=value' record per line
+
+struct mem_stats_t
+{
+    struct pool_t
+    {
+        const char* name;
+        PoolAllocator::stats_t stats;
+    };
+
+    struct type_t
+    {
+        const char* name;
+        size_t count;
+        size_t bytes;
+    };
+
+    void print(std::ostream& ost, const char* prefix = "") const;
+
+    pool_t node;
+    pool_t raw;
+    std::vector<type_t> types;
+};
+
 template <typename R>
 class BaseAST
 {
@@ -213,7 +499,42 @@ protected:
             "raw",
             _raw_nobjs,
             _raw_pool_sz),
-        root(nullptr)
+        root(nullptr),
+        use_prints(false)
+    {}
+
+    // stev: the sizes of the node and of the raw pools
+    // needed for holding a copy of a subgraph of nodes
+    // (see 'copier_t' below)
+    struct extent_t
+    {
+        extent_t() :
+            node_nobjs(0), node_pool_sz(0),
+            raw_nobjs(0), raw_pool_sz(0)
+        {}
+
+        size_t node_nobjs;
+        size_t node_pool_sz;
+        size_t raw_nobjs;
+        size_t raw_pool_sz;
+    };
+
+    BaseAST(
+#ifdef DEBUG
+        bool _debug,
+#endif
+        const extent_t& ext,
+        PoolAllocator::destr_t _node_destr
+    ) :
+        BaseAST(
+#ifdef DEBUG
+            _debug,
+#endif
+            std::max<size_t>(ext.node_nobjs, 1),
+            std::max<size_t>(ext.node_pool_sz, 1),
+            std::max<size_t>(ext.raw_nobjs, 1),
+            std::max<size_t>(ext.raw_pool_sz, 1),
+            _node_destr)
     {}
 
     ~BaseAST()
@@ -221,18 +542,230 @@ protected:
 
     size_t num_node() const { return node_alloc.size(); }
 
+#ifdef DEBUG
+    bool is_debug() const { return node_alloc.is_debug(); }
+#endif
+
+    template<typename T>
+    class type_iterator;
+
+    template<typename T>
+    class type_range_t;
+
+    // stev: the nodes of exact (dynamic) type 'T', in allocation
+    // order; note that the type index is maintained by 'alloc_node'
+    // as nodes get allocated, thus the functions below do not scan
+    // the node pool
+
+    template<typename T>
+    type_range_t<T> nodes_of() const;
+
+    template<typename T>
+    size_t count() const
+    { auto p = find_type<T>(); return p ? p->size() : 0; }
+
+    mem_stats_t mem_stats() const;
+
+    // stev: fingerprints are computed for the nodes
+    // created while 'fingerprints' is enabled; it has
+    // to be enabled prior to the creation of any node
+    bool fingerprints() const { return use_prints; }
+    void fingerprints(bool enable)
+    {
+        SYS_ASSERT(!enable || num_node() == 0);
+        use_prints = enable;
+        prints.clear();
+    }
+
+    bool fingerprint(const root_t* node, fingerprint_t& res) const;
+
+    bool hash_cons() const { return cons != nullptr; }
+    void hash_cons(bool enable)
+    { cons.reset(enable ? new ConsTable() : nullptr); }
+
+    ConsTable::stats_t cons_stats() const
+    { return cons ? cons->stats() : ConsTable::stats_t(); }
+
     static void node_destr(void *ptr) noexcept
     { static_cast<root_t*>(ptr)->~root_t(); }
 
     template<typename T, typename... A>
     const T* new_node(A&&... args)
+    {
+        if (cons == nullptr)
+            return alloc_node<T>(std::forward<A>(args)...);
+        auto key = ConsTable::node_key<T>(args...);
+        if (auto p = cons->find_node(key))
+            return static_cast<const T*>(p);
+        auto r = alloc_node<T>(std::forward<A>(args)...);
+        cons->insert_node(std::move(key), r);
+        return r;
+    }
+
+    template<typename T, typename... A>
+    const T* alloc_node(A&&... args)
     {
         auto p = node_alloc.allocate<T>();
-        try         { return new (p) T{std::forward<A>(args)...}; }
+        auto k = node_alloc.size() - 1;
+        try         { return make_node<T>(p, k, std::forward<A>(args)...); }
         catch (...) { node_alloc.rollback(p); throw; }
     }
 
+    // stev: 'make_node' constructs a node in the memory
+    // obtained beforehand from 'node_alloc' -- the slot of
+    // index 'k'; this allows one to reserve the slot of a
+    // node prior to creating its children; upon failure,
+    // the slot is left as it was -- not constructed --,
+    // for the caller to release
+    template<typename T, typename... A>
+    const T* make_node(void* p, size_t k, A&&... args)
+    {
+        SYS_ASSERT(k < node_alloc.size() && node_alloc[k] == p);
+        SYS_ASSERT(k <= std::numeric_limits<unsigned>::max());
+        fingerprint_t f;
+        if (use_prints)
+            f = fingerprint_of<T>(args...);
+        auto r = new (p) T{std::forward<A>(args)...};
+        r->n = k;
+        try {
+            if (use_prints)
+                set_fingerprint(r, f);
+            type_entry<T>(r->type()).nodes.push_back(r);
+        }
+        catch (...) {
+            r->~T();
+            throw;
+        }
+        return r;
+    }
+
+    // stev: release the nodes allocated last, down to and
+    // including 'slot', in LIFO order; the slots in 'pending'
+    // -- in allocation order -- were reserved by 'node_alloc'
+    // but never constructed, thus are not to be destroyed
+    void release(const void* slot, std::vector<void*>& pending);
+
+    // stev: exchange the nodes of the two ASTs; the
+    // hash-consing tables are not part of the deal
+    void swap(BaseAST& ast) noexcept
+    {
+        node_alloc.swap(ast.node_alloc);
+        raw_alloc.swap(ast.raw_alloc);
+        std::swap(root, ast.root);
+        types.swap(ast.types);
+        std::swap(use_prints, ast.use_prints);
+        prints.swap(ast.prints);
+    }
+
+    bool owns(const root_t* node) const
+    { return node_alloc.find(node); }
+
+    // stev: release all nodes, keeping the memory of the pools
+    // and of the type index for reuse; the hash-consing and the
+    // fingerprints settings remain as they were
+    void clear() noexcept
+    {
+        node_alloc.clear();
+        raw_alloc.clear();
+        root = nullptr;
+        for (auto& t : types)
+            t.nodes.clear();
+        prints.clear();
+        if (cons != nullptr)
+            cons->reset();
+    }
+
+    template<typename D>
+    class copier_t;
+
+    template<typename T, typename... A>
+    fingerprint_t fingerprint_of(const A&... args) const
+    {
+        fingerprint_t f;
+        f.add(typeid(T).name());
+        using expand_t = int[];
+        (void) expand_t{0, (add_fingerprint(f, args), 0)...};
+        return f;
+    }
+
+    void add_fingerprint(fingerprint_t& f, const char* arg) const
+    { f.add('s'); f.add(arg); }
+
+    void add_fingerprint(fingerprint_t& f, const str_t& arg) const
+    { f.add('s'); f.add(arg.ptr, arg.len); }
+
+    template<typename T>
+    void add_fingerprint(fingerprint_t& f, const T* arg) const
+    {
+        fingerprint_t g;
+        f.add('n');
+        if (arg) fingerprint(arg, g);
+        f.add(g);
+    }
+
+    template<typename T>
+    void add_fingerprint(fingerprint_t& f,
+        const std::pair<size_t, T const* const*>& arg) const
+    {
+        f.add('l');
+        f.add(arg.first);
+        auto ptr = arg.second;
+        auto end = ptr + arg.first;
+        for (; ptr != end; ++ ptr)
+            add_fingerprint(f, *ptr);
+    }
+
+    template<typename T>
+    typename std::enable_if<
+        std::is_arithmetic<T>::value ||
+        std::is_enum<T>::value>::type
+    add_fingerprint(fingerprint_t& f, const T& arg) const
+    { f.add('v'); f.add(static_cast<uint64_t>(arg)); }
+
+    void set_fingerprint(const root_t* node, const fingerprint_t& f);
+
+    typedef std::vector<const root_t*> type_index_t;
+
+    // stev: the entries of 'types' are indexed by the node type
+    // enum -- as returned by 'type()' --, thus an allocation costs
+    // no lookup; 'type' and 'size' are set by the first allocation
+    // of a node of that type, for 'find_type' and 'mem_stats'
+    struct type_entry_t
+    {
+        type_entry_t() : type(nullptr), size(0) {}
+
+        const std::type_info* type;
+        size_t                size;
+        type_index_t          nodes;
+    };
+
+    template<typename T>
+    type_entry_t& type_entry(size_t k)
+    {
+        if (k >= types.size())
+            types.resize(k + 1);
+        auto& t = types[k];
+        if (t.type == nullptr) {
+            t.type = &typeid(T);
+            t.size = sizeof(T);
+        }
+        return t;
+    }
+
+    // stev: the query functions are not on the allocation path;
+    // they scan the few entries of 'types' for the one of 'T'
+    template<typename T>
+    const type_index_t* find_type() const
+    {
+        for (const auto& t : types) {
+            if (t.type != nullptr && *t.type == typeid(T))
+                return &t.nodes;
+        }
+        return nullptr;
+    }
+
     friend struct Arg<root_t, const char*>;
+    friend struct Arg<root_t, str_t>;
     friend struct Arg<root_t, const root_t*>;
 
     class node_iterator;
@@ -246,8 +779,89 @@ protected:
     PoolAllocator node_alloc;
     PoolAllocator raw_alloc;
     const root_t *root;
+
+    std::unique_ptr<ConsTable> cons;
+
+    std::vector<type_entry_t> types;
+
+    // stev: 'prints[k]' is the fingerprint of the node
+    // of index 'k' in 'node_alloc', i.e. in allocation
+    // order; the vector is parallel to the node pool
+    bool                       use_prints;
+    std::vector<fingerprint_t> prints;
 };
 
+// stev: the fingerprint of a node is found at the index of
+// the node in 'prints', with no lookup of 'node' in the pool;
+// 'node' is checked to be of this AST by the slot of that index
+
+template <typename R>
+bool BaseAST<R>::fingerprint(const root_t* node, fingerprint_t& res) const
+{
+    size_t k = node->n;
+    if (k >= prints.size() || node_alloc[k] != node)
+        return false;
+    res = prints[k];
+    return true;
+}
+
+template <typename R>
+void BaseAST<R>::set_fingerprint(const root_t* node, const fingerprint_t& f)
+{
+    // stev: 'prints' grows along with the node pool
+    auto n = node_alloc.size();
+    if (prints.size() < n)
+        prints.resize(n);
+    prints[node->n] = f;
+}
+
+template <typename R>
+void BaseAST<R>::release(const void* slot, std::vector<void*>& pending)
+{
+    void* p;
+    do {
+        p = node_alloc.last();
+        SYS_ASSERT(p != nullptr);
+        if (!pending.empty() && pending.back() == p)
+            pending.pop_back();
+        else {
+            auto n = static_cast<const root_t*>(p);
+            auto& v = types[n->type()].nodes;
+            v.erase(std::find(v.begin(), v.end(), n));
+            node_destr(p);
+        }
+        node_alloc.rollback(p);
+    }
+    while (p != slot);
+    if (prints.size() > node_alloc.size())
+        prints.resize(node_alloc.size());
+}
+
+template <typename R>
+mem_stats_t BaseAST<R>::mem_stats() const
+{
+    mem_stats_t r;
+    r.node.name = node_alloc.pool_name();
+    r.node.stats = node_alloc.stats();
+    r.raw.name = raw_alloc.pool_name();
+    r.raw.stats = raw_alloc.stats();
+    for (const auto& e : types) {
+        if (e.nodes.empty())
+            continue;
+        r.types.push_back(mem_stats_t::type_t{
+            e.nodes.front()->name(),
+            e.nodes.size(),
+            e.nodes.size() * e.size});
+    }
+    std::sort(r.types.begin(), r.types.end(),
+        [](const mem_stats_t::type_t& a, const mem_stats_t::type_t& b)
+        { return strcmp(a.name, b.name) < 0; });
+    return r;
+}
+
+inline std::ostream& operator<<(std::ostream& ost, const ConsTable::stats_t& obj)
+{ obj.print(ost); return ost; }
+
 typedef Ext::widest_uint_t result_t;
 
 template<typename T>
@@ -321,6 +935,69 @@ template <typename R>
 inline typename BaseAST<R>::node_iterator BaseAST<R>::node_end() const
 { return node_iterator(node_alloc.end()); }
 
+template <typename R>
+template<typename T>
+class BaseAST<R>::type_iterator :
+    public std::iterator<std::forward_iterator_tag, const T>
+{
+public:
+    type_iterator& operator++()
+    { ptr ++; return *this; };
+    type_iterator operator++(int)
+    { auto r = *this; ptr ++; return r; }
+
+    const T* operator*() const
+    { return static_cast<const T*>(*ptr); }
+    const T* operator->() const
+    { return static_cast<const T*>(*ptr); }
+
+    bool operator==(const type_iterator& v) const
+    { return ptr == v.ptr; }
+    bool operator!=(const type_iterator& v) const
+    { return ptr != v.ptr; }
+
+private:
+    typedef const root_t* const* ptr_t;
+
+    type_iterator(ptr_t _ptr) : ptr(_ptr) {}
+    friend class type_range_t<T>;
+
+    ptr_t ptr;
+};
+
+template <typename R>
+template<typename T>
+class BaseAST<R>::type_range_t
+{
+public:
+    typedef type_iterator<T> iterator;
+
+    iterator begin() const
+    { return iterator(ptr); }
+    iterator end() const
+    { return iterator(ptr + sz); }
+
+    size_t size() const
+    { return sz; }
+    bool empty() const
+    { return sz == 0; }
+
+private:
+    type_range_t(const type_index_t* index) :
+        ptr(index ? index->data() : nullptr),
+        sz(index ? index->size() : 0)
+    {}
+    friend class BaseAST<R>;
+
+    const root_t* const* ptr;
+    size_t sz;
+};
+
+template <typename R>
+template<typename T>
+inline typename BaseAST<R>::template type_range_t<T> BaseAST<R>::nodes_of() const
+{ return type_range_t<T>(find_type<T>()); }
+
 template <typename R>
 template<typename Op>
 class BaseAST<R>::op_node_iterator :
@@ -361,39 +1038,6 @@ protected:
     node_iterator end;
 };
 
-struct hash_t : Ext::unary_func_t<size_t, const char*>
-{
-    size_t operator()(const char* key) const // hash pjw
-    {
-        unsigned r = 0, t;
-        for (const char* p = key; *p; p ++) {
-            r = (r << 4) + *p;
-            t = r & 0xf0000000;
-            if (t) {
-                r ^= t >> 24;
-                r ^= t;
-            }
-        }
-        return r;
-    }
-};
-
-struct eq_t : Ext::binary_func_t<bool, const char*>
-{
-    bool operator()(const char* key1, const char* key2) const
-    {
-        return strcmp(key1, key2) == 0;
-    }
-};
-
-struct cmp_t : Ext::binary_func_t<int, const char*>
-{
-    bool operator()(const char* key1, const char* key2) const
-    {
-        return strcmp(key1, key2) < 0;
-    }
-};
-
 template <typename T>
 class map_t :
     protected std::unordered_map<const char*, T, hash_t, eq_t>
@@ -439,6 +1083,179 @@ typename map_t<T>::result_t map_t<T>::set(key_t key, val_t val)
     return std::make_pair((r.first)->second, r.second);
 }
 
+// stev: 'copier_t' copies the nodes reachable from a given node into
+// the AST 'ast'; the derived class 'D' is the visitor that copies each
+// type of node by the means of 'reserve', 'copy' and 'make'; the nodes,
+// strings and lists shared in the source get copied only once, thus
+// remain shared; when 'ast' is null, nothing gets copied, but the
+// extent of the pools needed for a copy is computed instead
+
+template <typename R>
+template<typename D>
+class BaseAST<R>::copier_t
+{
+public:
+    copier_t(BaseAST* _ast) :
+        ast(_ast),
+        res(nullptr)
+    {}
+
+    // stev: a copy that failed midway leaves behind reserved
+    // slots; these and the nodes allocated after the first of
+    // them are released, such that the target AST holds only
+    // nodes fully constructed
+    ~copier_t()
+    {
+        if (!pending.empty())
+            ast->release(pending.front(), pending);
+    }
+
+    template<typename T>
+    const T* copy(const T* node);
+
+    const extent_t& extent() const
+    { return ext; }
+
+protected:
+    // stev: a slot reserved in the node pool: its
+    // address and its index in the pool
+    struct slot_t
+    {
+        void*  ptr;
+        size_t idx;
+    };
+
+    // stev: note that 'PoolAllocator::allocate' pads
+    // each object allocated with at most its alignment
+    template<typename T>
+    slot_t reserve()
+    {
+        if (ast != nullptr) {
+            pending.reserve(pending.size() + 1);
+            auto p = ast->node_alloc.template allocate<T>();
+            pending.push_back(p);
+            return slot_t{p, ast->node_alloc.size() - 1};
+        }
+        ext.node_nobjs ++;
+        ext.node_pool_sz += sizeof(T) + alignof(T);
+        return slot_t{nullptr, 0};
+    }
+
+    // stev: the children of a node are made before the node
+    // itself, thus the slots get constructed in LIFO order
+    template<typename T, typename... A>
+    void make(const slot_t& slot, const root_t* node, A&&... args)
+    {
+        if (ast == nullptr) {
+            res = node;
+            return;
+        }
+        SYS_ASSERT(!pending.empty() && pending.back() == slot.ptr);
+        res = ast->template make_node<T>(
+            slot.ptr, slot.idx, std::forward<A>(args)...);
+        res->tag(node->tag());
+        pending.pop_back();
+    }
+
+    str_t copy(const str_t& str);
+
+    const char* copy(const char* str)
+    { return str ? copy(str_t(str)).ptr : nullptr; }
+
+    template<typename T>
+    std::pair<size_t, T const* const*> copy(
+        const std::pair<size_t, T const* const*>& list);
+
+private:
+    typedef std::unordered_map<const void*, const void*> ptr_map_t;
+
+    BaseAST*           ast;
+    const root_t*      res;
+    extent_t           ext;
+    std::vector<void*> pending;
+    ptr_map_t          nodes;
+    ptr_map_t     strs;
+    ptr_map_t     lists;
+};
+
+template <typename R>
+template<typename D>
+template<typename T>
+const T* BaseAST<R>::copier_t<D>::copy(const T* node)
+{
+    if (node == nullptr)
+        return nullptr;
+    // stev: the references to the elements of an unordered
+    // map are not invalidated by the insertions that follow
+    auto r = nodes.emplace(node, nullptr);
+    auto& v = r.first->second;
+    if (r.second) {
+        node->accept(static_cast<D*>(this));
+        v = res;
+    }
+    return static_cast<const T*>(
+        static_cast<const root_t*>(v));
+}
+
+template <typename R>
+template<typename D>
+str_t BaseAST<R>::copier_t<D>::copy(const str_t& str)
+{
+    auto r = strs.emplace(str.ptr, str.ptr);
+    auto n = str.len + 1;
+    if (r.second && ast == nullptr) {
+        ext.raw_nobjs ++;
+        ext.raw_pool_sz += n + alignof(char);
+    }
+    else
+    if (r.second) {
+        auto p = static_cast<char*>(
+            ast->raw_alloc.template allocate<char>(n));
+        memcpy(p, str.ptr, n);
+        r.first->second = p;
+    }
+    return str_t(static_cast<const char*>(r.first->second), str.len);
+}
+
+template <typename R>
+template<typename D>
+template<typename T>
+std::pair<size_t, T const* const*> BaseAST<R>::copier_t<D>::copy(
+    const std::pair<size_t, T const* const*>& list)
+{
+    typedef std::pair<size_t, T const* const*> list_t;
+
+    if (list.first == 0)
+        return list_t(0, nullptr);
+
+    auto r = lists.emplace(list.second, list.second);
+    if (!r.second)
+        return list_t(list.first, static_cast<T const* const*>(
+            r.first->second));
+
+    T const** p = nullptr;
+    if (ast == nullptr) {
+        ext.raw_nobjs ++;
+        ext.raw_pool_sz += sizeof(T const*) * list.first +
+            alignof(T const*);
+    }
+    else {
+        p = static_cast<T const**>(
+            ast->raw_alloc.template allocate<T const*>(list.first));
+        r.first->second = p;
+    }
+
+    auto ptr = list.second;
+    auto end = ptr + list.first;
+    for (auto q = p; ptr != end; ++ ptr) {
+        auto n = copy(*ptr);
+        if (q != nullptr)
+            *q ++ = n;
+    }
+
+    return list_t(list.first, p ? p : list.second);
+}
+
 } // namespace AST
 
 #endif/*__AST_BASE_HPP*/
@@ -140,24 +140,34 @@ protected:
         lexeme_t& operator=(lexeme_t&&) = delete;
 
         lexeme_t(const char* v) :
-            base_t(64)
-        { base_t::assign(v); }
+            base_t(64),
+            len(strlen(v))
+        { base_t::nassign(v, len); }
         lexeme_t() :
             lexeme_t("")
         {}
 
         lexeme_t& operator=(const char* v)
-        { base_t::assign(v); return *this; }
+        { len = strlen(v); base_t::nassign(v, len); return *this; }
         lexeme_t& operator=(const range_t& v)
-        { base_t::nassign(v.beg, v.size()); return *this; }
+        { len = v.size(); base_t::nassign(v.beg, len); return *this; }
         lexeme_t& operator=(char v)
-        { base_t::nassign(&v, 1); return *this; }
+        { len = 1; base_t::nassign(&v, 1); return *this; }
 
         const char* get() const
         { return base_t::get(); }
 
+        size_t size() const
+        { return len; }
+
+        range_t range() const
+        { return range_t(get(), get() + len); }
+
         operator const char*() const
         { return base_t::get(); }
+
+    private:
+        size_t len;
     };
 
     struct token_t
@@ -183,11 +193,11 @@ protected:
         {}
 
         token_t(const token_t& tok) :
-            token_t(tok.pos, tok.type, tok.lex.get())
-        {}
+            token_t(tok.pos, tok.type, "")
+        { lex = tok.lex.range(); }
 
         token_t& operator=(const token_t& tok)
-        { pos = tok.pos; type = tok.type; lex = tok.lex.get(); return *this; }
+        { pos = tok.pos; type = tok.type; lex = tok.lex.range(); return *this; }
 
         bool operator==(type_t _type)
         { return type == _type; }
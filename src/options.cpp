@@ -25,6 +25,7 @@
 #include <exception>
 #include <algorithm>
 #include <iterator>
+#include <mutex>
 
 #include "std-ext.hpp"
 #include "options.hpp"
@@ -44,7 +45,9 @@ options_t::options_t() :
     argc           (0),
     argv           (nullptr),
     ext_argc       (0),
-    ext_argv       (nullptr)
+    ext_argv       (nullptr),
+    out            (&std::cout),
+    err            (&std::cerr)
 {}
 
 options_t::~options_t()
@@ -148,7 +151,7 @@ void options_t::dump() const
 
 const options_t* options_t::options(size_t argc, char* const argv[])
 {
-    static options_t opts;
+    static thread_local options_t opts;
     opts.parse(argc, argv);
     return &opts;
 }
@@ -237,6 +240,8 @@ void options_t::parse(const options_t* parent)
 {
     parse(parent->ext_argc, parent->ext_argv);
     home_dir = parent->home_dir;
+    out = parent->out;
+    err = parent->err;
 #ifdef DEBUG
     debug |= parent->debug_ext_func;
 #endif
@@ -270,7 +275,16 @@ void options_t::parse(size_t argc, char* const argv[])
         .version = false,
     };
 
-    home_dir = argc > 0 && argv[0] ? dirname(argv[0]) : nullptr;
+    // stev: the state of 'getopt_long' is of process scope:
+    // the parses of concurrent threads get serialized
+    static std::mutex mutex;
+    std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+
+    // stev: 'dirname' modifies its argument, thus it gets a copy
+    // of 'argv[0]': that may be the 'ext_func_name' of the parent
+    // options, which is to be loaded again by the next inputs
+    home_buf = argc > 0 && argv[0] ? argv[0] : "";
+    home_dir = argc > 0 && argv[0] ? dirname(&home_buf[0]) : nullptr;
 
     // stev: when given no options
     // (thus when 'argv == nullptr')
@@ -292,8 +306,13 @@ void options_t::parse(size_t argc, char* const argv[])
         }
     }
 
+    // stev: 'optind = 0' makes GNU 'getopt_long' reinitialize
+    // itself: otherwise its internal state may refer into the
+    // argument vector of a previous parse -- e.g. of a request
+    // of 'tree --serve' -- which meanwhile got released
     opt_t opt;
-    optind = 1;
+    lock.lock();
+    optind = 0;
     opterr = 0;
     while ((opt = getopt_long(
         argc, argv, &short_opts[0], &long_opts[0], nullptr)) != EOF) {
@@ -355,6 +374,7 @@ void options_t::parse(size_t argc, char* const argv[])
 
     argv += optind;
     argc -= optind;
+    lock.unlock();
 
 parse_done:
     this->argc = argc;
@@ -387,7 +407,7 @@ input_options_t::input_options_t() :
 
 const input_options_t* input_options_t::options(size_t argc, char* const argv[])
 {
-    static input_options_t opts;
+    static thread_local input_options_t opts;
     opts.parse(argc, argv);
     return &opts;
 }
@@ -25,7 +25,9 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#ifndef STATIC_EXT_FUNCS
 #include <dlfcn.h>
+#endif
 
 #include <iostream>
 
@@ -203,9 +205,12 @@ static void __attribute__ ((constructor)) init()
 
 #endif // SYS_OPTS
 
+// stev: the buffer is of thread scope: the result is
+// valid until the next call of the same thread
+
 const char* svformat(const char *fmt, va_list args) noexcept
 {
-    static char buf[256];
+    static thread_local char buf[256];
 
     vsnprintf(buf, sizeof buf - 1, fmt, args);
     buf[255] = 0;
@@ -438,6 +443,44 @@ private:
     using mem_t::get;
 };
 
+#ifdef STATIC_EXT_FUNCS
+// stev: the module of 'file' -- which is 'len' chars long sans the
+// '.so' suffix -- is the longest of the modules of 'static_ext_funcs'
+// with which 'file' ends at a '/' boundary; e.g. 'abc/printer' for
+// 'abc/printer.so' and 'printer' for './printer.so'
+
+static const char* find_static_ext_mod(const char* file, size_t len)
+{
+    const char* res = nullptr;
+    size_t n = 0;
+    auto ptr = static_ext_funcs;
+    auto end = ptr + n_static_ext_funcs;
+    for (; ptr < end; ptr ++) {
+        auto m = strlen(ptr->mod);
+        if (m > n && m <= len &&
+            !memcmp(file + len - m, ptr->mod, m) &&
+            (m == len || file[len - m - 1] == '/')) {
+            res = ptr->mod;
+            n = m;
+        }
+    }
+    return res;
+}
+
+static const static_ext_func_t* find_static_ext_func(
+    const char* mod, const char* func)
+{
+    auto ptr = static_ext_funcs;
+    auto end = ptr + n_static_ext_funcs;
+    for (; ptr < end; ptr ++) {
+        if (!strcmp(ptr->mod, mod) &&
+            !strcmp(ptr->func, func))
+            return ptr;
+    }
+    return nullptr;
+}
+#endif
+
 void base_ext_func_t::load(
     const char* home_dir,
     const char* name,
@@ -488,9 +531,15 @@ void base_ext_func_t::load(
             << sformat("%s: %s: file: '%s'", program, ext_func, file)
             << std::endl;
 #endif
+#ifndef STATIC_EXT_FUNCS
     handle = dlopen(file, RTLD_NOW);
     if (handle == nullptr)
         error("failed loading module '%s': %s", mod, dlerror());
+#else
+    auto name_mod = find_static_ext_mod(file, Ext::ptr_diff(ptr, file));
+    if (name_mod == nullptr)
+        error("failed loading module '%s': not linked in", mod);
+#endif
     if (func == nullptr) {
         func = strrchr(mod, '/');
         if (func)
@@ -499,24 +548,71 @@ void base_ext_func_t::load(
             func = mod;
         *ptr = 0;
     }
-    dlerror();
 #ifdef DEBUG
     if (debug)
         std::cerr
             << sformat("%s: %s: func: '%s'", program, ext_func, func)
             << std::endl;
 #endif
+#ifndef STATIC_EXT_FUNCS
+    dlerror();
     mod_func = dlsym(handle, func);
     const char *err = dlerror();
     if (err)
         error("cannot find func '%s': %s", func, err);
+#else
+    auto ent = find_static_ext_func(name_mod, func);
+    if (ent == nullptr)
+        error("cannot find func '%s': not linked in", func);
+    handle = const_cast<static_ext_func_t*>(ent);
+    mod_func = ent->ptr;
+#endif
+}
+
+std::string file_stamp(const char* file)
+{
+    struct stat st;
+    if (stat(file, &st) < 0)
+        return std::string();
+    return format("%ju:%ju:%jd:%jd.%09ld",
+        uintmax_t(st.st_dev),
+        uintmax_t(st.st_ino),
+        intmax_t(st.st_size),
+        intmax_t(st.st_mtim.tv_sec),
+        long(st.st_mtim.tv_nsec));
+}
+
+std::string base_ext_func_t::stamp() const
+{
+#ifndef STATIC_EXT_FUNCS
+    Dl_info info;
+    if (mod_func == nullptr ||
+        dladdr(mod_func, &info) == 0 ||
+        info.dli_fname == nullptr)
+        return std::string();
+    auto file = file_stamp(info.dli_fname);
+    if (file.empty())
+        return file;
+    return std::string(info.dli_fname)
+#else
+    // stev: the module is identified by its name and
+    // by the identity of the file of the program
+    auto ent = static_cast<const static_ext_func_t*>(handle);
+    auto file = file_stamp("/proc/self/exe");
+    if (ent == nullptr || file.empty())
+        return std::string();
+    return std::string(ent->mod).append("::").append(ent->func)
+#endif
+        .append(":").append(file);
 }
 
 void base_ext_func_t::unload()
 {
     if (handle) {
+#ifndef STATIC_EXT_FUNCS
         if (dlclose(handle))
             error("error unloading module: %s", dlerror());
+#endif
         handle = nullptr;
     }
     mod_func = nullptr;
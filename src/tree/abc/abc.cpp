@@ -49,7 +49,7 @@ bool cptr_def_t<bool>::cast(const char* arg)
     return arg[0] == '1';
 }
 
-ast_type_t const* const ast_type_t::types[] = {
+static ast_type_t const* const ast_types[] = {
 // > AST_TYPE_CALLS $ grammar -NAC
     ast_type<AST::Node>(),
     ast_type<AST::A>(),
@@ -66,8 +66,6 @@ ast_type_t const* const ast_type_t::types[] = {
 // < AST_TYPE_CALLS
 };
 
-const size_t ast_type_t::n_types = Ext::array_size(ast_type_t::types);
-
 // > AST_TYPE_DEFS $ grammar2 -AD
 //
 // ast-type: Node
@@ -247,7 +245,39 @@ template<>
 const size_t ast_def_t<AST::S>::narg = 1;
 // < AST_TYPE_DEFS
 
-const TypeMaker::new_funcs_t TypeMaker::new_funcs[] = {
+// stev: the type name table below is produced by 'tree-phash' out
+// of the names of 'new_funcs' -- taken in their order -- as follows:
+//   $ ./tree-phash $(sed -n '/> AST_TYPEMAKER_NEW_FUNCS/,/< AST_TYPEMAKER_NEW_FUNCS/s/^ *new_funcs_t("\([^"]*\)".*/\1/p' abc/abc.cpp)
+// 'check_type_names' below verifies the tables at compile-time, thus any
+// change of the types of the AST must be followed by rerunning 'tree-phash'
+static constexpr const char* type_names[] = {
+    "A",
+    "B",
+    "C",
+    "D",
+    "L",
+    "M",
+    "N",
+    "Node",
+    "P",
+    "Q",
+    "R",
+    "S",
+    ""
+};
+
+static constexpr type_names_t::slot_t type_slots[] = {
+     9, 12, 10, 12,  7,  5,  8, 12,  6,  2,  3,  4, 11,  0, 12,  1
+};
+
+static constexpr uint32_t type_seed = 99;
+
+static constexpr type_names_t type_names_hash(
+    type_names, type_slots, type_seed);
+
+constexpr type_names_t TypeMaker::type_names = type_names_hash;
+
+constexpr TypeMaker::new_funcs_t TypeMaker::new_funcs[] = {
 // > AST_TYPEMAKER_NEW_FUNCS $ grammar -NAT=4
     new_funcs_t("A",    &TypeMaker::new_node<AST::A>,    &TypeMaker::new_list<AST::A>),
     new_funcs_t("B",    &TypeMaker::new_node<AST::B>,    &TypeMaker::new_list<AST::B>),
@@ -266,10 +296,12 @@ const TypeMaker::new_funcs_t TypeMaker::new_funcs[] = {
 
 const size_t TypeMaker::n_new_func = Ext::array_size(TypeMaker::new_funcs);
 
+CXX_ASSERT(TypeMaker::check_type_names());
+
 // > AST_TYPE_NODE_MAKERS $ grammar2 -AM
 template<>
 obj_value_t NodeMaker::new_node<AST::Node>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::Node>(node, args);
     return node_obj_value(type, ast->new_node());
@@ -277,7 +309,7 @@ obj_value_t NodeMaker::new_node<AST::Node>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::A>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::A>(node, args);
     return node_obj_value(type, ast->new_a());
@@ -285,7 +317,7 @@ obj_value_t NodeMaker::new_node<AST::A>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::B>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::B>(node, args);
     return node_obj_value(type, ast->new_b(
@@ -294,7 +326,7 @@ obj_value_t NodeMaker::new_node<AST::B>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::C>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::C>(node, args);
     return node_obj_value(type, ast->new_c(
@@ -303,7 +335,7 @@ obj_value_t NodeMaker::new_node<AST::C>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::D>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::D>(node, args);
     return node_obj_value(type, ast->new_d(
@@ -312,7 +344,7 @@ obj_value_t NodeMaker::new_node<AST::D>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::N>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::N>(node, args);
     return node_obj_value(type, ast->new_n(
@@ -323,7 +355,7 @@ obj_value_t NodeMaker::new_node<AST::N>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::M>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::M>(node, args);
     return node_obj_value(type, ast->new_m(
@@ -334,7 +366,7 @@ obj_value_t NodeMaker::new_node<AST::M>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::P>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::P>(node, args);
     return node_obj_value(type, ast->new_p(
@@ -344,7 +376,7 @@ obj_value_t NodeMaker::new_node<AST::P>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::Q>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::Q>(node, args);
     return node_obj_value(type, ast->new_q());
@@ -352,7 +384,7 @@ obj_value_t NodeMaker::new_node<AST::Q>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::R>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::R>(node, args);
     return node_obj_value(type, ast->new_r());
@@ -360,7 +392,7 @@ obj_value_t NodeMaker::new_node<AST::R>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::L>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::L>(node, args);
     return node_obj_value(type, ast->new_l(
@@ -369,7 +401,7 @@ obj_value_t NodeMaker::new_node<AST::L>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::S>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::S>(node, args);
     return node_obj_value(type, ast->new_s(
@@ -377,7 +409,9 @@ obj_value_t NodeMaker::new_node<AST::S>(
 }
 // < AST_TYPE_NODE_MAKERS
 
-const NodeMaker::new_funcs_t NodeMaker::new_funcs[] = {
+constexpr type_names_t NodeMaker::type_names = type_names_hash;
+
+constexpr NodeMaker::new_funcs_t NodeMaker::new_funcs[] = {
 // > AST_NODEMAKER_NEW_FUNCS $ grammar -NAN=4
     new_funcs_t("A",    &NodeMaker::new_node<AST::A>,    &NodeMaker::new_list<AST::A>),
     new_funcs_t("B",    &NodeMaker::new_node<AST::B>,    &NodeMaker::new_list<AST::B>),
@@ -396,13 +430,21 @@ const NodeMaker::new_funcs_t NodeMaker::new_funcs[] = {
 
 const size_t NodeMaker::n_new_func = Ext::array_size(NodeMaker::new_funcs);
 
+CXX_ASSERT(NodeMaker::check_type_names());
+
 } // namespace Obj
 
 EXT_FUNC_ENTRY
 Sys::ext_func_result_t abc(
     const TreeAST::AST* ast, const Tree::options_t* opts)
 {
-    return ext_func_entry(ast, opts);
+    return ext_func_entry(ast, opts, Obj::ast_types);
+}
+
+EXT_FUNC_ENTRY
+tree_session_t* abc_session_new(unsigned flags)
+{
+    return api_session_new(flags, Obj::ast_types);
 }
 
 
@@ -60,6 +60,20 @@ AST::AST(
         base_t::node_destr)
 {}
 
+AST::AST(
+#ifdef DEBUG
+    bool _debug,
+#endif
+    const extent_t& ext
+) :
+    base_t(
+#ifdef DEBUG
+        _debug,
+#endif
+        ext,
+        base_t::node_destr)
+{}
+
 AST::~AST()
 {}
 
@@ -107,6 +121,138 @@ void AST::root_node(const Node* node)
     root = node;
 }
 
+class AST::Copier :
+    private Visitor,
+    public  base_t::copier_t<Copier>
+{
+public:
+    typedef base_t::copier_t<Copier> copier_t;
+
+    Copier(AST* _ast) :
+        copier_t(_ast)
+    {}
+
+private:
+    friend class base_t::copier_t<Copier>;
+
+// > COPIER_VISITOR_DECL $ grammar -VD
+    void visit(const A*);
+    void visit(const B*);
+    void visit(const C*);
+    void visit(const D*);
+    void visit(const N*);
+    void visit(const M*);
+    void visit(const P*);
+    void visit(const Q*);
+    void visit(const R*);
+    void visit(const L*);
+    void visit(const S*);
+// < COPIER_VISITOR_DECL
+};
+
+// > COPIER_VISITOR_IMPL $ grammar -VI=AST::Copier
+void AST::Copier::visit(const A* arg)
+{
+    auto ptr = reserve<A>();
+    make<A>(ptr, arg);
+}
+
+void AST::Copier::visit(const B* arg)
+{
+    auto ptr = reserve<B>();
+    auto a = copy(arg->a);
+    make<B>(ptr, arg, a);
+}
+
+void AST::Copier::visit(const C* arg)
+{
+    auto ptr = reserve<C>();
+    auto b = copy(arg->b);
+    make<C>(ptr, arg, b);
+}
+
+void AST::Copier::visit(const D* arg)
+{
+    auto ptr = reserve<D>();
+    auto c = copy(arg->c);
+    make<D>(ptr, arg, c);
+}
+
+void AST::Copier::visit(const N* arg)
+{
+    auto ptr = reserve<N>();
+    auto x = copy(arg->x);
+    auto y = copy(arg->y);
+    auto z = copy(arg->z);
+    make<N>(ptr, arg, x, y, z);
+}
+
+void AST::Copier::visit(const M* arg)
+{
+    auto ptr = reserve<M>();
+    auto a = copy(arg->a);
+    auto b = copy(arg->b);
+    auto c = copy(arg->c);
+    make<M>(ptr, arg, a, b, c);
+}
+
+void AST::Copier::visit(const P* arg)
+{
+    auto ptr = reserve<P>();
+    auto x = copy(arg->x);
+    auto y = copy(arg->y);
+    make<P>(ptr, arg, x, y);
+}
+
+void AST::Copier::visit(const Q* arg)
+{
+    auto ptr = reserve<Q>();
+    make<Q>(ptr, arg);
+}
+
+void AST::Copier::visit(const R* arg)
+{
+    auto ptr = reserve<R>();
+    make<R>(ptr, arg);
+}
+
+void AST::Copier::visit(const L* arg)
+{
+    auto ptr = reserve<L>();
+    auto q = copy(arg->q);
+    make<L>(ptr, arg, q);
+}
+
+void AST::Copier::visit(const S* arg)
+{
+    auto ptr = reserve<S>();
+    make<S>(ptr, arg, arg->b);
+}
+// < COPIER_VISITOR_IMPL
+
+std::unique_ptr<AST> AST::extract(const Node* node) const
+{
+    if (!owns(node))
+        error("invalid node pointer '%p'", node);
+
+    // stev: a first walk over the subgraph computes
+    // the extent of the pools of the new AST and the
+    // second one does the actual copying of the nodes
+    Copier ext(nullptr);
+    ext.copy(node);
+
+    std::unique_ptr<AST> ast(new AST(
+#ifdef DEBUG
+        false,
+#endif
+        ext.extent()));
+    ast->fingerprints(fingerprints());
+    Copier copier(ast.get());
+    ast->root = copier.copy(node);
+
+    return ast;
+}
+
 // > AST_NEW_NODE_IMPL $ grammar -NNI
 const Node* AST::new_node()
 {
@@ -25,6 +25,7 @@
 #include <iterator>
 #include <algorithm>
 #include <list>
+#include <memory>
 #include <stdexcept>
 #include <utility>
 
@@ -89,7 +90,7 @@ public:
 
     private:
         friend class base_enum_t<node_t>;
-        static const char* names[12];
+        EXT_VISIBLE static const char* names[12];
     };
 
     AST(const AST&) = delete;
@@ -108,8 +109,39 @@ public:
     const Node* root_node() const { return root; }
     void root_node(const Node*);
 
+    // stev: copy the nodes reachable from 'node' into a new
+    // AST having its pools sized to fit, and of which root is
+    // the copy of 'node'; the new AST does not depend on this
+    // one, which thus can be released right away
+    std::unique_ptr<AST> extract(const Node* node) const;
+
     size_t num_node() const { return base_t::num_node(); }
 
+    // stev: release all nodes, keeping the pools for reuse
+    void clear() { base_t::clear(); }
+
+    bool hash_cons() const { return base_t::hash_cons(); }
+    void hash_cons(bool enable) { base_t::hash_cons(enable); }
+
+    ConsTable::stats_t cons_stats() const { return base_t::cons_stats(); }
+
+    mem_stats_t mem_stats() const { return base_t::mem_stats(); }
+
+    bool fingerprints() const { return base_t::fingerprints(); }
+    void fingerprints(bool enable) { base_t::fingerprints(enable); }
+
+    bool fingerprint(const Node* node, fingerprint_t& res) const
+    { return base_t::fingerprint(node, res); }
+
+    template<typename T>
+    using type_range_t = base_t::type_range_t<T>;
+
+    template<typename T>
+    type_range_t<T> nodes_of() const { return base_t::nodes_of<T>(); }
+
+    template<typename T>
+    size_t count() const { return base_t::count<T>(); }
+
 // > AST_NEW_NODE_DECL $ grammar -NND
     const Node* new_node();
     const A* new_a();
@@ -147,6 +179,16 @@ public:
 private:
     using base_t::new_node;
 
+    typedef base_t::extent_t extent_t;
+
+    AST(
+#ifdef DEBUG
+        bool _debug,
+#endif
+        const extent_t& ext);
+
+    class Copier;
+
     template<typename T>
     typename Arg<root_t, T>::result_t alloc_arg(T arg)
     {
@@ -195,6 +237,10 @@ public:
 private:
     friend class BaseAST<Node>;
 
+    // stev: the index of the node in the node pool of its AST;
+    // it precedes 't' such that the derived classes may still
+    // lay out their first small members in the tail padding
+    unsigned n;
     mutable unsigned short t;
 };
 
@@ -588,7 +634,7 @@ inline T EvalVisitor<T>::eval(const Node* node)
     return cast_t::cast(node->accept(this));
 }
 
-class Visitor
+class EXT_VISIBLE Visitor
 {
 public:
     virtual ~Visitor();
@@ -0,0 +1,466 @@
+// Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+//
+// This file is part of C++Py-Tree.
+//
+// C++Py-Tree is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// C++Py-Tree is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cstdlib>
+#include <cstring>
+
+#include <dlfcn.h>
+#include <getopt.h>
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+#include "sys.hpp"
+#include "std-ext.hpp"
+#include "api.h"
+
+extern const char program[];
+extern const char verdate[];
+extern const char license[];
+
+const char program[] = "tree-api";
+const char verdate[] = "0.1 -- 2021-05-29 10:27"; // $ date +'%F %R'
+
+const char license[] =
+"Copyright (C) 2016, 2017, 2021  Stefan Vargyas.\n"
+"License GPLv3+: GNU GPL version 3 or later <http://gnu.org/licenses/gpl.html>.\n"
+"This is free software: you are free to change and redistribute it.\n"
+"There is NO WARRANTY, to the extent permitted by law.\n";
+
+// stev: 'tree-api' drives the trees given through the C interface
+// of 'api.so' -- 'api.h' -- all in one process: the arguments are
+// inputs and names of type lib modules, each input being handed to
+// the session of the module named last before it
+
+namespace ApiDriver {
+
+struct Error : public std::runtime_error
+{
+    Error(const std::string& msg) :
+        std::runtime_error(msg)
+    {}
+};
+
+struct options_t
+{
+    options_t() :
+        action(type_check_action),
+        flags(0),
+        repeat(0),
+        jobs(1)
+    {}
+
+    enum action_t {
+        type_check_action,
+        print_obj_action,
+    };
+
+    action_t action;
+    unsigned flags;
+    size_t   repeat;
+    size_t   jobs;
+
+    std::vector<const char*> args;
+
+    void parse(int argc, char* argv[]);
+};
+
+static void usage()
+{
+    using namespace std;
+    cout
+        << "usage: " << program << " [OPTION]... (MODULE [INPUT]...)..." << endl
+        << "where the options are:" << endl
+        << "  -c|--type-check      type check the inputs given (default)" << endl
+        << "  -o|--print-obj       build and print the AST objects of the inputs given" << endl
+        << "  -r|--relaxed-casts   when evaluating AST objects make polymorphic type casts" << endl
+        << "  -H|--hash-cons       hash-cons the built ASTs" << endl
+        << "     --verbose         be verbose" << endl
+        << "  -n|--repeat=NUM      run the action NUM times on each input, printing out" << endl
+        << "                         the mean latency of parsing and of the action" << endl
+        << "  -j|--jobs=NUM        run all inputs on NUM threads concurrently, each having sessions of" << endl
+        << "                         its own, checking that all threads got the same results" << endl
+        << "     --version         print version numbers and exit" << endl
+        << "  -?|--help            display this help info and exit" << endl
+        << "the arguments ending in '.so' name type lib modules -- e.g. 'abc/abc.so' --" << endl
+        << "these define the functions creating the sessions -- e.g. 'abc_session_new'" << endl;
+}
+
+static void version()
+{
+    std::cout << program << ": version " << verdate << "\n\n" << license;
+}
+
+static size_t parse_num(const char* opt_name, const char* opt_arg, size_t max)
+{
+    char* end;
+    errno = 0;
+    auto n = strtoul(opt_arg, &end, 10);
+    if (errno || *end || !isdigit(*opt_arg) || n < 1 || n > max)
+        throw Error(Sys::format(
+            "invalid argument for '%s' option: '%s'", opt_name, opt_arg));
+    return n;
+}
+
+void options_t::parse(int argc, char* argv[])
+{
+    static const struct option long_opts[] = {
+        { "type-check",    0, nullptr, 'c' },
+        { "print-obj",     0, nullptr, 'o' },
+        { "relaxed-casts", 0, nullptr, 'r' },
+        { "hash-cons",     0, nullptr, 'H' },
+        { "verbose",       0, nullptr, 'b' },
+        { "repeat",        1, nullptr, 'n' },
+        { "jobs",          1, nullptr, 'j' },
+        { "version",       0, nullptr, 'v' },
+        { "help",          0, nullptr, 'h' },
+        { nullptr,         0, nullptr, 0 }
+    };
+
+    int opt;
+    opterr = 0;
+    while ((opt = getopt_long(
+        argc, argv, ":corHn:j:", long_opts, nullptr)) != EOF) {
+        switch (opt) {
+        case 'c':
+            action = type_check_action;
+            break;
+        case 'o':
+            action = print_obj_action;
+            break;
+        case 'r':
+            flags |= TREE_RELAXED_CASTS;
+            break;
+        case 'H':
+            flags |= TREE_HASH_CONS;
+            break;
+        case 'b':
+            flags |= TREE_VERBOSE;
+            break;
+        case 'n':
+            repeat = parse_num("repeat", optarg, 1u << 30);
+            break;
+        case 'j':
+            jobs = parse_num("jobs", optarg, 256);
+            break;
+        case 'v':
+            version();
+            exit(0);
+        case ':':
+            throw Error(Sys::format(
+                "argument for option '%s' not found", argv[optind - 1]));
+        case 'h':
+            usage();
+            exit(0);
+        case '?':
+            if (optopt == '?') {
+                usage();
+                exit(0);
+            }
+            throw Error(Sys::format(
+                "invalid command line option '%s'", argv[optind - 1]));
+        default:
+            SYS_UNEXPECT_ERR("opt='%c'", opt);
+        }
+    }
+    args.assign(argv + optind, argv + argc);
+
+    if (args.empty())
+        throw Error("no module given");
+    if (repeat && jobs > 1)
+        throw Error("repeating and jobs are exclusive");
+}
+
+static bool is_module(const char* arg)
+{
+    auto n = strlen(arg);
+    return n > 3 && strcmp(arg + n - 3, ".so") == 0;
+}
+
+// stev: the modules are loaded with 'RTLD_LOCAL' for the type libs
+// define the same names -- e.g. the classes of the namespace 'AST';
+// the printer module of a type lib is the 'printer.so' next to it
+
+class module_t
+{
+public:
+    typedef int (*print_t)(const void*, char*, size_t, size_t*);
+
+    module_t(const module_t&) = delete;
+    module_t& operator=(const module_t&) = delete;
+
+    module_t(const char* name, unsigned flags, bool printer) :
+        handle{nullptr, nullptr},
+        session(nullptr),
+        print(nullptr)
+    {
+        std::string path(name), base(name);
+        auto p = base.rfind('/');
+        if (p != std::string::npos)
+            base.erase(0, p + 1);
+        base.resize(base.size() - 3);
+
+        typedef tree_session_t* (*session_new_t)(unsigned);
+        session = load<session_new_t>(0, path, base + "_session_new")(flags);
+
+        if (!printer)
+            return;
+        path.resize(p != std::string::npos ? p + 1 : 0);
+        path.append("printer.so");
+        print = load<print_t>(1, path, base + "_print");
+    }
+
+    ~module_t()
+    {
+        tree_session_free(session);
+        for (auto h : handle)
+            if (h != nullptr)
+                dlclose(h);
+    }
+
+    tree_session_t* get() const
+    { return session; }
+
+    print_t printer() const
+    { return print; }
+
+private:
+    template<typename F>
+    F load(size_t k, const std::string& path, const std::string& func)
+    {
+        handle[k] = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (handle[k] == nullptr)
+            throw Error(Sys::format(
+                "failed loading module '%s': %s", path.c_str(), dlerror()));
+        auto ptr = dlsym(handle[k], func.c_str());
+        if (ptr == nullptr)
+            throw Error(Sys::format(
+                "cannot find func '%s': %s", func.c_str(), dlerror()));
+        return reinterpret_cast<F>(ptr);
+    }
+
+    void*           handle[2];
+    tree_session_t* session;
+    print_t         print;
+};
+
+class ast_t
+{
+public:
+    ast_t(const ast_t&) = delete;
+    ast_t& operator=(const ast_t&) = delete;
+
+    ast_t(const char* input, unsigned flags) :
+        ast(nullptr)
+    {
+        char err[4096];
+        if (tree_parse(input, strlen(input), flags, &ast, err, sizeof err))
+            throw Error(err);
+    }
+
+    ~ast_t()
+    { tree_ast_free(ast); }
+
+    const tree_ast_t* get() const
+    { return ast; }
+
+private:
+    tree_ast_t* ast;
+};
+
+// stev: call 'func' putting the text it produced into 'text';
+// the buffer is enlarged and 'func' called again when too small
+
+template<typename F>
+static int call(std::string& text, F func)
+{
+    text.resize(std::max<size_t>(text.capacity(), 256));
+    for (;;) {
+        size_t len;
+        auto r = func(&text[0], text.size() + 1, &len);
+        auto n = text.size();
+        text.resize(len);
+        if (len <= n)
+            return r;
+    }
+}
+
+static int run(const options_t& opts, const module_t* mod,
+    const tree_ast_t* ast, std::string& text)
+{
+    using namespace std::placeholders;
+
+    if (opts.action == options_t::type_check_action)
+        return call(text, std::bind(
+            tree_type_check, mod->get(), ast, _1, _2, _3));
+
+    const void* node;
+    if (auto r = call(text, std::bind(
+            tree_build, mod->get(), ast, &node, _1, _2, _3)))
+        return r;
+    if (node == nullptr)
+        return 0;
+    return call(text, std::bind(mod->printer(), node, _1, _2, _3));
+}
+
+// stev: the results of the inputs, in order: the text printed
+// out -- the type, the object or the error message -- and the
+// exit status
+
+struct result_t
+{
+    result_t(int _status, const std::string& _text) :
+        status(_status),
+        text(_text)
+    {}
+
+    bool operator==(const result_t& r) const
+    { return status == r.status && text == r.text; }
+
+    int         status;
+    std::string text;
+};
+
+typedef std::vector<result_t> results_t;
+
+static void repeat(const options_t& opts, const module_t* mod,
+    const char* input, results_t& res)
+{
+    typedef std::chrono::steady_clock clock_t;
+    typedef std::chrono::duration<double, std::micro> usecs_t;
+
+    std::string text;
+    usecs_t parse(0), action(0);
+    for (size_t k = 0; k < opts.repeat; k ++) {
+        auto t0 = clock_t::now();
+        ast_t ast(input, opts.flags);
+        auto t1 = clock_t::now();
+        auto r = run(opts, mod, ast.get(), text);
+        auto t2 = clock_t::now();
+        if (r) {
+            res.emplace_back(r, text);
+            return;
+        }
+        parse += t1 - t0;
+        action += t2 - t1;
+    }
+    std::ostringstream ost;
+    ost << std::fixed << std::setprecision(3)
+        << "parse:  " << parse.count() / opts.repeat << "us\n"
+        << "action: " << action.count() / opts.repeat << "us";
+    res.emplace_back(0, ost.str());
+}
+
+// stev: the modules loaded -- thus the sessions -- are of the
+// calling thread; the first error of a module stops the run
+
+static void run(const options_t& opts, results_t& res)
+{
+    std::map<std::string, std::unique_ptr<module_t>> mods;
+    module_t* mod = nullptr;
+    std::string text;
+
+    for (auto arg : opts.args)
+    try {
+        if (is_module(arg)) {
+            auto& m = mods[arg];
+            if (!m)
+                m.reset(new module_t(arg, opts.flags,
+                    opts.action == options_t::print_obj_action));
+            mod = m.get();
+            continue;
+        }
+        if (mod == nullptr)
+            throw Error(Sys::format(
+                "no module given for input '%s'", arg));
+
+        if (opts.repeat) {
+            repeat(opts, mod, arg, res);
+            continue;
+        }
+        ast_t ast(arg, opts.flags);
+        auto r = run(opts, mod, ast.get(), text);
+        res.emplace_back(r, text);
+    }
+    catch (const Error& err) {
+        res.emplace_back(1, err.what());
+        if (is_module(arg) || mod == nullptr)
+            return;
+    }
+}
+
+// stev: run the inputs on 'opts.jobs' threads concurrently, each
+// having sessions of its own; the results must be the same
+
+static void jobs(const options_t& opts, results_t& res)
+{
+    std::vector<results_t> results(opts.jobs);
+    std::vector<std::thread> threads;
+    for (auto& r : results)
+        threads.emplace_back(
+            [&opts, &r]() { run(opts, r); });
+    for (auto& t : threads)
+        t.join();
+
+    for (const auto& r : results) {
+        if (r != results.front())
+            throw Error("jobs: the results of the threads differ");
+    }
+    res = results.front();
+}
+
+static int print(const results_t& res)
+{
+    int s = 0;
+    for (const auto& r : res) {
+        (r.status ? std::cerr << program << ": error: " : std::cout)
+            << r.text << std::endl;
+        s |= r.status;
+    }
+    return s;
+}
+
+} // namespace ApiDriver
+
+int main(int argc, char* argv[])
+try
+{
+    using namespace ApiDriver;
+
+    options_t opts;
+    opts.parse(argc, argv);
+
+    results_t res;
+    if (opts.jobs > 1)
+        jobs(opts, res);
+    else
+        run(opts, res);
+    return print(res);
+}
+catch (const std::exception& exc) {
+    std::cerr << program << ": error: " << exc.what() << std::endl;
+    return 1;
+}
+
@@ -0,0 +1,112 @@
+// Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+//
+// This file is part of C++Py-Tree.
+//
+// C++Py-Tree is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// C++Py-Tree is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <sstream>
+
+#include "sys.hpp"
+#include "parser.hpp"
+#include "api.hpp"
+
+namespace Api {
+
+std::unique_ptr<TreeAST::AST> parse(
+    const char* buf, size_t len, const parse_opts_t& opts, const char* name)
+try {
+    using Parser::Parser;
+
+    // stev: the parser's text input is NUL-terminated
+    const std::string input(buf, len);
+
+    Parser parser(
+#ifdef DEBUG
+        false,
+#endif
+        opts.verbose,
+        opts.hash_cons,
+        opts.fingerprints,
+        Parser::text_input,
+        name,
+        input.c_str());
+
+    return parser.parse();
+}
+catch (const Parser::ParserError& err) {
+    throw Error(err.msg("parse error"));
+}
+
+// stev: null arguments are reported the way the other errors
+// are, not asserted upon: an assertion failure would abort the
+// program the library is embedded in
+
+static void check_arg(const void* arg, const char* name)
+{
+    if (arg == nullptr)
+        throw Error(Sys::format(
+            "invalid argument '%s': null pointer", name));
+}
+
+} // namespace Api
+
+int tree_parse(const char* buf, size_t len, unsigned flags,
+    tree_ast_t** ast, char* err, size_t size)
+try {
+    Api::check_arg(ast, "ast");
+    if (len > 0)
+        Api::check_arg(buf, "buf");
+    *ast = Api::parse(buf, len, flags).release();
+    return Api::put_text(0, std::string(), err, size, nullptr);
+}
+catch (const std::exception& e) {
+    return Api::put_text(1, e.what(), err, size, nullptr);
+}
+
+void tree_ast_free(tree_ast_t* ast)
+{ delete ast; }
+
+void tree_session_free(tree_session_t* session)
+{ delete session; }
+
+int tree_type_check(tree_session_t* session, const tree_ast_t* ast,
+    char* buf, size_t size, size_t* len)
+try {
+    Api::check_arg(session, "session");
+    Api::check_arg(ast, "ast");
+    std::ostringstream ost;
+    session->type_check(ast, ost);
+    return Api::put_text(0, ost.str(), buf, size, len);
+}
+catch (const std::exception& e) {
+    return Api::put_text(1, e.what(), buf, size, len);
+}
+
+int tree_build(tree_session_t* session, const tree_ast_t* ast,
+    const void** node, char* buf, size_t size, size_t* len)
+try {
+    Api::check_arg(session, "session");
+    Api::check_arg(ast, "ast");
+    std::ostringstream ost;
+    auto res = session->build(ast, &ost);
+    if (node != nullptr)
+        *node = res;
+    return Api::put_text(0, ost.str(), buf, size, len);
+}
+catch (const std::exception& e) {
+    if (node != nullptr)
+        *node = nullptr;
+    return Api::put_text(1, e.what(), buf, size, len);
+}
+
@@ -0,0 +1,99 @@
+/* Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+ *
+ * This file is part of C++Py-Tree.
+ *
+ * C++Py-Tree is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * C++Py-Tree is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TREE_API_H
+#define __TREE_API_H
+
+#include <stddef.h>
+
+/* stev: the C interface of the library 'api.so' -- the C++ one
+ * is in 'api.hpp'; a program parses its trees from memory with
+ * 'tree_parse' and hands them over to a session of a type lib for
+ * type checking or for building them into nodes of that lib's AST;
+ * the sessions are created by the functions '*_session_new' which
+ * the modules of the type libs define -- e.g. 'abc.so' defines
+ * 'abc_session_new'; nothing of the API reads the command line or
+ * prints to the standard streams: the texts produced -- the types,
+ * the objects built and the error messages -- are written to the
+ * buffers given, the way 'snprintf' does: the buffers get at most
+ * 'size' chars, NUL included, while '*len' receives the length of
+ * the whole text; the functions return zero on success and non-zero
+ * on failure, in which case the buffer holds the error message --
+ * null pointers given for the ASTs or the sessions are failures too;
+ * 'tree_parse' is reentrant, while each session is to be used by one
+ * thread at a time -- distinct sessions may run in distinct threads */
+
+#ifdef __cplusplus
+namespace TreeAST { class AST; }
+namespace Api { class session_t; }
+typedef TreeAST::AST tree_ast_t;
+typedef Api::session_t tree_session_t;
+extern "C" {
+#else
+typedef struct tree_ast_t tree_ast_t;
+typedef struct tree_session_t tree_session_t;
+#endif
+
+enum {
+    TREE_HASH_CONS      = 1 << 0,
+    TREE_FINGERPRINTS   = 1 << 1,
+    TREE_VERBOSE        = 1 << 2,
+    TREE_RELAXED_CASTS  = 1 << 3
+};
+
+/* stev: the flags of 'tree_parse' are TREE_HASH_CONS, TREE_FINGERPRINTS
+ * and TREE_VERBOSE -- the latter asking for verbose error messages */
+int tree_parse(const char* buf, size_t len, unsigned flags,
+    tree_ast_t** ast, char* err, size_t size);
+
+void tree_ast_free(tree_ast_t* ast);
+
+/* stev: the flags of '*_session_new' are all the above: the first two
+ * apply to the AST the nodes get built into, TREE_VERBOSE to printing
+ * the types and the objects and TREE_RELAXED_CASTS to evaluation */
+tree_session_t* abc_session_new(unsigned flags);
+tree_session_t* cxxpy_session_new(unsigned flags);
+
+void tree_session_free(tree_session_t* session);
+
+/* stev: print the node '*_build' produced the way 'tree --print-obj'
+ * does; the functions are defined by the printer modules of the type
+ * libs -- e.g. 'abc/printer.so' defines 'abc_print'; the type libs
+ * are built with their symbols hidden, but for these entry points
+ * and for the few of their ASTs which their printers link to; the
+ * latter are named alike in all the type libs, thus these are to be
+ * loaded by 'dlopen' with RTLD_LOCAL -- as 'tree-api' does -- and
+ * not linked to directly */
+int abc_print(const void* node, char* buf, size_t size, size_t* len);
+int cxxpy_print(const void* node, char* buf, size_t size, size_t* len);
+
+int tree_type_check(tree_session_t* session, const tree_ast_t* ast,
+    char* buf, size_t size, size_t* len);
+
+/* stev: '*node' receives the root node of the AST built or NULL when
+ * the tree evaluated to other than a node; the node is owned by the
+ * session and is valid until the next call of 'tree_build' on it */
+int tree_build(tree_session_t* session, const tree_ast_t* ast,
+    const void** node, char* buf, size_t size, size_t* len);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* __TREE_API_H */
+
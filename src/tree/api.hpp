@@ -0,0 +1,113 @@
+// Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+//
+// This file is part of C++Py-Tree.
+//
+// C++Py-Tree is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// C++Py-Tree is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __TREE_API_HPP
+#define __TREE_API_HPP
+
+#include <cstring>
+
+#include <iosfwd>
+#include <string>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+#include "api.h"
+
+namespace Api {
+
+struct Error : public std::runtime_error
+{
+    Error(const std::string& msg) :
+        std::runtime_error(msg)
+    {}
+};
+
+struct parse_opts_t
+{
+    parse_opts_t(unsigned flags = 0) :
+        hash_cons(flags & TREE_HASH_CONS),
+        fingerprints(flags & TREE_FINGERPRINTS),
+        verbose(flags & TREE_VERBOSE)
+    {}
+
+    bool hash_cons;
+    bool fingerprints;
+    bool verbose;
+};
+
+// stev: copy 'text' into 'buf' the way 'snprintf' does and return 'res';
+// nothing gets copied when 'buf' is null
+
+inline int put_text(int res, const std::string& text,
+    char* buf, size_t size, size_t* len)
+{
+    if (buf != nullptr && size > 0) {
+        auto n = std::min(text.size(), size - 1);
+        memcpy(buf, text.data(), n);
+        buf[n] = 0;
+    }
+    if (len != nullptr)
+        *len = text.size();
+    return res;
+}
+
+// stev: parse the tree text of 'len' chars at 'buf' -- which need
+// not be NUL-terminated; 'name' is the name of the input the error
+// messages refer to; throw 'Error' on parse errors
+
+std::unique_ptr<TreeAST::AST> parse(
+    const char* buf, size_t len,
+    const parse_opts_t& opts = parse_opts_t(),
+    const char* name = "<text>");
+
+// stev: 'session_t' is the evaluation state a type lib keeps for
+// the trees given to it: the makers, the evaluators and the target
+// AST; it is created by the function '*_session_new' of the type
+// lib; a session is to be used by one thread at a time, yet distinct
+// sessions may be used concurrently by distinct threads, since the
+// tables of AST types are of thread scope; the methods print
+// the type of the tree, respectively the object it got built into
+// on 'ost' and throw 'Error' on type errors
+
+class session_t
+{
+public:
+    virtual ~session_t() {}
+
+    session_t(const session_t&) = delete;
+    session_t& operator=(const session_t&) = delete;
+
+    virtual void type_check(const TreeAST::AST* ast, std::ostream& ost) = 0;
+
+    // stev: return the root node of the target AST or 'nullptr' when
+    // the tree evaluated to other than a node; the node is valid until
+    // the next call of 'build'
+    virtual const void* build(const TreeAST::AST* ast, std::ostream* ost = nullptr) = 0;
+
+    template<typename T>
+    const T* build(const TreeAST::AST* ast, std::ostream* ost = nullptr)
+    { return static_cast<const T*>(build(ast, ost)); }
+
+protected:
+    session_t() {}
+};
+
+} // namespace Api
+
+#endif /* __TREE_API_HPP */
+
@@ -77,8 +77,21 @@ AST::AST(
         _debug,
 #endif
         POOL_SIZE,
-        base_t::node_destr),
-    n_treenodes(0)
+        base_t::node_destr)
+{}
+
+AST::AST(
+#ifdef DEBUG
+    bool _debug,
+#endif
+    const extent_t& ext
+) :
+    base_t(
+#ifdef DEBUG
+        _debug,
+#endif
+        ext,
+        base_t::node_destr)
 {}
 
 AST::~AST()
@@ -151,7 +164,208 @@ void AST::root_node(const Node* node)
 {
     Arg<Node>::check(this, node);
     root = node;
-    n_treenodes = std::count_if(node_begin(), node_end(), IsTreeNode());
+}
+
+// stev: 'Compactor' reserves the slot of each node before
+// copying its strings, its lists and then its children, such
+// that both the node pool and the raw pool of the target AST
+// end up being laid out in depth-first pre-order; the nodes,
+// strings and lists shared in the source AST -- e.g. due to
+// hash-consing -- are copied only once, thus remain shared
+
+class AST::Compactor :
+    private Visitor,
+    public  base_t::copier_t<Compactor>
+{
+public:
+    typedef base_t::copier_t<Compactor> copier_t;
+
+    Compactor(AST* _ast) :
+        copier_t(_ast)
+    {}
+
+private:
+    friend class base_t::copier_t<Compactor>;
+
+// > COMPACTOR_VISITOR_DECL $ grammar -VD
+    void visit(const Literal*);
+    void visit(const ListElem*);
+    void visit(const NodeName*);
+    void visit(const NodeList*);
+    void visit(const ArgName*);
+    void visit(const ArgValue*);
+    void visit(const NodeValue*);
+    void visit(const ListValue*);
+    void visit(const LiteralValue*);
+    void visit(const NodeArg*);
+    void visit(const NodeArgs*);
+    void visit(const ListArgs*);
+    void visit(const LiteralArgs*);
+    void visit(const TreeNode*);
+    void visit(const Tree*);
+// < COMPACTOR_VISITOR_DECL
+};
+
+// > COMPACTOR_VISITOR_IMPL $ grammar -VI=AST::Compactor
+void AST::Compactor::visit(const Literal* arg)
+{
+    auto p = reserve<Literal>();
+    auto s = copy(arg->str);
+    make<Literal>(p, arg, s);
+}
+
+void AST::Compactor::visit(const ListElem* arg)
+{
+    auto p = reserve<ListElem>();
+    auto n = copy(arg->node);
+    make<ListElem>(p, arg, arg->index, n);
+}
+
+void AST::Compactor::visit(const NodeName* arg)
+{
+    auto p = reserve<NodeName>();
+    auto s = copy(arg->ident);
+    make<NodeName>(p, arg, s);
+}
+
+void AST::Compactor::visit(const NodeList* arg)
+{
+    auto p = reserve<NodeList>();
+    auto b = copy(arg->base);
+    auto e = copy(arg->elems);
+    make<NodeList>(p, arg, b, e);
+}
+
+void AST::Compactor::visit(const ArgName* arg)
+{
+    auto p = reserve<ArgName>();
+    auto s = copy(arg->str);
+    make<ArgName>(p, arg, s);
+}
+
+void AST::Compactor::visit(const ArgValue* arg)
+{
+    auto p = reserve<ArgValue>();
+    make<ArgValue>(p, arg);
+}
+
+void AST::Compactor::visit(const NodeValue* arg)
+{
+    auto p = reserve<NodeValue>();
+    auto n = copy(arg->node);
+    make<NodeValue>(p, arg, n);
+}
+
+void AST::Compactor::visit(const ListValue* arg)
+{
+    auto p = reserve<ListValue>();
+    auto l = copy(arg->list);
+    make<ListValue>(p, arg, l);
+}
+
+void AST::Compactor::visit(const LiteralValue* arg)
+{
+    auto p = reserve<LiteralValue>();
+    auto l = copy(arg->literal);
+    make<LiteralValue>(p, arg, l);
+}
+
+void AST::Compactor::visit(const NodeArg* arg)
+{
+    auto p = reserve<NodeArg>();
+    auto n = copy(arg->name);
+    auto v = copy(arg->value);
+    make<NodeArg>(p, arg, n, v);
+}
+
+void AST::Compactor::visit(const NodeArgs* arg)
+{
+    auto p = reserve<NodeArgs>();
+    make<NodeArgs>(p, arg);
+}
+
+void AST::Compactor::visit(const ListArgs* arg)
+{
+    auto p = reserve<ListArgs>();
+    auto l = copy(arg->list);
+    make<ListArgs>(p, arg, l);
+}
+
+void AST::Compactor::visit(const LiteralArgs* arg)
+{
+    auto p = reserve<LiteralArgs>();
+    auto l = copy(arg->literal);
+    make<LiteralArgs>(p, arg, l);
+}
+
+void AST::Compactor::visit(const TreeNode* arg)
+{
+    auto p = reserve<TreeNode>();
+    auto n = copy(arg->name);
+    auto a = copy(arg->args);
+    make<TreeNode>(p, arg, n, a);
+}
+
+void AST::Compactor::visit(const Tree* arg)
+{
+    auto p = reserve<Tree>();
+    auto r = copy(arg->root);
+    make<Tree>(p, arg, r);
+}
+// < COMPACTOR_VISITOR_IMPL
+
+void AST::compact(size_t node_nobjs)
+{
+    if (root == nullptr)
+        return;
+
+    // stev: as with 'extract', a first walk over the tree
+    // computes the extent of the new pools; 'node_nobjs' --
+    // when not null -- overrides the number of nodes only
+    Compactor ext(nullptr);
+    ext.copy(root);
+
+    auto extent = ext.extent();
+    if (node_nobjs)
+        extent.node_nobjs = node_nobjs;
+
+    AST ast(
+#ifdef DEBUG
+        is_debug(),
+#endif
+        extent);
+    ast.fingerprints(fingerprints());
+    Compactor comp(&ast);
+    ast.root = comp.copy(root);
+
+    base_t::swap(ast);
+
+    // stev: the hash-consing tables refer to the old nodes
+    if (cons != nullptr)
+        cons->clear();
+}
+
+std::unique_ptr<AST> AST::extract(const Node* node) const
+{
+    if (!owns(node))
+        error("invalid node pointer '%p'", node);
+
+    // stev: a first walk over the subgraph computes
+    // the extent of the pools of the new AST and the
+    // second one does the actual copying of the nodes
+    Compactor ext(nullptr);
+    ext.copy(node);
+
+    std::unique_ptr<AST> ast(new AST(
+#ifdef DEBUG
+        is_debug(),
+#endif
+        ext.extent()));
+    ast->fingerprints(fingerprints());
+    Compactor comp(ast.get());
+    ast->root = comp.copy(node);
+
+    return ast;
 }
 
 // > AST_NEW_NODE_IMPL $ grammar -NNI
@@ -160,7 +374,7 @@ const Node* AST::new_node()
     return new_node<Node>();
 }
 
-const Literal* AST::new_literal(const char* str)
+const Literal* AST::new_literal(const str_t str)
 {
     return new_node<Literal>(alloc_arg(str));
 }
@@ -170,7 +384,7 @@ const ListElem* AST::new_listelem(const list_elem_idx_t index, const TreeNode* n
     return new_node<ListElem>(alloc_arg(index), alloc_arg(node));
 }
 
-const NodeName* AST::new_nodename(const char* ident)
+const NodeName* AST::new_nodename(const str_t ident)
 {
     return new_node<NodeName>(alloc_arg(ident));
 }
@@ -180,7 +394,7 @@ const NodeList* AST::new_nodelist(const NodeName* base, const std::list<const Li
     return new_node<NodeList>(alloc_arg(base), alloc_arg(elems));
 }
 
-const ArgName* AST::new_argname(const char* str)
+const ArgName* AST::new_argname(const str_t str)
 {
     return new_node<ArgName>(alloc_arg(str));
 }
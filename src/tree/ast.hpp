@@ -25,6 +25,7 @@
 #include <iterator>
 #include <algorithm>
 #include <list>
+#include <memory>
 #include <stdexcept>
 #include <utility>
 
@@ -120,16 +121,53 @@ public:
     const Node* root_node() const { return root; }
     void root_node(const Node*);
 
+    // stev: copy the nodes reachable from the root into fresh
+    // pools sized to fit, in depth-first pre-order, and release
+    // the old ones; note that all pointers into the AST obtained
+    // prior to the call of 'compact' get invalidated; the new
+    // node pool holds at most 'node_nobjs' nodes -- when not
+    // null; on failure, the AST is left as it was
+    void compact(size_t node_nobjs = 0);
+
+    // stev: copy the nodes reachable from 'node' into a new
+    // AST having its pools sized to fit, and of which root is
+    // the copy of 'node'; the new AST does not depend on this
+    // one, which thus can be released right away
+    std::unique_ptr<AST> extract(const Node* node) const;
+
     size_t num_node() const { return base_t::num_node(); }
-    size_t num_treenode() const { return n_treenodes; }
+
+    bool hash_cons() const { return base_t::hash_cons(); }
+    void hash_cons(bool enable) { base_t::hash_cons(enable); }
+
+    ConsTable::stats_t cons_stats() const { return base_t::cons_stats(); }
+
+    mem_stats_t mem_stats() const { return base_t::mem_stats(); }
+
+    bool fingerprints() const { return base_t::fingerprints(); }
+    void fingerprints(bool enable) { base_t::fingerprints(enable); }
+
+    bool fingerprint(const Node* node, fingerprint_t& res) const
+    { return base_t::fingerprint(node, res); }
+
+    template<typename T>
+    using type_range_t = base_t::type_range_t<T>;
+
+    template<typename T>
+    type_range_t<T> nodes_of() const { return base_t::nodes_of<T>(); }
+
+    template<typename T>
+    size_t count() const { return base_t::count<T>(); }
+
+    size_t num_treenode() const;
 
 // > AST_NEW_NODE_DECL $ grammar -NND
     const Node* new_node();
-    const Literal* new_literal(const char* str);
+    const Literal* new_literal(const str_t str);
     const ListElem* new_listelem(const list_elem_idx_t index, const TreeNode* node);
-    const NodeName* new_nodename(const char* ident);
+    const NodeName* new_nodename(const str_t ident);
     const NodeList* new_nodelist(const NodeName* base, const std::list<const ListElem*>* elems);
-    const ArgName* new_argname(const char* str);
+    const ArgName* new_argname(const str_t str);
     const ArgValue* new_argvalue();
     const NodeValue* new_nodevalue(const TreeNode* node);
     const ListValue* new_listvalue(const NodeList* list);
@@ -147,7 +185,7 @@ public:
     node_iterator node_begin() const { return base_t::node_begin(); }
     node_iterator node_end() const   { return base_t::node_end(); }
 
-    class treenode_iterator;
+    typedef base_t::type_iterator<TreeNode> treenode_iterator;
 
     treenode_iterator treenode_begin() const;
     treenode_iterator treenode_end() const;
@@ -155,6 +193,14 @@ public:
 private:
     using base_t::new_node;
 
+    typedef base_t::extent_t extent_t;
+
+    AST(
+#ifdef DEBUG
+        bool _debug,
+#endif
+        const extent_t& ext);
+
     template<typename T>
     typename Arg<root_t, T>::result_t alloc_arg(T arg)
     {
@@ -166,9 +212,7 @@ private:
     friend class Arg<root_t, const std::list<const NodeArg*>*>;
 // < NODE_LIST_ARGS_FRIENDS
 
-    struct IsTreeNode;
-
-    size_t n_treenodes;
+    class Compactor;
 };
 
 class Visitor0;
@@ -176,6 +220,9 @@ class Visitor;
 
 typedef Ext::widest_uint_t result_t;
 
+// stev: the 'char*' arguments of 'grammar.g++' are of type
+// 'str_t' below -- see the note in there
+
 // > NODE_CLASSES_DEF $ grammar -NDP
 class Node
 {
@@ -202,13 +249,17 @@ public:
 private:
     friend class BaseAST<Node>;
 
+    // stev: the index of the node in the node pool of its AST;
+    // it precedes 't' such that the derived classes may still
+    // lay out their first small members in the tail padding
+    unsigned n;
     mutable unsigned short t;
 };
 
 class Literal : public Node
 {
 public:
-    Literal(const char* _str) :
+    Literal(const str_t _str) :
         str(_str)
     {}
 
@@ -217,7 +268,7 @@ public:
     result_t accept(Visitor0*) const;
     void accept(Visitor*) const;
 
-    const char* str;
+    const str_t str;
 };
 
 class ListElem : public Node
@@ -240,7 +291,7 @@ public:
 class NodeName : public Node
 {
 public:
-    NodeName(const char* _ident) :
+    NodeName(const str_t _ident) :
         ident(_ident)
     {}
 
@@ -249,7 +300,7 @@ public:
     result_t accept(Visitor0*) const;
     void accept(Visitor*) const;
 
-    const char* ident;
+    const str_t ident;
 };
 
 class NodeList : public Node
@@ -272,7 +323,7 @@ public:
 class ArgName : public Node
 {
 public:
-    ArgName(const char* _str) :
+    ArgName(const str_t _str) :
         str(_str)
     {}
 
@@ -281,7 +332,7 @@ public:
     result_t accept(Visitor0*) const;
     void accept(Visitor*) const;
 
-    const char* str;
+    const str_t str;
 };
 
 class ArgValue : public Node
@@ -742,51 +793,19 @@ public:
 // < VISITOR_DECL
 };
 
-struct AST::IsTreeNode : Ext::unary_func_t<bool, const Node*>
+inline size_t AST::num_treenode() const
 {
-    bool operator()(const Node* node) const
-    {
-        return node->type() == node_t::TreeNode;
-    }
-};
-
-class AST::treenode_iterator :
-    public std::iterator<std::input_iterator_tag, const TreeNode>,
-    private AST::op_node_iterator<AST::IsTreeNode>
-{
-public:
-    typedef AST::op_node_iterator<AST::IsTreeNode> base_t;
-
-    using base_t::operator++;
-
-    bool operator==(const treenode_iterator& v) const
-    { return base_t::operator==(v); }
-    bool operator!=(const treenode_iterator& v) const
-    { return base_t::operator!=(v); }
-
-    const TreeNode* operator*() const
-    { return static_cast<const TreeNode*>(*ptr); }
-    const TreeNode* operator->() const
-    { return static_cast<const TreeNode*>(*ptr); }
-
-private:
-    treenode_iterator(const node_iterator& _ptr, const node_iterator& _end) :
-        base_t(_ptr, _end)
-    {}
-    treenode_iterator(const node_iterator& _ptr) :
-        base_t(_ptr)
-    {}
-    friend class AST;
-};
+    return count<TreeNode>();
+}
 
 inline AST::treenode_iterator AST::treenode_begin() const
 {
-    return treenode_iterator(node_begin(), node_end());
+    return nodes_of<TreeNode>().begin();
 }
 
 inline AST::treenode_iterator AST::treenode_end() const
 {
-    return treenode_iterator(node_end());
+    return nodes_of<TreeNode>().end();
 }
 
 } // namespace TreeAST
@@ -0,0 +1,425 @@
+// Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+// 
+// This file is part of C++Py-Tree.
+// 
+// C++Py-Tree is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// C++Py-Tree is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+
+// stev: 'MAP_TYPE' of <sys/mman.h> is not used
+// herein and would clash with that of "config.h"
+#undef MAP_TYPE
+
+#include "sys.hpp"
+#include "std-ext.hpp"
+#include "cache.hpp"
+
+extern const char program[];
+
+namespace Tree {
+
+static const char magic[8] = {
+    'T', 'R', 'E', 'E', 'C', 'C', 'H', '3'
+};
+
+static const char log_magic[8] = {
+    'T', 'R', 'E', 'E', 'L', 'O', 'G', '1'
+};
+
+TypeCache::Error::Error(const std::string& msg) :
+    std::runtime_error(msg)
+{}
+
+static void error(const char* what, const std::string& file)
+{
+    throw TypeCache::Error(
+        Sys::format("type-cache: %s '%s': %s",
+            what, file.c_str(), strerror(errno)));
+}
+
+void TypeCache::hasher_t::add(const char* str, size_t n)
+{
+    auto r = key.hash[0];
+    auto s = key.hash[1];
+    for (auto p = str, e = p + n; p < e; p ++) {
+        auto c = static_cast<unsigned char>(*p);
+        r = (r ^ c) * 1099511628211u;
+        s = ((s << 23 | s >> 41) ^ c) * 18397679294719823053u;
+    }
+    key.hash[0] = r;
+    key.hash[1] = s;
+}
+
+// stev: 'map_t' maps the cache file in memory read-only; a
+// missing file or one of invalid layout is seen as empty
+
+class TypeCache::map_t
+{
+public:
+    map_t(const map_t&) = delete;
+    map_t& operator=(const map_t&) = delete;
+
+    explicit map_t(const char* file);
+    ~map_t();
+
+    const rec_t* begin() const { return recs; }
+    const rec_t* end() const   { return recs + n_rec; }
+
+private:
+    void*        ptr;
+    size_t       len;
+    const rec_t* recs;
+    size_t       n_rec;
+};
+
+TypeCache::map_t::map_t(const char* file) :
+    ptr(nullptr),
+    len(0),
+    recs(nullptr),
+    n_rec(0)
+{
+    auto fd = open(file, O_RDONLY);
+    if (fd < 0) {
+        if (errno != ENOENT)
+            error("cannot open", file);
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        error("cannot stat", file);
+    }
+    len = st.st_size;
+    if (len >= sizeof(head_t)) {
+        ptr = mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+        if (ptr == MAP_FAILED)
+            ptr = nullptr;
+    }
+    close(fd);
+    if (ptr == nullptr)
+        return;
+    auto head = static_cast<const head_t*>(ptr);
+    if (memcmp(head->magic, magic, sizeof magic) ||
+        head->n_rec != (len - sizeof(head_t)) / sizeof(rec_t) ||
+        (len - sizeof(head_t)) % sizeof(rec_t))
+        return;
+    recs = reinterpret_cast<const rec_t*>(head + 1);
+    n_rec = head->n_rec;
+}
+
+TypeCache::map_t::~map_t()
+{
+    if (ptr != nullptr)
+        munmap(ptr, len);
+}
+
+// stev: the records of the journal get sorted by key; of
+// the records of equal keys, the last appended one is kept;
+// a missing journal or one of invalid magic is seen as empty,
+// while a trailing partial record -- of an append which did
+// not complete -- is ignored
+
+void TypeCache::read_log(const std::string& name, recs_t& recs)
+{
+    recs.clear();
+    auto fd = open(name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (errno != ENOENT)
+            error("cannot open", name);
+        return;
+    }
+    struct stat st;
+    char buf[sizeof log_magic];
+    if (fstat(fd, &st) < 0 ||
+        read(fd, buf, sizeof buf) < 0) {
+        close(fd);
+        error("cannot read", name);
+    }
+    if (size_t(st.st_size) < sizeof log_magic ||
+        memcmp(buf, log_magic, sizeof log_magic)) {
+        close(fd);
+        return;
+    }
+    recs.resize((st.st_size - sizeof log_magic) / sizeof(rec_t));
+    auto n = recs.size() * sizeof(rec_t);
+    if (read(fd, recs.data(), n) != ssize_t(n)) {
+        close(fd);
+        error("cannot read", name);
+    }
+    close(fd);
+
+    std::stable_sort(recs.begin(), recs.end(), less);
+    auto r = recs.begin();
+    for (auto p = recs.begin(); p < recs.end(); p ++) {
+        if (p + 1 < recs.end() && !less(*p, *(p + 1)))
+            continue;
+        *r ++ = *p;
+    }
+    recs.erase(r, recs.end());
+}
+
+thread_local TypeCache* TypeCache::current = nullptr;
+
+// stev: the files are read under a shared lock; a missing
+// lock file means that no process updated the cache yet
+
+TypeCache::TypeCache(const char* _file) :
+    file(_file),
+    pending(false),
+    recorded(false)
+{
+    std::string name(file);
+    std::string lock_name = name + ".lock";
+    auto lock = open(lock_name.c_str(), O_RDONLY);
+    if (lock < 0 && errno != ENOENT)
+        error("cannot open", lock_name);
+    if (lock >= 0 && flock(lock, LOCK_SH) < 0) {
+        close(lock);
+        error("cannot lock", lock_name);
+    }
+    try {
+        map.reset(new map_t(file));
+        read_log(name + ".log", log);
+    }
+    catch (...) {
+        if (lock >= 0)
+            close(lock);
+        throw;
+    }
+    if (lock >= 0)
+        close(lock);
+}
+
+// stev: an input the evaluation of which threw is
+// still cached if its verdict got recorded already;
+// the cache not getting updated is not fatal, yet
+// it is reported
+
+TypeCache::~TypeCache()
+{
+    try {
+        end();
+        commit();
+    }
+    catch (const std::exception& err) {
+        std::cerr << program << ": error: " << err.what() << std::endl;
+    }
+}
+
+const TypeCache::rec_t* TypeCache::lookup(
+    const rec_t* begin, const rec_t* end, const key_t& key)
+{
+    rec_t rec;
+    rec.key = key;
+    auto p = std::lower_bound(begin, end, rec, less);
+    if (p != end && p->key == key)
+        return p;
+    return nullptr;
+}
+
+// stev: the verdicts inserted by this process are looked
+// up first, then those of the journal, then those of the
+// cache file
+
+bool TypeCache::find(const key_t& key, verdict_t& verdict) const
+{
+    auto rec = lookup(recs.data(), recs.data() + recs.size(), key);
+    if (rec == nullptr)
+        rec = lookup(log.data(), log.data() + log.size(), key);
+    if (rec == nullptr)
+        rec = lookup(map->begin(), map->end(), key);
+    if (rec == nullptr)
+        return false;
+    verdict.status = rec->status;
+    verdict.text.assign(rec->text,
+        std::min<size_t>(rec->len, max_text));
+    return true;
+}
+
+void TypeCache::begin(const key_t& key)
+{
+    pending = true;
+    recorded = false;
+    pending_key = key;
+    current = this;
+}
+
+void TypeCache::end()
+{
+    if (current == this)
+        current = nullptr;
+    if (pending && recorded)
+        insert(pending_key, pending_verdict);
+    pending = false;
+}
+
+void TypeCache::record(int status, const std::string& text)
+{
+    if (current == nullptr || !current->pending)
+        return;
+    current->pending_verdict.status = status;
+    current->pending_verdict.text = text;
+    current->recorded = true;
+}
+
+void TypeCache::insert(const key_t& key, const verdict_t& verdict)
+{
+    if (verdict.text.size() > max_text)
+        return;
+    rec_t rec;
+    memset(&rec, 0, sizeof rec);
+    rec.key = key;
+    rec.status = verdict.status;
+    rec.len = verdict.text.size();
+    memcpy(rec.text, verdict.text.data(), rec.len);
+    auto i = std::lower_bound(recs.begin(), recs.end(), rec, less);
+    if (i != recs.end() && i->key == key)
+        *i = rec;
+    else
+        recs.insert(i, rec);
+}
+
+// stev: the records of this process get appended to the journal
+// in one write, unless the journal would grow past 'max_log' or
+// is found of invalid layout -- e.g. after an append which did not
+// complete; the journal is then merged into the cache file instead
+
+void TypeCache::commit()
+{
+    CXX_ASSERT(sizeof(head_t) == 16);
+    CXX_ASSERT(sizeof(rec_t) == rec_size);
+
+    if (recs.empty())
+        return;
+
+    std::string name(file);
+    std::string lock_name = name + ".lock";
+    auto lock = open(lock_name.c_str(), O_RDWR | O_CREAT, 0666);
+    if (lock < 0)
+        error("cannot open", lock_name);
+    if (flock(lock, LOCK_EX) < 0) {
+        close(lock);
+        error("cannot lock", lock_name);
+    }
+
+    auto log_name = name + ".log";
+    auto fd = open(log_name.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0666);
+    if (fd < 0) {
+        close(lock);
+        error("cannot open", log_name);
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        close(lock);
+        error("cannot stat", log_name);
+    }
+    size_t len = st.st_size;
+    auto valid =
+        len == 0 ||
+        (len >= sizeof log_magic &&
+         (len - sizeof log_magic) % sizeof(rec_t) == 0);
+    auto n_log = len > sizeof log_magic
+        ? (len - sizeof log_magic) / sizeof(rec_t)
+        : 0;
+
+    if (valid && n_log + recs.size() <= max_log) {
+        std::string buf;
+        if (len == 0)
+            buf.append(log_magic, sizeof log_magic);
+        buf.append(
+            reinterpret_cast<const char*>(recs.data()),
+            recs.size() * sizeof(rec_t));
+        if (write(fd, buf.data(), buf.size()) != ssize_t(buf.size()) ||
+            close(fd) < 0) {
+            close(lock);
+            error("cannot write", log_name);
+        }
+    }
+    else {
+        close(fd);
+        try {
+            compact(log_name);
+        }
+        catch (...) {
+            close(lock);
+            throw;
+        }
+    }
+    close(lock);
+
+    recs.clear();
+}
+
+// stev: merge the records of this process and those of the journal
+// into those found in the cache file now -- of the records of equal
+// keys, those of this process take precedence over those of the
+// journal, which take precedence over those of the cache file; the
+// sort being stable, the first one is kept; the journal is removed
+// once the new cache file got renamed over the old one
+
+void TypeCache::compact(const std::string& log_name)
+{
+    map_t cur(file);
+    recs_t cur_log;
+    read_log(log_name, cur_log);
+
+    recs_t res;
+    res.reserve(recs.size() + cur_log.size() + (cur.end() - cur.begin()));
+    res.insert(res.end(), recs.begin(), recs.end());
+    res.insert(res.end(), cur_log.begin(), cur_log.end());
+    res.insert(res.end(), cur.begin(), cur.end());
+    std::stable_sort(res.begin(), res.end(), less);
+    res.erase(
+        std::unique(res.begin(), res.end(),
+            [](const rec_t& a, const rec_t& b)
+            { return a.key == b.key; }),
+        res.end());
+
+    std::string name(file);
+    auto tmp_name = name + Sys::format(".tmp.%ld", long(getpid()));
+    auto fd = open(tmp_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+        error("cannot create", tmp_name);
+    head_t head;
+    memcpy(head.magic, magic, sizeof magic);
+    head.n_rec = res.size();
+    auto n = res.size() * sizeof(rec_t);
+    if (write(fd, &head, sizeof head) != ssize_t(sizeof head) ||
+        write(fd, res.data(), n) != ssize_t(n) ||
+        close(fd) < 0) {
+        unlink(tmp_name.c_str());
+        error("cannot write", tmp_name);
+    }
+    if (rename(tmp_name.c_str(), file) < 0) {
+        unlink(tmp_name.c_str());
+        error("cannot rename", tmp_name);
+    }
+    if (unlink(log_name.c_str()) < 0 && errno != ENOENT)
+        error("cannot remove", log_name);
+}
+
+} // namespace Tree
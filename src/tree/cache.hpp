@@ -0,0 +1,179 @@
+// Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+// 
+// This file is part of C++Py-Tree.
+// 
+// C++Py-Tree is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// C++Py-Tree is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __TREE_CACHE_HPP
+#define __TREE_CACHE_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+
+namespace Tree {
+
+// stev: 'TypeCache' is an on-disk cache of the verdicts of the type
+// checks done by extension modules: the exit status of the check and
+// the text it printed -- the type of the object on success, or else
+// the error message; it is keyed by a digest of the input bytes, the
+// identity of the extension module -- which holds the type table --
+// and the args passed to the module -- which include the cast mode;
+// the digest is of 128 bits: two 64-bit hashes of distinct making;
+// the keyed bytes are not stored, thus two keys of equal digests get
+// the same verdict -- with odds of about n^2/2^129 for n keys;
+// the cache is made of two files of fixed-size records: FILE, sorted
+// by key, which is searched in place once mapped in memory, and the
+// journal FILE.log, to which the processes append their records; the
+// journal is merged into FILE only once it grew over 'max_log' records:
+// a new file sorted anew is then renamed over the old one; the files
+// are read and updated holding a lock on a companion '.lock' file;
+// thus concurrent processes see either the old or the new files, and
+// no update gets lost
+
+class TypeCache
+{
+public:
+    struct Error : public std::runtime_error
+    {
+        Error(const std::string& msg);
+    };
+
+    struct key_t
+    {
+        bool operator==(const key_t& k) const
+        { return hash[0] == k.hash[0] && hash[1] == k.hash[1]; }
+        bool operator<(const key_t& k) const
+        { return hash[0] < k.hash[0] || (hash[0] == k.hash[0] && hash[1] < k.hash[1]); }
+
+        uint64_t hash[2];
+    };
+
+    // stev: 'hasher_t' computes the digest of the bytes added:
+    // their 64-bit FNV-1a hash and a rotate-xor-multiply one
+    class hasher_t
+    {
+    public:
+        hasher_t()
+        {
+            key.hash[0] = 14695981039346656037u;
+            key.hash[1] = 11400714819323198485u;
+        }
+
+        void add(const char* str, size_t n);
+        void add(const char* str)
+        { add(str, strlen(str) + 1); }
+
+        key_t result() const
+        { return key; }
+
+    private:
+        key_t key;
+    };
+
+    struct verdict_t
+    {
+        verdict_t() : status(0) {}
+
+        int         status;
+        std::string text;
+    };
+
+    TypeCache(const TypeCache&) = delete;
+    TypeCache& operator=(const TypeCache&) = delete;
+
+    explicit TypeCache(const char* _file);
+    ~TypeCache();
+
+    bool find(const key_t& key, verdict_t& verdict) const;
+
+    // stev: the input of key 'key' is being evaluated; the
+    // verdict recorded meanwhile by the extension module -- if
+    // any -- gets inserted into the cache by 'end'
+    void begin(const key_t& key);
+    void end();
+
+    // stev: called by the extension modules; a no-op unless
+    // an input is being evaluated with a cache in place
+    static void record(int status, const std::string& text);
+
+    // stev: write the verdicts inserted into the cache file
+    void commit();
+
+private:
+    // stev: the cache file is made of a 'head_t' followed by
+    // 'head_t::n_rec' records of type 'rec_t'; the journal is
+    // made of its magic followed by records of type 'rec_t';
+    // the text of verdicts of more than 'max_text' chars is not
+    // cached
+    struct head_t
+    {
+        char     magic[8];
+        uint64_t n_rec;
+    };
+
+    enum { rec_size = 128 };
+
+    struct rec_t
+    {
+        key_t    key;
+        int32_t  status;
+        uint32_t len;
+        char     text[
+            rec_size - sizeof(key_t) - sizeof(int32_t) - sizeof(uint32_t)];
+    };
+
+    enum { max_text = sizeof(rec_t::text) };
+
+    // stev: the number of records of the journal
+    // past which it gets merged into the cache file
+    enum { max_log = 1024 };
+
+    typedef std::vector<rec_t> recs_t;
+
+    class map_t;
+
+    static bool less(const rec_t& a, const rec_t& b)
+    { return a.key < b.key; }
+
+    static const rec_t* lookup(
+        const rec_t* begin, const rec_t* end, const key_t& key);
+
+    static void read_log(const std::string& name, recs_t& recs);
+
+    void insert(const key_t& key, const verdict_t& verdict);
+    void compact(const std::string& log_name);
+
+    const char*            file;
+    std::unique_ptr<map_t> map;
+    // stev: the records of the journal as of the
+    // construction of the cache, sorted by key
+    recs_t                 log;
+    // stev: the records inserted by this process
+    recs_t                 recs;
+    bool                   pending;
+    bool                   recorded;
+    key_t                  pending_key;
+    verdict_t              pending_verdict;
+
+    static thread_local TypeCache* current;
+};
+
+} // namespace Tree
+
+#endif /* __TREE_CACHE_HPP */
@@ -0,0 +1,407 @@
+// Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+// 
+// This file is part of C++Py-Tree.
+// 
+// C++Py-Tree is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// C++Py-Tree is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <getopt.h>
+
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+
+#include "sys.hpp"
+#include "std-ext.hpp"
+#include "serve.hpp"
+
+extern const char program[];
+extern const char verdate[];
+extern const char license[];
+
+const char program[] = "tree-client";
+const char verdate[] = "0.1 -- 2021-05-22 14:14"; // $ date +'%F %R'
+
+const char license[] =
+"Copyright (C) 2016, 2017, 2021  Stefan Vargyas.\n"
+"License GPLv3+: GNU GPL version 3 or later <http://gnu.org/licenses/gpl.html>.\n"
+"This is free software: you are free to change and redistribute it.\n"
+"There is NO WARRANTY, to the extent permitted by law.\n";
+
+namespace Client {
+
+using Tree::Server;
+
+struct Error : public std::runtime_error
+{
+    Error(const std::string& msg) :
+        std::runtime_error(msg)
+    {}
+};
+
+struct options_t
+{
+    options_t() :
+        action(send_action),
+        socket(nullptr),
+        stop(false),
+        requests(0),
+        conns(1)
+    {}
+
+    enum action_t {
+        send_action,
+        encode_action,
+        decode_action,
+    };
+
+    action_t    action;
+    const char* socket;
+    bool        stop;
+    size_t      requests;
+    size_t      conns;
+
+    std::vector<std::string> inputs;
+    std::vector<std::string> args;
+
+    void parse(int argc, char* argv[]);
+};
+
+static void usage()
+{
+    using namespace std;
+    cout
+        << "usage: " << program << " [OPTION]... [INPUT]... [-- ARG...]" << endl
+        << "where the options are:" << endl
+        << "  -s|--socket=SOCKET   send the requests to the 'tree --serve' listening on the Unix socket SOCKET" << endl
+        << "  -e|--encode          write the requests to stdout instead" << endl
+        << "  -d|--decode          read the responses from stdin instead and print them out" << endl
+        << "  -S|--stop            send a request stopping the server instead" << endl
+        << "  -n|--requests=NUM    benchmark the server by sending it NUM requests made of the inputs given," << endl
+        << "                         in turn, printing out the throughput and the latency of the requests;" << endl
+        << "                         a request fails if of nonzero status or if its response differs from" << endl
+        << "                         the one got by sending it prior to the benchmark" << endl
+        << "  -c|--conns=NUM       send the requests of the benchmark over NUM connections (default 1)" << endl
+        << "     --version         print version numbers and exit" << endl
+        << "  -?|--help            display this help info and exit" << endl
+        << "each input makes a request of its own; the arguments after '--' are those of the" << endl
+        << "extension module of 'tree' -- these are the same for all requests" << endl;
+}
+
+static void version()
+{
+    std::cout << program << ": version " << verdate << "\n\n" << license;
+}
+
+static size_t parse_num(const char* opt_name, const char* opt_arg, size_t max)
+{
+    char* end;
+    errno = 0;
+    auto n = strtoul(opt_arg, &end, 10);
+    if (errno || *end || !isdigit(*opt_arg) || n < 1 || n > max)
+        throw Error(Sys::format(
+            "invalid argument for '%s' option: '%s'", opt_name, opt_arg));
+    return n;
+}
+
+void options_t::parse(int argc, char* argv[])
+{
+    static const struct option long_opts[] = {
+        { "socket",   1, nullptr, 's' },
+        { "encode",   0, nullptr, 'e' },
+        { "decode",   0, nullptr, 'd' },
+        { "stop",     0, nullptr, 'S' },
+        { "requests", 1, nullptr, 'n' },
+        { "conns",    1, nullptr, 'c' },
+        { "version",  0, nullptr, 'v' },
+        { "help",     0, nullptr, 'h' },
+        { nullptr,    0, nullptr, 0 }
+    };
+
+    // stev: the arguments after '--' are not ours
+    auto end = std::find_if(argv + 1, argv + argc,
+        [](const char* p) { return strcmp(p, "--") == 0; });
+    if (end != argv + argc)
+        args.assign(end + 1, argv + argc);
+    argc = Ext::ptr_diff(end, argv);
+
+    int opt;
+    opterr = 0;
+    while ((opt = getopt_long(
+        argc, argv, ":s:edSn:c:", long_opts, nullptr)) != EOF) {
+        switch (opt) {
+        case 's':
+            socket = optarg;
+            break;
+        case 'e':
+            action = encode_action;
+            break;
+        case 'd':
+            action = decode_action;
+            break;
+        case 'S':
+            stop = true;
+            break;
+        case 'n':
+            requests = parse_num("requests", optarg, 1u << 30);
+            break;
+        case 'c':
+            conns = parse_num("conns", optarg, 256);
+            break;
+        case 'v':
+            version();
+            exit(0);
+        case ':':
+            throw Error(Sys::format(
+                "argument for option '%s' not found", argv[optind - 1]));
+        case 'h':
+            usage();
+            exit(0);
+        case '?':
+            if (optopt == '?') {
+                usage();
+                exit(0);
+            }
+            throw Error(Sys::format(
+                "invalid command line option '%s'", argv[optind - 1]));
+        default:
+            SYS_UNEXPECT_ERR("opt='%c'", opt);
+        }
+    }
+    inputs.assign(argv + optind, argv + argc);
+
+    if (action == send_action && socket == nullptr)
+        throw Error("no socket given");
+    if (action == decode_action && (stop || requests || !inputs.empty()))
+        throw Error("decoding takes no requests");
+    if (requests && (stop || action != send_action))
+        throw Error("benchmarking needs a socket only");
+    if (!stop && action != decode_action && inputs.empty())
+        throw Error("no input given");
+    if (stop && !inputs.empty())
+        throw Error("stopping the server takes no inputs");
+}
+
+static Server::request_t make_request(
+    const options_t& opts, const std::string& input)
+{
+    Server::request_t req;
+    req.reserve(opts.args.size() + 1);
+    req.push_back(input);
+    req.insert(req.end(), opts.args.begin(), opts.args.end());
+    return req;
+}
+
+static int print_response(const Server::response_t& res)
+{
+    std::cout << res.out << std::flush;
+    std::cerr << res.err << std::flush;
+    return res.status;
+}
+
+// stev: the server might just be starting up: the connection
+// is retried for about two seconds while the socket is missing
+// or there is no server listening on it yet
+
+static int connect(const char* socket)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof addr);
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket) >= sizeof addr.sun_path)
+        throw Error(Sys::format("socket name too long: '%s'", socket));
+    strcpy(addr.sun_path, socket);
+
+    for (size_t k = 0;; k ++) {
+        auto fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+            throw Error(Sys::format("cannot create socket: %s",
+                strerror(errno)));
+        if (::connect(fd, reinterpret_cast<struct sockaddr*>(&addr),
+                sizeof addr) == 0)
+            return fd;
+        auto err = errno;
+        close(fd);
+        if ((err != ENOENT && err != ECONNREFUSED) || k >= 200)
+            throw Error(Sys::format("cannot connect to socket '%s': %s",
+                socket, strerror(err)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+static Server::response_t exchange(int fd, const Server::request_t& req)
+{
+    Server::write_request(fd, req);
+    Server::response_t res;
+    if (!Server::read_response(fd, res))
+        throw Error("connection closed by server");
+    return res;
+}
+
+// stev: as 'tree' does on its inputs, the requests stop
+// at the first one failing, returning its exit status
+
+static int send(const options_t& opts)
+{
+    auto fd = connect(opts.socket);
+    auto r = 0;
+    if (opts.stop)
+        r = print_response(exchange(fd, Server::request_t()));
+    else
+        for (const auto& input : opts.inputs) {
+            auto res = exchange(fd, make_request(opts, input));
+            if ((r = print_response(res)))
+                break;
+        }
+    close(fd);
+    return r;
+}
+
+static int encode(const options_t& opts)
+{
+    if (opts.stop)
+        Server::write_request(1, Server::request_t());
+    else
+        for (const auto& input : opts.inputs)
+            Server::write_request(1, make_request(opts, input));
+    return 0;
+}
+
+static int decode()
+{
+    Server::response_t res;
+    int r = 0;
+    while (Server::read_response(0, res))
+        r = print_response(res);
+    return r;
+}
+
+// stev: the benchmark sends the requests made of the inputs
+// in turn over 'conns' connections, each used by a thread of
+// its own; the latencies are those seen by the client; since
+// the server executes the requests concurrently, a request
+// fails if its response is of nonzero status or differs from
+// the response to the same request sent prior to the benchmark
+// -- thus outputs showing addresses of nodes, as '-T' does for
+// '-o', are bound to fail, for each thread builds its own nodes
+
+static int bench(const options_t& opts)
+{
+    using namespace std::chrono;
+    typedef steady_clock clock_t;
+
+    std::vector<Server::request_t> reqs;
+    for (const auto& input : opts.inputs)
+        reqs.push_back(make_request(opts, input));
+
+    std::vector<int> fds;
+    for (size_t i = 0; i < opts.conns; i ++)
+        fds.push_back(connect(opts.socket));
+
+    std::vector<Server::response_t> refs;
+    for (const auto& req : reqs)
+        refs.push_back(exchange(fds.front(), req));
+
+    std::vector<double> lats(opts.requests);
+    std::vector<size_t> fails(opts.conns);
+    std::vector<std::string> errs(opts.conns);
+    std::vector<std::thread> threads;
+
+    auto start = clock_t::now();
+    for (size_t i = 0; i < opts.conns; i ++) {
+        threads.emplace_back([&, i]() {
+            try {
+                for (size_t k = i; k < opts.requests; k += opts.conns) {
+                    auto beg = clock_t::now();
+                    auto res = exchange(fds[i], reqs[k % reqs.size()]);
+                    lats[k] = duration<double, std::micro>(
+                        clock_t::now() - beg).count();
+                    const auto& ref = refs[k % reqs.size()];
+                    if (res.status ||
+                        res.out != ref.out ||
+                        res.err != ref.err)
+                        fails[i] ++;
+                }
+            }
+            catch (const std::exception& exc) {
+                errs[i] = exc.what();
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    auto secs = duration<double>(clock_t::now() - start).count();
+
+    for (auto fd : fds)
+        close(fd);
+    for (const auto& err : errs) {
+        if (!err.empty())
+            throw Error(err);
+    }
+
+    auto n = lats.size();
+    auto mean = std::accumulate(lats.begin(), lats.end(), 0.0) / n;
+    std::sort(lats.begin(), lats.end());
+    auto fail = std::accumulate(fails.begin(), fails.end(), size_t(0));
+
+    using namespace std;
+    cout
+        << fixed
+        << "requests:   " << n << endl
+        << "conns:      " << opts.conns << endl
+        << "failures:   " << fail << endl
+        << "time:       " << setprecision(3) << secs << " s" << endl
+        << "throughput: " << setprecision(0) << n / secs << " req/s" << endl
+        << "latency:    mean " << setprecision(1) << mean
+        << " us, p50 " << lats[n / 2]
+        << " us, p99 " << lats[n * 99 / 100]
+        << " us" << endl;
+
+    return fail ? 1 : 0;
+}
+
+} // namespace Client
+
+int main(int argc, char* argv[])
+try
+{
+    using namespace Client;
+
+    options_t opts;
+    opts.parse(argc, argv);
+
+    if (opts.action == options_t::encode_action)
+        return encode(opts);
+    if (opts.action == options_t::decode_action)
+        return decode();
+    if (opts.requests)
+        return bench(opts);
+    return send(opts);
+}
+catch (const std::exception& exc) {
+    std::cerr << program << ": error: " << exc.what() << std::endl;
+    return 1;
+}
+
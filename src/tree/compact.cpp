@@ -0,0 +1,267 @@
+// Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+// 
+// This file is part of C++Py-Tree.
+// 
+// C++Py-Tree is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// C++Py-Tree is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cstring>
+
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+#include "sys.hpp"
+#include "compact.hpp"
+
+namespace TreeAST {
+
+// stev: 'CompactBuilder' walks the AST by an explicit work stack
+// -- not by recursion, thus the depth of the trees is bounded only
+// by the memory available --; entering a node appends its slot and
+// pushes the frame closing its subtree followed by its children in
+// reverse order, such that the children are entered in order
+
+class CompactBuilder : private Visitor
+{
+public:
+    typedef CompactTree::index_t index_t;
+
+    CompactBuilder(CompactTree* _tree) :
+        tree(_tree)
+    {}
+
+    void build(const Node* node);
+
+private:
+    // stev: a frame having a null 'node' closes the
+    // subtree of the node of which slot is 'idx'
+    struct frame_t
+    {
+        const Node* node;
+        index_t     idx;
+    };
+
+    void enter(const Node* node);
+
+    void push(const Node* node)
+    { work.push_back(frame_t{node, 0}); }
+
+    template<typename T>
+    void push(const std::pair<size_t, T const* const*>& list);
+
+    void sym(index_t val)
+    { tree->syms.back() = val; }
+
+    index_t intern(const str_t& str);
+
+// > COMPACT_BUILDER_VISITOR_DECL $ grammar -VD
+    void visit(const Literal*);
+    void visit(const ListElem*);
+    void visit(const NodeName*);
+    void visit(const NodeList*);
+    void visit(const ArgName*);
+    void visit(const ArgValue*);
+    void visit(const NodeValue*);
+    void visit(const ListValue*);
+    void visit(const LiteralValue*);
+    void visit(const NodeArg*);
+    void visit(const NodeArgs*);
+    void visit(const ListArgs*);
+    void visit(const LiteralArgs*);
+    void visit(const TreeNode*);
+    void visit(const Tree*);
+// < COMPACT_BUILDER_VISITOR_DECL
+
+    typedef std::unordered_map<std::string, index_t> sym_map_t;
+
+    CompactTree*         tree;
+    sym_map_t            syms;
+    std::vector<frame_t> work;
+};
+
+static const CompactTree::index_t max_index =
+    std::numeric_limits<CompactTree::index_t>::max();
+
+void CompactBuilder::build(const Node* node)
+{
+    push(node);
+    while (!work.empty()) {
+        const auto frame = work.back();
+        work.pop_back();
+        if (frame.node != nullptr)
+            enter(frame.node);
+        else
+            tree->ends[frame.idx] = tree->kinds.size();
+    }
+}
+
+void CompactBuilder::enter(const Node* node)
+{
+    auto n = tree->kinds.size();
+    if (n >= max_index)
+        error("compact tree: too many nodes");
+    tree->kinds.push_back(node->type());
+    tree->syms.push_back(0);
+    tree->ends.push_back(0);
+    work.push_back(frame_t{nullptr, static_cast<index_t>(n)});
+    node->accept(this);
+}
+
+template<typename T>
+void CompactBuilder::push(const std::pair<size_t, T const* const*>& list)
+{
+    auto beg = list.second;
+    auto ptr = beg + list.first;
+    while (ptr != beg)
+        push(*-- ptr);
+}
+
+CompactTree::index_t CompactBuilder::intern(const str_t& str)
+{
+    auto r = syms.emplace(std::string(str.ptr, str.len), 0);
+    if (r.second) {
+        auto n = str.len + 1;
+        if (tree->strs.size() + n >= max_index)
+            error("compact tree: too many symbols");
+        r.first->second = tree->strs.size();
+        tree->strs.insert(tree->strs.end(), str.ptr, str.ptr + n);
+        tree->n_syms ++;
+    }
+    return r.first->second;
+}
+
+// > COMPACT_BUILDER_VISITOR_IMPL $ grammar -VI=CompactBuilder
+void CompactBuilder::visit(const Literal* arg)
+{
+    sym(intern(arg->str));
+}
+
+void CompactBuilder::visit(const ListElem* arg)
+{
+    sym(arg->index);
+    push(arg->node);
+}
+
+void CompactBuilder::visit(const NodeName* arg)
+{
+    sym(intern(arg->ident));
+}
+
+void CompactBuilder::visit(const NodeList* arg)
+{
+    push(arg->elems);
+    push(arg->base);
+}
+
+void CompactBuilder::visit(const ArgName* arg)
+{
+    sym(intern(arg->str));
+}
+
+void CompactBuilder::visit(const ArgValue* arg UNUSED)
+{}
+
+void CompactBuilder::visit(const NodeValue* arg)
+{
+    push(arg->node);
+}
+
+void CompactBuilder::visit(const ListValue* arg)
+{
+    push(arg->list);
+}
+
+void CompactBuilder::visit(const LiteralValue* arg)
+{
+    push(arg->literal);
+}
+
+void CompactBuilder::visit(const NodeArg* arg)
+{
+    push(arg->value);
+    push(arg->name);
+}
+
+void CompactBuilder::visit(const NodeArgs* arg UNUSED)
+{}
+
+void CompactBuilder::visit(const ListArgs* arg)
+{
+    push(arg->list);
+}
+
+void CompactBuilder::visit(const LiteralArgs* arg)
+{
+    push(arg->literal);
+}
+
+void CompactBuilder::visit(const TreeNode* arg)
+{
+    push(arg->args);
+    push(arg->name);
+}
+
+void CompactBuilder::visit(const Tree* arg)
+{
+    push(arg->root);
+}
+// < COMPACT_BUILDER_VISITOR_IMPL
+
+CompactTree::CompactTree(const AST* ast) :
+    n_syms(0)
+{
+    auto root = ast->root_node();
+    if (root == nullptr)
+        error("compact tree: AST has no root node");
+
+    // stev: the number of allocated nodes is an upper
+    // bound of the number of nodes reachable from root
+    auto n = ast->num_node();
+    kinds.reserve(n);
+    syms.reserve(n);
+    ends.reserve(n);
+
+    CompactBuilder(this).build(root);
+
+    kinds.shrink_to_fit();
+    syms.shrink_to_fit();
+    ends.shrink_to_fit();
+    strs.shrink_to_fit();
+}
+
+size_t CompactTree::num_bytes() const
+{
+    return
+        kinds.size() * sizeof(unsigned char) +
+        syms.size() * sizeof(index_t) +
+        ends.size() * sizeof(index_t) +
+        strs.size();
+}
+
+size_t CompactTree::node_t::num_children() const
+{
+    return std::distance(begin(), end());
+}
+
+CompactTree::node_t CompactTree::node_t::child(size_t k) const
+{
+    auto ptr = begin();
+    auto end = this->end();
+    for (; ptr != end && k; ++ ptr, -- k);
+    if (ptr == end)
+        error("compact tree: child index out of range");
+    return *ptr;
+}
+
+} // namespace TreeAST
@@ -0,0 +1,190 @@
+// Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+// 
+// This file is part of C++Py-Tree.
+// 
+// C++Py-Tree is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// C++Py-Tree is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __TREE_COMPACT_HPP
+#define __TREE_COMPACT_HPP
+
+#include <cstdint>
+
+#include <iterator>
+#include <vector>
+
+#include "ast.hpp"
+
+namespace TreeAST {
+
+// stev: 'CompactTree' is a read-only image of a tree AST laid out
+// as a structure of parallel arrays indexed by 32-bit node numbers.
+// The nodes are numbered in DFS pre-order, therefore the first child
+// of node 'k' -- if any -- is node 'k + 1', while the next sibling of
+// node 'k' is node 'ends[k]' (the index one past the subtree of 'k').
+// The strings of 'Literal', 'NodeName' and 'ArgName' nodes are interned
+// into one character pool; 'syms[k]' is the offset of the string of
+// node 'k' in that pool, or, for 'ListElem' nodes, the element index.
+// The image owns its arrays and its pool, thus it does not refer to
+// the AST it was built of and may well outlive that AST.
+
+class CompactTree
+{
+public:
+    typedef uint32_t index_t;
+    typedef AST::node_t::type_t kind_t;
+
+    class node_t;
+    class child_iterator;
+
+    explicit CompactTree(const AST* ast);
+
+    CompactTree(const CompactTree&) = delete;
+    CompactTree& operator=(const CompactTree&) = delete;
+
+    node_t root() const;
+
+    node_t node(index_t idx) const;
+
+    size_t num_node() const { return kinds.size(); }
+    size_t num_sym() const { return n_syms; }
+    size_t num_bytes() const;
+
+private:
+    friend class node_t;
+    friend class child_iterator;
+    friend class CompactBuilder;
+
+    std::vector<unsigned char> kinds;
+    std::vector<index_t>       syms;
+    std::vector<index_t>       ends;
+    std::vector<char>          strs;
+    size_t                     n_syms;
+};
+
+class CompactTree::node_t
+{
+public:
+    kind_t kind() const
+    { return static_cast<kind_t>(tree->kinds[idx]); }
+
+    const char* name() const
+    { return AST::node_t::name(kind()); }
+
+    index_t id() const
+    { return idx; }
+
+    // stev: only for 'Literal', 'NodeName' and 'ArgName' nodes
+    const char* str() const;
+
+    // stev: only for 'ListElem' nodes
+    list_elem_idx_t index() const;
+
+    bool has_children() const
+    { return tree->ends[idx] > idx + 1; }
+
+    size_t num_children() const;
+
+    node_t child(size_t k) const;
+
+    child_iterator begin() const;
+    child_iterator end() const;
+
+    bool operator==(const node_t& v) const
+    { return tree == v.tree && idx == v.idx; }
+    bool operator!=(const node_t& v) const
+    { return tree != v.tree || idx != v.idx; }
+
+private:
+    friend class CompactTree;
+    friend class child_iterator;
+
+    node_t(const CompactTree* _tree, index_t _idx) :
+        tree(_tree),
+        idx(_idx)
+    {}
+
+    const CompactTree* tree;
+    index_t idx;
+};
+
+class CompactTree::child_iterator :
+    public std::iterator<std::forward_iterator_tag, const node_t>
+{
+public:
+    child_iterator& operator++()
+    { idx = tree->ends[idx]; return *this; }
+
+    child_iterator operator++(int)
+    { child_iterator r(*this); ++ *this; return r; }
+
+    bool operator==(const child_iterator& v) const
+    { return idx == v.idx; }
+    bool operator!=(const child_iterator& v) const
+    { return idx != v.idx; }
+
+    node_t operator*() const
+    { return node_t(tree, idx); }
+
+private:
+    friend class node_t;
+
+    child_iterator(const CompactTree* _tree, index_t _idx) :
+        tree(_tree),
+        idx(_idx)
+    {}
+
+    const CompactTree* tree;
+    index_t idx;
+};
+
+inline CompactTree::node_t CompactTree::root() const
+{
+    SYS_ASSERT(!kinds.empty());
+    return node_t(this, 0);
+}
+
+inline CompactTree::node_t CompactTree::node(index_t idx) const
+{
+    SYS_ASSERT(idx < kinds.size());
+    return node_t(this, idx);
+}
+
+inline const char* CompactTree::node_t::str() const
+{
+    SYS_ASSERT(
+        kind() == AST::node_t::Literal ||
+        kind() == AST::node_t::NodeName ||
+        kind() == AST::node_t::ArgName);
+    return tree->strs.data() + tree->syms[idx];
+}
+
+inline list_elem_idx_t CompactTree::node_t::index() const
+{
+    SYS_ASSERT(kind() == AST::node_t::ListElem);
+    return static_cast<list_elem_idx_t>(tree->syms[idx]);
+}
+
+inline CompactTree::child_iterator CompactTree::node_t::begin() const
+{
+    return child_iterator(tree, idx + 1);
+}
+
+inline CompactTree::child_iterator CompactTree::node_t::end() const
+{
+    return child_iterator(tree, tree->ends[idx]);
+}
+
+} // namespace TreeAST
+
+#endif/*__TREE_COMPACT_HPP*/
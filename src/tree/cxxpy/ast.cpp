@@ -59,6 +59,20 @@ AST::AST(
         base_t::node_destr)
 {}
 
+AST::AST(
+#ifdef DEBUG
+    bool _debug,
+#endif
+    const extent_t& ext
+) :
+    base_t(
+#ifdef DEBUG
+        _debug,
+#endif
+        ext,
+        base_t::node_destr)
+{}
+
 AST::~AST()
 {}
 
@@ -184,18 +198,404 @@ void AST::root_node(const Node* node)
     root = node;
 }
 
+class AST::Copier :
+    private Visitor,
+    public  base_t::copier_t<Copier>
+{
+public:
+    typedef base_t::copier_t<Copier> copier_t;
+
+    Copier(AST* _ast) :
+        copier_t(_ast)
+    {}
+
+private:
+    friend class base_t::copier_t<Copier>;
+
+// > COPIER_VISITOR_DECL $ grammar -VD
+    void visit(const Ident*);
+    void visit(const Str*);
+    void visit(const Expr*);
+    void visit(const PrimaryExpr*);
+    void visit(const IdentExpr*);
+    void visit(const StrExpr*);
+    void visit(const ParenExpr*);
+    void visit(const DictExpr*);
+    void visit(const EmptyDictExpr*);
+    void visit(const KeyDatumDictExpr*);
+    void visit(const KeyDatum*);
+    void visit(const KeyDatumList*);
+    void visit(const AttrRef*);
+    void visit(const CallArg*);
+    void visit(const CallArgList*);
+    void visit(const CallExpr*);
+    void visit(const EmptyCallExpr*);
+    void visit(const ArgsCallExpr*);
+    void visit(const OrTest*);
+    void visit(const AndTest*);
+    void visit(const NotTest*);
+    void visit(const Comp*);
+    void visit(const CompExpr*);
+    void visit(const Stmt*);
+    void visit(const SimpleStmt*);
+    void visit(const ExprStmt*);
+    void visit(const AssertStmt*);
+    void visit(const AssertStmt1*);
+    void visit(const AssertStmt2*);
+    void visit(const Target*);
+    void visit(const IdentTarget*);
+    void visit(const AttrRefTarget*);
+    void visit(const TargetList*);
+    void visit(const AssignStmt*);
+    void visit(const DelStmt*);
+    void visit(const ExprList*);
+    void visit(const PrintStmt*);
+    void visit(const SimpleStmtList*);
+    void visit(const StmtList*);
+    void visit(const FileInput*);
+    void visit(const InteractInput*);
+    void visit(const EvalInput*);
+    void visit(const InputInput*);
+// < COPIER_VISITOR_DECL
+};
+
+// > COPIER_VISITOR_IMPL $ grammar -VI=AST::Copier
+void AST::Copier::visit(const Ident* arg)
+{
+    auto ptr = reserve<Ident>();
+    auto ident = copy(arg->ident);
+    make<Ident>(ptr, arg, ident);
+}
+
+void AST::Copier::visit(const Str* arg)
+{
+    auto ptr = reserve<Str>();
+    auto str = copy(arg->str);
+    make<Str>(ptr, arg, str);
+}
+
+void AST::Copier::visit(const Expr* arg)
+{
+    auto ptr = reserve<Expr>();
+    make<Expr>(ptr, arg);
+}
+
+void AST::Copier::visit(const PrimaryExpr* arg)
+{
+    auto ptr = reserve<PrimaryExpr>();
+    make<PrimaryExpr>(ptr, arg);
+}
+
+void AST::Copier::visit(const IdentExpr* arg)
+{
+    auto ptr = reserve<IdentExpr>();
+    auto ident = copy(arg->ident);
+    make<IdentExpr>(ptr, arg, ident);
+}
+
+void AST::Copier::visit(const StrExpr* arg)
+{
+    auto ptr = reserve<StrExpr>();
+    auto str = copy(arg->str);
+    make<StrExpr>(ptr, arg, str);
+}
+
+void AST::Copier::visit(const ParenExpr* arg)
+{
+    auto ptr = reserve<ParenExpr>();
+    auto expr = copy(arg->expr);
+    make<ParenExpr>(ptr, arg, expr);
+}
+
+void AST::Copier::visit(const DictExpr* arg)
+{
+    auto ptr = reserve<DictExpr>();
+    make<DictExpr>(ptr, arg);
+}
+
+void AST::Copier::visit(const EmptyDictExpr* arg)
+{
+    auto ptr = reserve<EmptyDictExpr>();
+    make<EmptyDictExpr>(ptr, arg);
+}
+
+void AST::Copier::visit(const KeyDatumDictExpr* arg)
+{
+    auto ptr = reserve<KeyDatumDictExpr>();
+    auto key_datums = copy(arg->key_datums);
+    make<KeyDatumDictExpr>(ptr, arg, key_datums);
+}
+
+void AST::Copier::visit(const KeyDatum* arg)
+{
+    auto ptr = reserve<KeyDatum>();
+    auto expr1 = copy(arg->expr1);
+    auto expr2 = copy(arg->expr2);
+    make<KeyDatum>(ptr, arg, expr1, expr2);
+}
+
+void AST::Copier::visit(const KeyDatumList* arg)
+{
+    auto ptr = reserve<KeyDatumList>();
+    auto list = copy(arg->list);
+    make<KeyDatumList>(ptr, arg, list);
+}
+
+void AST::Copier::visit(const AttrRef* arg)
+{
+    auto ptr = reserve<AttrRef>();
+    auto expr = copy(arg->expr);
+    auto ident = copy(arg->ident);
+    make<AttrRef>(ptr, arg, expr, ident);
+}
+
+void AST::Copier::visit(const CallArg* arg)
+{
+    auto ptr = reserve<CallArg>();
+    auto expr = copy(arg->expr);
+    make<CallArg>(ptr, arg, expr);
+}
+
+void AST::Copier::visit(const CallArgList* arg)
+{
+    auto ptr = reserve<CallArgList>();
+    auto list = copy(arg->list);
+    make<CallArgList>(ptr, arg, list);
+}
+
+void AST::Copier::visit(const CallExpr* arg)
+{
+    auto ptr = reserve<CallExpr>();
+    make<CallExpr>(ptr, arg);
+}
+
+void AST::Copier::visit(const EmptyCallExpr* arg)
+{
+    auto ptr = reserve<EmptyCallExpr>();
+    auto expr = copy(arg->expr);
+    make<EmptyCallExpr>(ptr, arg, expr);
+}
+
+void AST::Copier::visit(const ArgsCallExpr* arg)
+{
+    auto ptr = reserve<ArgsCallExpr>();
+    auto expr = copy(arg->expr);
+    auto args = copy(arg->args);
+    make<ArgsCallExpr>(ptr, arg, expr, args);
+}
+
+void AST::Copier::visit(const OrTest* arg)
+{
+    auto ptr = reserve<OrTest>();
+    auto expr1 = copy(arg->expr1);
+    auto expr2 = copy(arg->expr2);
+    make<OrTest>(ptr, arg, expr1, expr2);
+}
+
+void AST::Copier::visit(const AndTest* arg)
+{
+    auto ptr = reserve<AndTest>();
+    auto expr1 = copy(arg->expr1);
+    auto expr2 = copy(arg->expr2);
+    make<AndTest>(ptr, arg, expr1, expr2);
+}
+
+void AST::Copier::visit(const NotTest* arg)
+{
+    auto ptr = reserve<NotTest>();
+    auto expr = copy(arg->expr);
+    make<NotTest>(ptr, arg, expr);
+}
+
+void AST::Copier::visit(const Comp* arg)
+{
+    auto ptr = reserve<Comp>();
+    auto prim = copy(arg->prim);
+    make<Comp>(ptr, arg, arg->op, prim);
+}
+
+void AST::Copier::visit(const CompExpr* arg)
+{
+    auto ptr = reserve<CompExpr>();
+    auto prim = copy(arg->prim);
+    auto comps = copy(arg->comps);
+    make<CompExpr>(ptr, arg, prim, comps);
+}
+
+void AST::Copier::visit(const Stmt* arg)
+{
+    auto ptr = reserve<Stmt>();
+    make<Stmt>(ptr, arg);
+}
+
+void AST::Copier::visit(const SimpleStmt* arg)
+{
+    auto ptr = reserve<SimpleStmt>();
+    make<SimpleStmt>(ptr, arg);
+}
+
+void AST::Copier::visit(const ExprStmt* arg)
+{
+    auto ptr = reserve<ExprStmt>();
+    auto expr = copy(arg->expr);
+    make<ExprStmt>(ptr, arg, expr);
+}
+
+void AST::Copier::visit(const AssertStmt* arg)
+{
+    auto ptr = reserve<AssertStmt>();
+    make<AssertStmt>(ptr, arg);
+}
+
+void AST::Copier::visit(const AssertStmt1* arg)
+{
+    auto ptr = reserve<AssertStmt1>();
+    auto expr1 = copy(arg->expr1);
+    make<AssertStmt1>(ptr, arg, expr1);
+}
+
+void AST::Copier::visit(const AssertStmt2* arg)
+{
+    auto ptr = reserve<AssertStmt2>();
+    auto expr1 = copy(arg->expr1);
+    auto expr2 = copy(arg->expr2);
+    make<AssertStmt2>(ptr, arg, expr1, expr2);
+}
+
+void AST::Copier::visit(const Target* arg)
+{
+    auto ptr = reserve<Target>();
+    make<Target>(ptr, arg);
+}
+
+void AST::Copier::visit(const IdentTarget* arg)
+{
+    auto ptr = reserve<IdentTarget>();
+    auto ident = copy(arg->ident);
+    make<IdentTarget>(ptr, arg, ident);
+}
+
+void AST::Copier::visit(const AttrRefTarget* arg)
+{
+    auto ptr = reserve<AttrRefTarget>();
+    auto attr = copy(arg->attr);
+    make<AttrRefTarget>(ptr, arg, attr);
+}
+
+void AST::Copier::visit(const TargetList* arg)
+{
+    auto ptr = reserve<TargetList>();
+    auto list = copy(arg->list);
+    make<TargetList>(ptr, arg, list);
+}
+
+void AST::Copier::visit(const AssignStmt* arg)
+{
+    auto ptr = reserve<AssignStmt>();
+    auto targets = copy(arg->targets);
+    auto expr = copy(arg->expr);
+    make<AssignStmt>(ptr, arg, targets, expr);
+}
+
+void AST::Copier::visit(const DelStmt* arg)
+{
+    auto ptr = reserve<DelStmt>();
+    auto targets = copy(arg->targets);
+    make<DelStmt>(ptr, arg, targets);
+}
+
+void AST::Copier::visit(const ExprList* arg)
+{
+    auto ptr = reserve<ExprList>();
+    auto list = copy(arg->list);
+    make<ExprList>(ptr, arg, list);
+}
+
+void AST::Copier::visit(const PrintStmt* arg)
+{
+    auto ptr = reserve<PrintStmt>();
+    auto exprs = copy(arg->exprs);
+    make<PrintStmt>(ptr, arg, exprs, arg->trail_comma);
+}
+
+void AST::Copier::visit(const SimpleStmtList* arg)
+{
+    auto ptr = reserve<SimpleStmtList>();
+    auto list = copy(arg->list);
+    make<SimpleStmtList>(ptr, arg, list);
+}
+
+void AST::Copier::visit(const StmtList* arg)
+{
+    auto ptr = reserve<StmtList>();
+    auto list = copy(arg->list);
+    make<StmtList>(ptr, arg, list);
+}
+
+void AST::Copier::visit(const FileInput* arg)
+{
+    auto ptr = reserve<FileInput>();
+    auto stmts = copy(arg->stmts);
+    make<FileInput>(ptr, arg, stmts);
+}
+
+void AST::Copier::visit(const InteractInput* arg)
+{
+    auto ptr = reserve<InteractInput>();
+    auto stmts = copy(arg->stmts);
+    make<InteractInput>(ptr, arg, stmts);
+}
+
+void AST::Copier::visit(const EvalInput* arg)
+{
+    auto ptr = reserve<EvalInput>();
+    auto expr = copy(arg->expr);
+    make<EvalInput>(ptr, arg, expr);
+}
+
+void AST::Copier::visit(const InputInput* arg)
+{
+    auto ptr = reserve<InputInput>();
+    auto expr = copy(arg->expr);
+    make<InputInput>(ptr, arg, expr);
+}
+// < COPIER_VISITOR_IMPL
+
+std::unique_ptr<AST> AST::extract(const Node* node) const
+{
+    if (!owns(node))
+        error("invalid node pointer '%p'", node);
+
+    // stev: a first walk over the subgraph computes
+    // the extent of the pools of the new AST and the
+    // second one does the actual copying of the nodes
+    Copier ext(nullptr);
+    ext.copy(node);
+
+    std::unique_ptr<AST> ast(new AST(
+#ifdef DEBUG
+        false,
+#endif
+        ext.extent()));
+    ast->fingerprints(fingerprints());
+    Copier copier(ast.get());
+    ast->root = copier.copy(node);
+
+    return ast;
+}
+
 // > AST_NEW_NODE_IMPL $ grammar -NNI
 const Node* AST::new_node()
 {
     return new_node<Node>();
 }
 
-const Ident* AST::new_ident(const char* ident)
+const Ident* AST::new_ident(const str_t ident)
 {
     return new_node<Ident>(alloc_arg(ident));
 }
 
-const Str* AST::new_str(const char* str)
+const Str* AST::new_str(const str_t str)
 {
     return new_node<Str>(alloc_arg(str));
 }
@@ -23,6 +23,7 @@
 #include <cstddef>
 
 #include <list>
+#include <memory>
 #include <stdexcept>
 #include <utility>
 
@@ -159,7 +160,7 @@ public:
 
     private:
         friend class base_enum_t<node_t>;
-        static const char* names[44];
+        EXT_VISIBLE static const char* names[44];
     };
 
     struct comp_op_t :
@@ -174,7 +175,7 @@ public:
 
     private:
         friend class base_enum_t<comp_op_t>;
-        static const char* names[4];
+        EXT_VISIBLE static const char* names[4];
     };
 
     AST(const AST&) = delete;
@@ -193,12 +194,43 @@ public:
     const Node* root_node() const { return root; }
     void root_node(const Node*);
 
+    // stev: copy the nodes reachable from 'node' into a new
+    // AST having its pools sized to fit, and of which root is
+    // the copy of 'node'; the new AST does not depend on this
+    // one, which thus can be released right away
+    std::unique_ptr<AST> extract(const Node* node) const;
+
     size_t num_node() const { return base_t::num_node(); }
 
+    // stev: release all nodes, keeping the pools for reuse
+    void clear() { base_t::clear(); }
+
+    bool hash_cons() const { return base_t::hash_cons(); }
+    void hash_cons(bool enable) { base_t::hash_cons(enable); }
+
+    ConsTable::stats_t cons_stats() const { return base_t::cons_stats(); }
+
+    mem_stats_t mem_stats() const { return base_t::mem_stats(); }
+
+    bool fingerprints() const { return base_t::fingerprints(); }
+    void fingerprints(bool enable) { base_t::fingerprints(enable); }
+
+    bool fingerprint(const Node* node, fingerprint_t& res) const
+    { return base_t::fingerprint(node, res); }
+
+    template<typename T>
+    using type_range_t = base_t::type_range_t<T>;
+
+    template<typename T>
+    type_range_t<T> nodes_of() const { return base_t::nodes_of<T>(); }
+
+    template<typename T>
+    size_t count() const { return base_t::count<T>(); }
+
 // > AST_NEW_NODE_DECL $ grammar -NND
     const Node* new_node();
-    const Ident* new_ident(const char* ident);
-    const Str* new_str(const char* str);
+    const Ident* new_ident(const str_t ident);
+    const Str* new_str(const str_t str);
     const Expr* new_expr();
     const PrimaryExpr* new_primaryexpr();
     const IdentExpr* new_identexpr(const Ident* ident);
@@ -268,6 +300,16 @@ public:
 private:
     using base_t::new_node;
 
+    typedef base_t::extent_t extent_t;
+
+    AST(
+#ifdef DEBUG
+        bool _debug,
+#endif
+        const extent_t& ext);
+
+    class Copier;
+
     template<typename T>
     typename Arg<root_t, T>::result_t alloc_arg(T arg)
     {
@@ -300,6 +342,9 @@ class Visitor;
 
 typedef Ext::widest_uint_t result_t;
 
+// stev: the 'char*' arguments of 'grammar.g++' are of type
+// 'str_t' below -- see the note in there
+
 // > NODE_CLASSES_DEF $ grammar -NDP
 class Node
 {
@@ -326,13 +371,17 @@ public:
 private:
     friend class BaseAST<Node>;
 
+    // stev: the index of the node in the node pool of its AST;
+    // it precedes 't' such that the derived classes may still
+    // lay out their first small members in the tail padding
+    unsigned n;
     mutable unsigned short t;
 };
 
 class Ident : public Node
 {
 public:
-    Ident(const char* _ident) :
+    Ident(const str_t _ident) :
         ident(_ident)
     {}
 
@@ -341,13 +390,13 @@ public:
     result_t accept(Visitor0*) const;
     void accept(Visitor*) const;
 
-    const char* ident;
+    const str_t ident;
 };
 
 class Str : public Node
 {
 public:
-    Str(const char* _str) :
+    Str(const str_t _str) :
         str(_str)
     {}
 
@@ -356,7 +405,7 @@ public:
     result_t accept(Visitor0*) const;
     void accept(Visitor*) const;
 
-    const char* str;
+    const str_t str;
 };
 
 class Expr : public Node
@@ -1665,7 +1714,7 @@ inline T EvalVisitor<T>::eval(const Node* node)
     return cast_t::cast(node->accept(this));
 }
 
-class Visitor
+class EXT_VISIBLE Visitor
 {
 public:
     virtual ~Visitor();
@@ -69,7 +69,7 @@ AST::AST::comp_op_t::type_t cptr_def_t<AST::AST::comp_op_t::type_t>::cast(
     return Ext::enum_cast<AST::AST::comp_op_t::type_t>(type);
 }
 
-ast_type_t const* const ast_type_t::types[] = {
+static ast_type_t const* const ast_types[] = {
 // > AST_TYPE_CALLS $ grammar -NAC
     ast_type<AST::Node>(),
     ast_type<AST::Ident>(),
@@ -118,8 +118,6 @@ ast_type_t const* const ast_type_t::types[] = {
 // < AST_TYPE_CALLS
 };
 
-const size_t ast_type_t::n_types = Ext::array_size(ast_type_t::types);
-
 // > AST_TYPE_DEFS $ grammar2 -AD
 //
 // ast-type: Node
@@ -772,7 +770,74 @@ template<>
 const size_t ast_def_t<AST::InputInput>::narg = 1;
 // < AST_TYPE_DEFS
 
-const TypeMaker::new_funcs_t TypeMaker::new_funcs[] = {
+// stev: the type name table below is produced by 'tree-phash' out
+// of the names of 'new_funcs' -- taken in their order -- as follows:
+//   $ ./tree-phash $(sed -n '/> AST_TYPEMAKER_NEW_FUNCS/,/< AST_TYPEMAKER_NEW_FUNCS/s/^ *new_funcs_t("\([^"]*\)".*/\1/p' cxxpy/cxxpy.cpp)
+// 'check_type_names' below verifies the tables at compile-time, thus any
+// change of the types of the AST must be followed by rerunning 'tree-phash'
+static constexpr const char* type_names[] = {
+    "AndTest",
+    "ArgsCallExpr",
+    "AssertStmt",
+    "AssertStmt1",
+    "AssertStmt2",
+    "AssignStmt",
+    "AttrRef",
+    "AttrRefTarget",
+    "CallArg",
+    "CallArgList",
+    "CallExpr",
+    "Comp",
+    "CompExpr",
+    "DelStmt",
+    "DictExpr",
+    "EmptyCallExpr",
+    "EmptyDictExpr",
+    "EvalInput",
+    "Expr",
+    "ExprList",
+    "ExprStmt",
+    "FileInput",
+    "Ident",
+    "IdentExpr",
+    "IdentTarget",
+    "InputInput",
+    "InteractInput",
+    "KeyDatum",
+    "KeyDatumDictExpr",
+    "KeyDatumList",
+    "Node",
+    "NotTest",
+    "OrTest",
+    "ParenExpr",
+    "PrimaryExpr",
+    "PrintStmt",
+    "SimpleStmt",
+    "SimpleStmtList",
+    "Stmt",
+    "StmtList",
+    "Str",
+    "StrExpr",
+    "Target",
+    "TargetList",
+    ""
+};
+
+static constexpr type_names_t::slot_t type_slots[] = {
+     0, 44,  4, 25, 39,  6, 29, 13, 44, 44, 44, 22, 44, 43, 30, 44,
+     3,  9, 15, 36, 40, 28, 44,  7, 44, 41, 12, 18, 44, 16, 44, 38,
+    44, 44, 11, 23, 42, 37, 44, 44, 34, 24, 17, 35, 20, 32, 44, 44,
+    33,  8,  2, 10, 14,  5, 44, 31,  1, 44, 27, 44, 26, 21, 19, 44
+};
+
+static constexpr uint32_t type_seed = 1114163469;
+
+static constexpr type_names_t type_names_hash(
+    type_names, type_slots, type_seed);
+
+constexpr type_names_t TypeMaker::type_names = type_names_hash;
+
+constexpr TypeMaker::new_funcs_t TypeMaker::new_funcs[] = {
 // > AST_TYPEMAKER_NEW_FUNCS $ grammar -NAT=16
     new_funcs_t("AndTest",          &TypeMaker::new_node<AST::AndTest>,          &TypeMaker::new_list<AST::AndTest>),
     new_funcs_t("ArgsCallExpr",     &TypeMaker::new_node<AST::ArgsCallExpr>,     &TypeMaker::new_list<AST::ArgsCallExpr>),
@@ -823,10 +888,12 @@ const TypeMaker::new_funcs_t TypeMaker::new_funcs[] = {
 
 const size_t TypeMaker::n_new_func = Ext::array_size(TypeMaker::new_funcs);
 
+CXX_ASSERT(TypeMaker::check_type_names());
+
 // > AST_TYPE_NODE_MAKERS $ grammar2 -AM
 template<>
 obj_value_t NodeMaker::new_node<AST::Node>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::Node>(node, args);
     return node_obj_value(type, ast->new_node());
@@ -834,25 +901,25 @@ obj_value_t NodeMaker::new_node<AST::Node>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::Ident>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::Ident>(node, args);
     return node_obj_value(type, ast->new_ident(
-        cptr_arg<const char*>(0, type, args)));
+        cptr_arg<AST::str_t>(0, type, args)));
 }
 
 template<>
 obj_value_t NodeMaker::new_node<AST::Str>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::Str>(node, args);
     return node_obj_value(type, ast->new_str(
-        cptr_arg<const char*>(0, type, args)));
+        cptr_arg<AST::str_t>(0, type, args)));
 }
 
 template<>
 obj_value_t NodeMaker::new_node<AST::Expr>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::Expr>(node, args);
     return node_obj_value(type, ast->new_expr());
@@ -860,7 +927,7 @@ obj_value_t NodeMaker::new_node<AST::Expr>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::PrimaryExpr>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::PrimaryExpr>(node, args);
     return node_obj_value(type, ast->new_primaryexpr());
@@ -868,7 +935,7 @@ obj_value_t NodeMaker::new_node<AST::PrimaryExpr>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::IdentExpr>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::IdentExpr>(node, args);
     return node_obj_value(type, ast->new_identexpr(
@@ -877,7 +944,7 @@ obj_value_t NodeMaker::new_node<AST::IdentExpr>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::StrExpr>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::StrExpr>(node, args);
     return node_obj_value(type, ast->new_strexpr(
@@ -886,7 +953,7 @@ obj_value_t NodeMaker::new_node<AST::StrExpr>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::ParenExpr>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::ParenExpr>(node, args);
     return node_obj_value(type, ast->new_parenexpr(
@@ -895,7 +962,7 @@ obj_value_t NodeMaker::new_node<AST::ParenExpr>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::DictExpr>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::DictExpr>(node, args);
     return node_obj_value(type, ast->new_dictexpr());
@@ -903,7 +970,7 @@ obj_value_t NodeMaker::new_node<AST::DictExpr>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::EmptyDictExpr>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::EmptyDictExpr>(node, args);
     return node_obj_value(type, ast->new_emptydictexpr());
@@ -911,7 +978,7 @@ obj_value_t NodeMaker::new_node<AST::EmptyDictExpr>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::KeyDatumDictExpr>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::KeyDatumDictExpr>(node, args);
     return node_obj_value(type, ast->new_keydatumdictexpr(
@@ -920,7 +987,7 @@ obj_value_t NodeMaker::new_node<AST::KeyDatumDictExpr>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::KeyDatum>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::KeyDatum>(node, args);
     return node_obj_value(type, ast->new_keydatum(
@@ -930,7 +997,7 @@ obj_value_t NodeMaker::new_node<AST::KeyDatum>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::KeyDatumList>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::KeyDatumList>(node, args);
     return node_obj_value(type, ast->new_keydatumlist(
@@ -939,7 +1006,7 @@ obj_value_t NodeMaker::new_node<AST::KeyDatumList>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::AttrRef>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::AttrRef>(node, args);
     return node_obj_value(type, ast->new_attrref(
@@ -949,7 +1016,7 @@ obj_value_t NodeMaker::new_node<AST::AttrRef>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::CallArg>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::CallArg>(node, args);
     return node_obj_value(type, ast->new_callarg(
@@ -958,7 +1025,7 @@ obj_value_t NodeMaker::new_node<AST::CallArg>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::CallArgList>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::CallArgList>(node, args);
     return node_obj_value(type, ast->new_callarglist(
@@ -967,7 +1034,7 @@ obj_value_t NodeMaker::new_node<AST::CallArgList>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::CallExpr>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::CallExpr>(node, args);
     return node_obj_value(type, ast->new_callexpr());
@@ -975,7 +1042,7 @@ obj_value_t NodeMaker::new_node<AST::CallExpr>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::EmptyCallExpr>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::EmptyCallExpr>(node, args);
     return node_obj_value(type, ast->new_emptycallexpr(
@@ -984,7 +1051,7 @@ obj_value_t NodeMaker::new_node<AST::EmptyCallExpr>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::ArgsCallExpr>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::ArgsCallExpr>(node, args);
     return node_obj_value(type, ast->new_argscallexpr(
@@ -994,7 +1061,7 @@ obj_value_t NodeMaker::new_node<AST::ArgsCallExpr>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::OrTest>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::OrTest>(node, args);
     return node_obj_value(type, ast->new_ortest(
@@ -1004,7 +1071,7 @@ obj_value_t NodeMaker::new_node<AST::OrTest>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::AndTest>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::AndTest>(node, args);
     return node_obj_value(type, ast->new_andtest(
@@ -1014,7 +1081,7 @@ obj_value_t NodeMaker::new_node<AST::AndTest>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::NotTest>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::NotTest>(node, args);
     return node_obj_value(type, ast->new_nottest(
@@ -1023,7 +1090,7 @@ obj_value_t NodeMaker::new_node<AST::NotTest>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::Comp>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::Comp>(node, args);
     return node_obj_value(type, ast->new_comp(
@@ -1033,7 +1100,7 @@ obj_value_t NodeMaker::new_node<AST::Comp>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::CompExpr>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::CompExpr>(node, args);
     return node_obj_value(type, ast->new_compexpr(
@@ -1043,7 +1110,7 @@ obj_value_t NodeMaker::new_node<AST::CompExpr>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::Stmt>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::Stmt>(node, args);
     return node_obj_value(type, ast->new_stmt());
@@ -1051,7 +1118,7 @@ obj_value_t NodeMaker::new_node<AST::Stmt>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::SimpleStmt>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::SimpleStmt>(node, args);
     return node_obj_value(type, ast->new_simplestmt());
@@ -1059,7 +1126,7 @@ obj_value_t NodeMaker::new_node<AST::SimpleStmt>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::ExprStmt>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::ExprStmt>(node, args);
     return node_obj_value(type, ast->new_exprstmt(
@@ -1068,7 +1135,7 @@ obj_value_t NodeMaker::new_node<AST::ExprStmt>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::AssertStmt>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::AssertStmt>(node, args);
     return node_obj_value(type, ast->new_assertstmt());
@@ -1076,7 +1143,7 @@ obj_value_t NodeMaker::new_node<AST::AssertStmt>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::AssertStmt1>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::AssertStmt1>(node, args);
     return node_obj_value(type, ast->new_assertstmt1(
@@ -1085,7 +1152,7 @@ obj_value_t NodeMaker::new_node<AST::AssertStmt1>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::AssertStmt2>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::AssertStmt2>(node, args);
     return node_obj_value(type, ast->new_assertstmt2(
@@ -1095,7 +1162,7 @@ obj_value_t NodeMaker::new_node<AST::AssertStmt2>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::Target>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::Target>(node, args);
     return node_obj_value(type, ast->new_target());
@@ -1103,7 +1170,7 @@ obj_value_t NodeMaker::new_node<AST::Target>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::IdentTarget>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::IdentTarget>(node, args);
     return node_obj_value(type, ast->new_identtarget(
@@ -1112,7 +1179,7 @@ obj_value_t NodeMaker::new_node<AST::IdentTarget>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::AttrRefTarget>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::AttrRefTarget>(node, args);
     return node_obj_value(type, ast->new_attrreftarget(
@@ -1121,7 +1188,7 @@ obj_value_t NodeMaker::new_node<AST::AttrRefTarget>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::TargetList>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::TargetList>(node, args);
     return node_obj_value(type, ast->new_targetlist(
@@ -1130,7 +1197,7 @@ obj_value_t NodeMaker::new_node<AST::TargetList>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::AssignStmt>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::AssignStmt>(node, args);
     return node_obj_value(type, ast->new_assignstmt(
@@ -1140,7 +1207,7 @@ obj_value_t NodeMaker::new_node<AST::AssignStmt>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::DelStmt>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::DelStmt>(node, args);
     return node_obj_value(type, ast->new_delstmt(
@@ -1149,7 +1216,7 @@ obj_value_t NodeMaker::new_node<AST::DelStmt>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::ExprList>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::ExprList>(node, args);
     return node_obj_value(type, ast->new_exprlist(
@@ -1158,7 +1225,7 @@ obj_value_t NodeMaker::new_node<AST::ExprList>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::PrintStmt>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::PrintStmt>(node, args);
     return node_obj_value(type, ast->new_printstmt(
@@ -1168,7 +1235,7 @@ obj_value_t NodeMaker::new_node<AST::PrintStmt>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::SimpleStmtList>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::SimpleStmtList>(node, args);
     return node_obj_value(type, ast->new_simplestmtlist(
@@ -1177,7 +1244,7 @@ obj_value_t NodeMaker::new_node<AST::SimpleStmtList>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::StmtList>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::StmtList>(node, args);
     return node_obj_value(type, ast->new_stmtlist(
@@ -1186,7 +1253,7 @@ obj_value_t NodeMaker::new_node<AST::StmtList>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::FileInput>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::FileInput>(node, args);
     return node_obj_value(type, ast->new_fileinput(
@@ -1195,7 +1262,7 @@ obj_value_t NodeMaker::new_node<AST::FileInput>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::InteractInput>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::InteractInput>(node, args);
     return node_obj_value(type, ast->new_interactinput(
@@ -1204,7 +1271,7 @@ obj_value_t NodeMaker::new_node<AST::InteractInput>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::EvalInput>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::EvalInput>(node, args);
     return node_obj_value(type, ast->new_evalinput(
@@ -1213,7 +1280,7 @@ obj_value_t NodeMaker::new_node<AST::EvalInput>(
 
 template<>
 obj_value_t NodeMaker::new_node<AST::InputInput>(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     auto type = check_node<AST::InputInput>(node, args);
     return node_obj_value(type, ast->new_inputinput(
@@ -1221,7 +1288,9 @@ obj_value_t NodeMaker::new_node<AST::InputInput>(
 }
 // < AST_TYPE_NODE_MAKERS
 
-const NodeMaker::new_funcs_t NodeMaker::new_funcs[] = {
+constexpr type_names_t NodeMaker::type_names = type_names_hash;
+
+constexpr NodeMaker::new_funcs_t NodeMaker::new_funcs[] = {
 // > AST_NODEMAKER_NEW_FUNCS $ grammar -NAN=16
     new_funcs_t("AndTest",          &NodeMaker::new_node<AST::AndTest>,          &NodeMaker::new_list<AST::AndTest>),
     new_funcs_t("ArgsCallExpr",     &NodeMaker::new_node<AST::ArgsCallExpr>,     &NodeMaker::new_list<AST::ArgsCallExpr>),
@@ -1272,13 +1341,21 @@ const NodeMaker::new_funcs_t NodeMaker::new_funcs[] = {
 
 const size_t NodeMaker::n_new_func = Ext::array_size(NodeMaker::new_funcs);
 
+CXX_ASSERT(NodeMaker::check_type_names());
+
 } // namespace Obj
 
 EXT_FUNC_ENTRY
 Sys::ext_func_result_t cxxpy(
     const TreeAST::AST* ast, const Tree::options_t* opts)
 {
-    return ext_func_entry(ast, opts);
+    return ext_func_entry(ast, opts, Obj::ast_types);
+}
+
+EXT_FUNC_ENTRY
+tree_session_t* cxxpy_session_new(unsigned flags)
+{
+    return api_session_new(flags, Obj::ast_types);
 }
 
 
@@ -458,4 +458,11 @@ Sys::ext_func_result_t print(const AST::Node* obj, const Obj::options_t* opt)
     return ext_print_func_entry(obj, opt);
 }
 
+EXT_FUNC_ENTRY
+int cxxpy_print(const void* node, char* buf, size_t size, size_t* len)
+{
+    return ext_print_api_entry(
+        static_cast<const AST::Node*>(node), buf, size, len);
+}
+
 
@@ -18,11 +18,8 @@
 #ifndef __EVAL_IMPL_HPP
 #define __EVAL_IMPL_HPP
 
-#include "sys.hpp"
-#include "eval.hpp"
-#include "opts.hpp"
-
-#include "ext-err-impl.hpp"
+#include "ext-eval-impl.hpp"
+#include "api.hpp"
 
 namespace Obj {
 
@@ -32,26 +29,27 @@ class TypeMaker :
 public:
     typedef BasicMaker<TypeMaker, obj_type_t> base_t;
 
-    TypeMaker(const type_cast_info_t& _info) :
-        base_t(_info)
+    TypeMaker(const type_cast_info_t& _info, diags_t* _diags = nullptr) :
+        base_t(_info, _diags)
     {}
 
 private:
     friend class BasicMaker<TypeMaker, obj_type_t>;
 
     template<typename T>
-    obj_type_t new_node(const TreeAST::TreeNode* node, obj_stack_t& args);
+    obj_type_t new_node(const TreeAST::TreeNode* node, const obj_args_t& args);
 
     template<typename T>
-    obj_type_t new_list(const TreeAST::NodeList* list, obj_stack_t& args);
+    obj_type_t new_list(const TreeAST::NodeList* list, const obj_args_t& args);
 
+    static const type_names_t type_names;
     static const new_funcs_t new_funcs[];
     static const size_t n_new_func;
 };
 
 template<typename T>
 obj_type_t TypeMaker::new_node(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
     check_node<T>(node, args);
     return node_obj_type<T>();
@@ -59,7 +57,7 @@ obj_type_t TypeMaker::new_node(
 
 template<typename T>
 obj_type_t TypeMaker::new_list(
-    const TreeAST::NodeList* list, obj_stack_t& args)
+    const TreeAST::NodeList* list, const obj_args_t& args)
 {
     check_list<T>(list, args);
     return list_obj_type<T>();
@@ -76,64 +74,104 @@ public:
         ast(_ast)
     {}
 
+    // stev: the elements of lists are stored by the evaluator
+    // right into the array of the target AST list object; the
+    // array is of untyped pointers, which 'list_arg' takes for
+    // pointers to the list's element type (see 'node_obj_value')
+    void const** list_values(const TreeAST::NodeList* list)
+    { return list->elems.first ? ast->new_list<const void*>(list->elems.first) : nullptr; }
+
 private:
     friend class BasicMaker<NodeMaker, obj_value_t>;
 
     template<typename T>
-    obj_value_t new_node(const TreeAST::TreeNode* node, obj_stack_t& args);
+    obj_value_t new_node(const TreeAST::TreeNode* node, const obj_args_t& args);
 
     template<typename T>
-    obj_value_t new_list(const TreeAST::NodeList* list, obj_stack_t& args);
+    obj_value_t new_list(const TreeAST::NodeList* list, const obj_args_t& args);
 
     template<typename T>
     static const T* node_arg(
-        size_t k, const ast_type_t* type, obj_stack_t& args);
+        size_t k, const ast_type_t* type, const obj_args_t& args);
 
     template<typename T>
     static const typename std::pair<size_t, T const* const*> list_arg(
-        size_t k, const ast_type_t* type, obj_stack_t& args);
+        size_t k, const ast_type_t* type, const obj_args_t& args);
 
     template<typename T>
     static T cptr_arg(
-        size_t k, const ast_type_t* type, obj_stack_t& args);
+        size_t k, const ast_type_t* type, const obj_args_t& args);
 
     template<typename V>
     struct list_elem_cast_t;
 
     template<typename R, typename V>
-    const R* new_list(size_t n_arg, obj_stack_t& args);
+    const R* new_list(size_t n_arg, const obj_args_t& args);
 
+    static const type_names_t type_names;
     static const new_funcs_t new_funcs[];
     static const size_t n_new_func;
 
     AST::AST* ast;
 };
 
+// stev: the payload of a node object is the address of the node as
+// of its exact type 'T'; 'node_arg' and 'list_arg' below take it for
+// the address of a base class of 'T' -- the static type of the node
+// argument or of the list elements; that holds for the node classes
+// derive singly from 'AST::Node' and from each other, thus have all
+// their base class subobjects at offset zero -- which gets checked
+// on each node made
+
+template<typename T>
+inline obj_value_t node_obj_value(const ast_type_t* ast_type, const T* ptr)
+{
+    CXX_ASSERT((std::is_base_of<AST::Node, T>::value));
+    SYS_ASSERT(
+        static_cast<const void*>(static_cast<const AST::Node*>(ptr)) ==
+        static_cast<const void*>(ptr));
+    return node_obj_value(ast_type, static_cast<const void*>(ptr));
+}
+
 template<typename T>
 inline const T* NodeMaker::node_arg(
-    size_t k, const ast_type_t* type, obj_stack_t& args)
+    size_t k, const ast_type_t* type UNUSED, const obj_args_t& args)
 {
+    SYS_ASSERT(args.size() == type->narg);
     return static_cast<const T*>(
-        args[type->narg - k - 1].value.as<obj_value_t::node_t>().ptr);
+        args[k].value.as<obj_value_t::node_t>().ptr);
 }
 
 template<typename T>
 inline const typename std::pair<size_t, T const* const*> NodeMaker::list_arg(
-    size_t k, const ast_type_t* type, obj_stack_t& args)
+    size_t k, const ast_type_t* type UNUSED, const obj_args_t& args)
 {
+    SYS_ASSERT(args.size() == type->narg);
     typedef T const* const* ptr_t;
     typedef obj_value_t::list_t val_t;
     typedef std::pair<size_t, ptr_t> list_t;
-    auto list = args[type->narg - k - 1].value.as<val_t>();
+    auto list = args[k].value.as<val_t>();
+    // stev: the elements are node payloads: see 'node_obj_value'
     return list_t(list.size, reinterpret_cast<ptr_t>(list.ptr));
 }
 
 template<typename T>
 inline T NodeMaker::cptr_arg(
-    size_t k, const ast_type_t* type, obj_stack_t& args)
+    size_t k, const ast_type_t* type UNUSED, const obj_args_t& args)
 {
+    SYS_ASSERT(args.size() == type->narg);
     return cptr_cast<T>(
-        args[type->narg - k - 1].value.as<obj_value_t::cptr_t>().ptr);
+        args[k].value.as<obj_value_t::cptr_t>().ptr);
+}
+
+// stev: the 'char*' arguments are passed along with their length
+template<>
+inline AST::str_t NodeMaker::cptr_arg<AST::str_t>(
+    size_t k, const ast_type_t* type UNUSED, const obj_args_t& args)
+{
+    SYS_ASSERT(args.size() == type->narg);
+    auto cptr = args[k].value.as<obj_value_t::cptr_t>();
+    return AST::str_t(cptr.ptr, cptr.len);
 }
 
 template<>
@@ -157,76 +195,150 @@ struct NodeMaker::list_elem_cast_t<obj_value_t::cptr_t>
 };
 
 template<typename R, typename V>
-const R* NodeMaker::new_list(size_t n_arg, obj_stack_t& args)
+const R* NodeMaker::new_list(size_t n_arg, const obj_args_t& args)
 {
     if (n_arg == 0)
         return nullptr;
+    SYS_ASSERT(args.size() == n_arg);
     auto ptr = ast->new_list<R>(n_arg);
-    auto end = ptr + n_arg;
-    for (size_t k = n_arg - 1; ptr != end; ++ ptr, -- k)
-        *ptr = list_elem_cast_t<V>::template cast<R>(args[k].value.as<V>());
-    return ptr - n_arg;
+    for (size_t k = 0; k < n_arg; k ++)
+        ptr[k] = list_elem_cast_t<V>::template cast<R>(args[k].value.as<V>());
+    return ptr;
 }
 
+// stev: once the types of the elements of 'list' got checked, the
+// array 'args.values()' is handed over to the target AST as is
+
 template<typename T>
 obj_value_t NodeMaker::new_list(
-    const TreeAST::NodeList* list, obj_stack_t& args)
+    const TreeAST::NodeList* list, const obj_args_t& args)
 {
     auto type = check_list<T>(list, args);
+    if (auto vals = args.values())
+        return list_obj_value(type, list->elems.first, vals);
     return list_obj_value(type, list->elems.first,
         new_list<const void*, obj_value_t::node_t>(list->elems.first, args));
 }
 
-inline type_cast_info_t type_cast_info(const options_t* opt)
+inline void print_cons_stats(const AST::AST& ast, const options_t* opt)
 {
-    return type_cast_info_t(
-        opt->casts_type == options_t::strict_casts);
+    if (opt->hash_cons && opt->verbose)
+        *opt->err
+            << program << ": "
+            << extension << ": hash-cons: "
+            << ast.cons_stats() << std::endl;
 }
 
-inline eval_opts_t eval_opts(const options_t* opt)
+inline void print_mem_stats(const AST::AST& ast, const options_t* opt)
 {
-    return eval_opts_t (
-        opt->trace_eval,
-        opt->verbose);
+    if (opt->mem_stats)
+        ast.mem_stats().print(*opt->err,
+            std::string(program)
+                .append(": ")
+                .append(extension)
+                .append(": mem-stats: ")
+                .c_str());
 }
 
-inline print_info_t print_info(const options_t* opt)
+inline void print_fingerprint(const AST::AST& ast, const obj_value_t& obj,
+    const options_t* opt)
 {
-    return print_info_t(
-        opt->verbose);
+    if (!opt->fingerprint || !obj.is<obj_value_t::node_t>())
+        return;
+    AST::fingerprint_t f;
+    ast.fingerprint(static_cast<const AST::Node*>(
+        obj.as<obj_value_t::node_t>().ptr), f);
+    *opt->err
+        << program << ": "
+        << extension << ": fingerprint: "
+        << f << std::endl;
 }
 
-template<typename T>
-static Sys::ext_func_result_t exec(
-    const TreeAST::Tree* tree, const options_t* opt);
+// stev: copy the subgraph reachable from the node 'obj' refers
+// to -- if that's the case -- into a new AST owned by 'res'; 'obj'
+// is updated to refer to the copy of its node; return the AST which
+// 'obj' refers into thereafter
 
-template<>
-inline Sys::ext_func_result_t exec<Obj::TypeMaker>(
-    const TreeAST::Tree* tree, const options_t* opt)
+inline const AST::AST& extract_node(const AST::AST& ast,
+    std::unique_ptr<AST::AST>& res, obj_value_t& obj, const options_t* opt)
+{
+    if (!opt->extract || !obj.is<obj_value_t::node_t>())
+        return ast;
+    res = ast.extract(static_cast<const AST::Node*>(
+        obj.as<obj_value_t::node_t>().ptr));
+    obj = obj_value_t(
+        obj.as<obj_type_t::node_t>(),
+        obj_values_t::make_node(res->root_node()));
+    return *res;
+}
+
+// stev: 'type_session_t' and 'node_session_t' own the maker, the
+// evaluator and -- in case of the latter -- the target AST used for
+// evaluating all the trees the extension gets to see; only the state
+// of these is reset from one tree to the next, such that no setup
+// allocations are done per tree
+
+class node_session_t
 {
-    TypeMaker maker(type_cast_info(opt));
-    auto obj = eval<obj_type_t>(tree, &maker, eval_opts(opt));
+public:
+    explicit node_session_t(const options_t* opt) :
+        ast(
+#ifdef DEBUG
+            opt->debug
+#endif
+        ),
+        maker(&ast, type_cast_info(opt)),
+        session(&maker)
+    {
+        ast.hash_cons(opt->hash_cons);
+        ast.fingerprints(opt->fingerprint);
+    }
+
+    // stev: the nodes built out of the previous tree are released
+    obj_value_t eval(const TreeAST::Tree* tree, const eval_opts_t& opt)
+    { ast.clear(); return session.eval(tree, opt); }
+
+    const AST::AST& target() const
+    { return ast; }
+
+    // stev: one session per combination of the options the
+    // session depends on, for the requests of 'tree --serve'
+    // may each ask for another combination, and per thread
+    static node_session_t& instance(const options_t* opt)
+    {
+        static thread_local std::unique_ptr<node_session_t> sessions[8];
+        auto& session = sessions[
+            (opt->casts_type == options_t::strict_casts) |
+            (opt->hash_cons << 1) |
+            (opt->fingerprint << 2)];
+        if (!session)
+            session.reset(new node_session_t(opt));
+        return *session;
+    }
 
-    std::cout << print(obj, print_info(opt)) << std::endl;
+private:
+    AST::AST                    ast;
+    NodeMaker                   maker;
+    eval_session_t<obj_value_t> session;
+};
 
-    return 0;
-}
+template<typename T>
+static Sys::ext_func_result_t exec(
+    const TreeAST::AST* tree_ast, const TreeAST::Tree* tree, const options_t* opt);
 
 template<>
 inline Sys::ext_func_result_t exec<Obj::NodeMaker>(
-    const TreeAST::Tree* tree, const options_t* opt)
+    const TreeAST::AST* tree_ast, const TreeAST::Tree* tree, const options_t* opt)
 {
-    using AST::AST;
+    auto& session = node_session_t::instance(opt);
+    auto obj = session.eval(tree, eval_opts(tree_ast, opt));
+    print_cons_stats(session.target(), opt);
+    std::unique_ptr<AST::AST> copy;
+    auto& ast = extract_node(session.target(), copy, obj, opt);
+    print_mem_stats(ast, opt);
+    print_fingerprint(ast, obj, opt);
 
-    AST ast(
-#ifdef DEBUG
-        opt->debug
-#endif
-    );
-    NodeMaker maker(&ast, type_cast_info(opt));
-    auto obj = eval<obj_value_t>(tree, &maker, eval_opts(opt));
-
-    std::cout << print(obj, print_info(opt)) << std::endl;
+    *opt->out << print(obj, print_info(opt)) << std::endl;
 
     return 0;
 }
@@ -236,73 +348,134 @@ struct run_ext_t
 
 template<>
 inline Sys::ext_func_result_t exec<run_ext_t>(
-    const TreeAST::Tree* tree, const options_t* opt)
+    const TreeAST::AST* tree_ast, const TreeAST::Tree* tree, const options_t* opt)
 {
     using AST::Node;
-    using AST::AST;
 
-    AST ast(
-#ifdef DEBUG
-        opt->debug
-#endif
-    );
-    NodeMaker maker(&ast, type_cast_info(opt));
-    auto obj = eval<obj_value_t>(tree, &maker, eval_opts(opt));
+    auto& session = node_session_t::instance(opt);
+    auto obj = session.eval(tree, eval_opts(tree_ast, opt));
+    print_cons_stats(session.target(), opt);
+    std::unique_ptr<AST::AST> copy;
+    auto& ast = extract_node(session.target(), copy, obj, opt);
+    print_mem_stats(ast, opt);
+    print_fingerprint(ast, obj, opt);
 
     return Sys::run_ext_func(
         static_cast<const Node*>(obj.as<obj_value_t::node_t>().ptr), opt);
 }
 
-} // namespace Obj
+// stev: 'api_session_t' is the 'Api::session_t' of the type lib
+// whose AST types are 'types'; unlike 'type_session_t' and the like,
+// it owns all of its state and depends on no options but 'flags';
+// the table of AST types is of thread scope -- thus it gets installed
+// on each call, for sessions of different type libs may be used in
+// turn by the same thread
 
-namespace ExtErr {
+template<size_t N>
+class api_session_t : public Api::session_t
+{
+public:
+    typedef ast_type_t const* const types_t[N];
 
-enum {
-    invalid_root_node_type = no_input_given + 1,
-};
+    api_session_t(const types_t& _types, unsigned flags) :
+        types(_types),
+        verbose(flags & TREE_VERBOSE),
+        ast(
+#ifdef DEBUG
+            false
+#endif
+        ),
+        type_maker(cast_info(flags)),
+        node_maker(&ast, cast_info(flags)),
+        type_session(&type_maker),
+        node_session(&node_maker)
+    {
+        ast.hash_cons(flags & TREE_HASH_CONS);
+        ast.fingerprints(flags & TREE_FINGERPRINTS);
+    }
 
-template<size_t E>
-void print_error(const TreeAST::Node* node);
+    void type_check(const TreeAST::AST* tree_ast, std::ostream& ost)
+    try {
+        auto obj = type_session.eval(tree(tree_ast), eval_opts(tree_ast));
+        ost << print(obj, print_info_t(verbose));
+    }
+    catch (const ObjError& err) {
+        throw Api::Error(err.what());
+    }
 
-template<>
-inline void print_error<invalid_root_node_type>(const TreeAST::Node* node)
-{ print_error("invalid root node type: %s", node->name()); }
+    const void* build(const TreeAST::AST* tree_ast, std::ostream* ost)
+    try {
+        ast.clear();
+        obj_value_t obj = node_session.eval(tree(tree_ast), eval_opts(tree_ast));
+        if (ost != nullptr)
+            *ost << print(obj, print_info_t(verbose));
+        return obj.is<obj_value_t::node_t>()
+            ? obj.as<obj_value_t::node_t>().ptr
+            : nullptr;
+    }
+    catch (const ObjError& err) {
+        throw Api::Error(err.what());
+    }
 
-} // namespace ExtErr
+private:
+    static type_cast_info_t cast_info(unsigned flags)
+    { return type_cast_info_t(!(flags & TREE_RELAXED_CASTS)); }
+
+    const TreeAST::Tree* tree(const TreeAST::AST* tree_ast)
+    {
+        ast_type_t::set_types(types, N);
+        auto tree = TreeAST::node_cast<TreeAST::Tree>(tree_ast->root_node());
+        if (tree == nullptr)
+            throw Api::Error("invalid root node");
+        return tree;
+    }
+
+    eval_opts_t eval_opts(const TreeAST::AST* tree_ast) const
+    {
+        using namespace TreeAST;
+
+        return eval_opts_t(
+            false,
+            verbose,
+            tree_ast->count<TreeNode>() +
+            tree_ast->count<NodeList>() +
+            tree_ast->count<Literal>());
+    }
+
+    const types_t&              types;
+    const bool                  verbose;
+    AST::AST                    ast;
+    TypeMaker                   type_maker;
+    NodeMaker                   node_maker;
+    eval_session_t<obj_type_t>  type_session;
+    eval_session_t<obj_value_t> node_session;
+};
 
+} // namespace Obj
+
+template<size_t N>
+static inline Api::session_t* api_session_new(
+    unsigned flags, Obj::ast_type_t const* const (&types)[N])
+{ return new Obj::api_session_t<N>(types, flags); }
+
+template<size_t N>
 static inline Sys::ext_func_result_t ext_func_entry(
-    const TreeAST::AST* ast, const Tree::options_t* opts)
+    const TreeAST::AST* ast, const Tree::options_t* opts,
+    Obj::ast_type_t const* const (&types)[N])
 {
     using namespace Obj;
 
-    auto opt = options_t::options(opts);
-
-    if (opt->action == options_t::print_types_action) {
-        ast_type_t::print_types(std::cout);
-        return 0;
-    }
-    if (ast == nullptr || opts->argc == 0) {
-        using namespace ExtErr;
-        print_error<no_input_given>();
-        return 1;
-    }
-
-    auto tree = TreeAST::node_cast<TreeAST::Tree>(ast->root_node());
-    if (tree == nullptr) {
-        using namespace ExtErr;
-        print_error<invalid_root_node_type>(ast->root_node());
-        return 1;
-    }
+    ast_type_t::set_types(types, N);
 
-    static Sys::ext_func_result_t (*const funcs[4])(
-        const TreeAST::Tree*, const Obj::options_t*) = {
-        &exec<run_ext_t>, // options_t::ext_func_action
-        &exec<TypeMaker>, // options_t::type_check_action
-        &exec<NodeMaker>, // options_t::ast_build_action
-        &exec<run_ext_t>, // options_t::print_obj_action
+    static const exec_func_t funcs[] = {
+        &exec<run_ext_t>,             // options_t::ext_func_action
+        &exec_type_check<TypeMaker>,  // options_t::type_check_action
+        &exec_validate<TypeMaker>,    // options_t::validate_action
+        &exec<NodeMaker>,             // options_t::ast_build_action
+        &exec<run_ext_t>,             // options_t::print_obj_action
     };
-    return Ext::array(funcs)[
-        opt->action - options_t::ext_func_action](tree, opt);
+    return ext_func_dispatch(
+        ast, opts, options_t::options(opts), funcs);
 }
 
 #endif /* __EVAL_IMPL_HPP */
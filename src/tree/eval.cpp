@@ -16,13 +16,20 @@
 // along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <cctype>
+#include <cerrno>
 #include <cstring>
 
-#include <deque>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <vector>
+#include <unordered_map>
 #include <functional>
 #include <algorithm>
 
 #include <sstream>
+#include <fstream>
 
 #include "ast.hpp"
 #include "eval.hpp"
@@ -53,8 +60,15 @@ void error(const char* msg, ...)
 
 static const char stack_name[] = "AST expression stack";
 
+// stev: 'Evaluator' walks the tree AST without recursion: the
+// nodes still to be evaluated and the actions to be taken after
+// the evaluation of the children of a node -- i.e. the calls to
+// the 'ObjMaker' callbacks -- are kept as frames on an explicit
+// work stack; thus the depth of the evaluated trees is limited
+// only by the available heap memory
+
 template<typename T>
-class Evaluator : private AST::Visitor
+class Evaluator
 {
 public:
     typedef T val_t;
@@ -63,163 +77,113 @@ public:
 
     Evaluator(obj_maker_t* _maker, const eval_opts_t& _opt) :
         maker(_maker),
-        opt(_opt)
+        opt(_opt),
+        n_node(0)
     {}
 
     val_t eval(const AST::Tree* tree);
 
+    val_t eval(const AST::Tree* tree, const eval_opts_t& _opt)
+    { opt = _opt; return eval(tree); }
+
 private:
     void not_yet_impl(const char* func);
 
     template<typename V>
-    void dump(const char* where, const V&) const;
+    void trace(trace_t::event_t event, size_t num, const V& val) const;
 
     void eval(const AST::Node* node);
-    template<typename L, typename E, typename V, const V* E::*mem>
-    void eval(const L* list);
 
     void abstract(const AST::Node* node);
     void unexpected(const AST::Node* node);
 
-    void visit(const AST::Node*); //!!!???
-// > EVALUATOR_VISITOR_DECL $ grammar -aVD
-    void visit(const AST::Literal*);
-    void visit(const AST::ListElem*);
-    void visit(const AST::NodeName*);
-    void visit(const AST::NodeList*);
+    void visit(const AST::Literal*, size_t num);
+    void visit(const AST::NodeList*, size_t num, void const** vals);
     void visit(const AST::ArgName*);
-    void visit(const AST::ArgValue*);
-    void visit(const AST::NodeValue*);
-    void visit(const AST::ListValue*);
-    void visit(const AST::LiteralValue*);
-    void visit(const AST::NodeArg*);
-    void visit(const AST::NodeArgs*);
-    void visit(const AST::ListArgs*);
-    void visit(const AST::LiteralArgs*);
-    void visit(const AST::TreeNode*);
-    void visit(const AST::Tree*);
-// < EVALUATOR_VISITOR_DECL
-
-    struct obj_stack_t :
-        public Obj::obj_stack_t<val_t>,
-        private std::deque<obj_t>
-    {
-        typedef std::deque<obj_t> base_t;
-
-        obj_stack_t() {}
-
-        void check_not_empty() const;
-        void check_range(size_t k) const;
-        void check_size(size_t n) const;
+    void visit(const AST::TreeNode*, size_t num);
 
-        bool empty() const { return base_t::empty(); }
-        size_t size() const { return base_t::size(); }
-
-        const obj_t& operator[](size_t k) const;
-
-        obj_t& top();
-        const obj_t& top() const;
-
-        void pop(size_t n);
-
-        void push(const obj_t& obj);
+    struct frame_t
+    {
+        enum type_t {
+            eval_node,  // evaluate 'node'
+            eval_elems, // evaluate the elements of the list 'node' from 'index' on
+            eval_args,  // evaluate the arguments of the list 'node' from 'index' on
+            make_node,  // make the object of the tree node 'node'
+        };
+
+        frame_t(
+            type_t _type, const AST::Node* _node, size_t _index = 0,
+            void const** _vals = nullptr, size_t _num = 0) :
+            type(_type),
+            num(_num),
+            node(_node),
+            index(_index),
+            vals(_vals)
+        {}
+
+        type_t           type;
+        uint32_t         num;   // the pre-order number of 'node' for the trace
+        const AST::Node* node;
+        size_t           index;
+        void const**     vals;  // the 'list_values' array of 'eval_elems'
     };
 
-    obj_maker_t *maker;
-    obj_stack_t  stack;
-    eval_opts_t  opt;
-};
-
-struct where_print_t
-{
-    where_print_t(const char* _where) :
-        where(_where)
-    {}
-    void print(std::ostream&) const;
-    const char* where;
-};
+    typedef std::vector<frame_t> work_stack_t;
 
-void where_print_t::print(std::ostream&) const
-{
-    using namespace std;
-    static const char visit[] = "::visit(";
-    auto end = where + strlen(where);
-    auto ptr = search(where, end, visit, visit + 8);
-    auto ptr2 = find_if(ptr, end, [](char c) { return c == ')'; });
-    if (ptr != end)
-        copy(
-            ptr != end ? ptr + 2 : where,
-            ptr2 != end ? ptr2 + 1 : end,
-            ostream_iterator<char>(cout));
-    else
-        cout << where;
-}
+    void push(
+        typename frame_t::type_t type, const AST::Node* node, size_t index = 0,
+        void const** vals = nullptr, size_t num = 0)
+    { work.push_back(frame_t(type, node, index, vals, num)); }
 
-static inline where_print_t where_print(const char* where)
-{ return where_print_t(where); }
+    void step(const frame_t& frame);
+    void step_node(const AST::Node* node, size_t num);
+    void step_elems(
+        const AST::NodeList* list, size_t num, size_t k, void const** vals);
+    void step_args(const AST::ListArgs* args, size_t k);
 
-static std::ostream& operator<<(std::ostream& ost, const where_print_t& obj)
-{ obj.print(ost); return ost; }
+    typedef Obj::obj_args_t<val_t> obj_args_t;
 
-template<typename T>
-inline void Evaluator<T>::obj_stack_t::check_not_empty() const
-{
-    if (empty())
-        error("%s is empty", stack_name);
-}
+    // stev: the stack grows at the back of a vector; the
+    // checks below are compiled in only by DEBUG builds
+    struct obj_stack_t : private std::vector<obj_t>
+    {
+        typedef std::vector<obj_t> base_t;
 
-template<typename T>
-inline void Evaluator<T>::obj_stack_t::check_range(size_t k) const
-{
-    if (k >= size())
-        error("%s index '%zu' out of range", stack_name, k);
-}
+        obj_stack_t() {}
 
-template<typename T>
-inline void Evaluator<T>::obj_stack_t::check_size(size_t n) const
-{
-    if (n <= 0 || n > size())
-        error("%s size '%zu' out of range", stack_name, n);
-}
+        using base_t::empty;
+        using base_t::size;
+        using base_t::reserve;
+        using base_t::clear;
 
-template<typename T>
-typename Evaluator<T>::obj_t& Evaluator<T>::obj_stack_t::top()
-{
-    check_not_empty();
-    return base_t::front();
-}
+        obj_t& top()
+        { SYS_ASSERT(!empty()); return base_t::back(); }
 
-template<typename T>
-const typename Evaluator<T>::obj_t& Evaluator<T>::obj_stack_t::top() const
-{
-    check_not_empty();
-    return base_t::front();
-}
+        obj_args_t top(size_t n, void const* const* vals = nullptr) const
+        { SYS_ASSERT(n <= size()); return obj_args_t(base_t::data() + size() - n, n, vals); }
 
-template<typename T>
-const typename Evaluator<T>::obj_t& Evaluator<T>::obj_stack_t::operator[](size_t k) const
-{
-    check_range(k);
-    return base_t::at(k);
-}
+        void pop(size_t n)
+        { SYS_ASSERT(n <= size()); base_t::erase(base_t::end() - n, base_t::end()); }
 
-template<typename T>
-void Evaluator<T>::obj_stack_t::pop(size_t n)
-{
-    check_size(n);
-    auto beg = base_t::begin();
-    base_t::erase(beg, beg + n);
-}
+        void push(const obj_t& obj)
+        { base_t::push_back(obj); }
+    };
 
-template<typename T>
-void Evaluator<T>::obj_stack_t::push(const obj_t& obj)
-{
-    base_t::push_front(obj);
-}
+    obj_maker_t *maker;
+    obj_stack_t  stack;
+    work_stack_t work;
+    eval_opts_t  opt;
+    size_t       n_node;
+};
 
 template<typename T>
 typename Evaluator<T>::val_t Evaluator<T>::eval(const AST::Tree* tree)
 {
+    // stev: a previous evaluation may have thrown midway
+    stack.clear();
+    work.clear();
+    n_node = 0;
+    stack.reserve(opt.n_obj);
     eval(static_cast<const AST::Node*>(tree));
     if (stack.size() != 1)
         error("invalid %s: size is %zu", stack_name, stack.size());
@@ -229,21 +193,6 @@ typename Evaluator<T>::val_t Evaluator<T>::eval(const AST::Tree* tree)
     return top.value;
 }
 
-template<typename T>
-template<typename L, typename E, typename V, const V* E::*mem>
-void Evaluator<T>::eval(const L* list)
-{
-    size_t k = 0;
-    auto ptr = list->elems.second;
-    auto end = ptr + list->elems.first;
-    for (; ptr != end; ++ ptr, ++ k) { //!!! use std::for_each
-        auto elem = *ptr;
-        if (elem->index != k)
-            error("invalid list index '%u' -- expected '%zu'", elem->index, k);
-        eval(elem->*mem);
-    }
-}
-
 template<typename T>
 void Evaluator<T>::not_yet_impl(const char* func)
 {
@@ -251,9 +200,15 @@ void Evaluator<T>::not_yet_impl(const char* func)
 }
 
 template<typename T>
-inline void Evaluator<T>::eval(const AST::Node* node)
+void Evaluator<T>::eval(const AST::Node* node)
 {
-    node->accept(this);
+    const auto base = work.size();
+    push(frame_t::eval_node, node);
+    while (work.size() > base) {
+        const auto frame = work.back();
+        work.pop_back();
+        step(frame);
+    }
 }
 
 template<typename T>
@@ -269,51 +224,146 @@ void Evaluator<T>::unexpected(const AST::Node* node)
 }
 
 template<typename T>
-void Evaluator<T>::visit(const AST::Node* arg) //!!!???
+inline void Evaluator<T>::step(const frame_t& frame)
 {
-    abstract(arg);
+    switch (frame.type) {
+    case frame_t::eval_node:
+        step_node(frame.node, n_node ++);
+        break;
+    case frame_t::eval_elems:
+        step_elems(
+            static_cast<const AST::NodeList*>(frame.node),
+            frame.num, frame.index, frame.vals);
+        break;
+    case frame_t::eval_args:
+        step_args(
+            static_cast<const AST::ListArgs*>(frame.node),
+            frame.index);
+        break;
+    case frame_t::make_node:
+        visit(static_cast<const AST::TreeNode*>(frame.node), frame.num);
+        break;
+    default:
+        SYS_UNEXPECT_ERR("frame type=%d", frame.type);
+    }
 }
 
-// stev: TODO: the grammar shell function is not allowing a classname to include
-//             template parameters as bellow; maybe it should define a new command
-//             line option allowing to specify 'T' as an argument and then generating
-//             properly something like: 'template<typename T> ... class-name<T>::...'.
-//!!! // > EVALUATOR_VISITOR_IMPL $ grammar -aVI=Evaluator<T>
+// stev: the frames are pushed onto the work stack in reverse
+// order of their evaluation; e.g. 'NodeArg' evaluates first its
+// value and only then its name, the latter attaching the name to
+// the object the former left on top of the object stack
 
-// > EVALUATOR_VISITOR_IMPL $ grammar -aVI=Evaluator
 template<typename T>
-void Evaluator<T>::visit(const AST::Literal* arg)
+void Evaluator<T>::step_node(const AST::Node* node, size_t num)
 {
-    obj_t obj = maker->make_cptr(arg);
-    if (opt.trace_eval)
-        dump(__PRETTY_FUNCTION__, obj.value);
-    stack.push(obj);
+    typedef AST::AST::node_t node_t;
+
+    switch (node->type()) {
+    case node_t::Literal:
+        visit(static_cast<const AST::Literal*>(node), num);
+        break;
+    case node_t::NodeList:
+        push(frame_t::eval_elems, node, 0, nullptr, num);
+        break;
+    case node_t::ArgName:
+        visit(static_cast<const AST::ArgName*>(node));
+        break;
+    case node_t::NodeValue:
+        push(frame_t::eval_node,
+            static_cast<const AST::NodeValue*>(node)->node);
+        break;
+    case node_t::ListValue:
+        push(frame_t::eval_node,
+            static_cast<const AST::ListValue*>(node)->list);
+        break;
+    case node_t::LiteralValue:
+        push(frame_t::eval_node,
+            static_cast<const AST::LiteralValue*>(node)->literal);
+        break;
+    case node_t::NodeArg: {
+        auto arg = static_cast<const AST::NodeArg*>(node);
+        push(frame_t::eval_node, arg->name);
+        push(frame_t::eval_node, arg->value);
+        break;
+    }
+    case node_t::ListArgs:
+        push(frame_t::eval_args, node);
+        break;
+    case node_t::LiteralArgs:
+        push(frame_t::eval_node,
+            static_cast<const AST::LiteralArgs*>(node)->literal);
+        break;
+    case node_t::TreeNode:
+        push(frame_t::make_node, node, 0, nullptr, num);
+        push(frame_t::eval_node,
+            static_cast<const AST::TreeNode*>(node)->args);
+        break;
+    case node_t::Tree:
+        push(frame_t::eval_node,
+            static_cast<const AST::Tree*>(node)->root);
+        break;
+    case node_t::ListElem:
+    case node_t::NodeName:
+        unexpected(node);
+        break;
+    default:
+        abstract(node);
+    }
 }
 
+static inline const void* obj_payload(const obj_value_t& obj)
+{ return obj.payload(); }
+
+static inline const void* obj_payload(const obj_type_t&)
+{ SYS_UNEXPECT_ERR("type objects have no payload"); }
+
+// stev: the element of index 'k - 1' -- if any -- is on top of the
+// stack by now; its payload gets stored into the 'vals' array -- if
+// the maker provided one -- for 'make_list' to take it over as is
+
 template<typename T>
-void Evaluator<T>::visit(const AST::ListElem* arg)
+void Evaluator<T>::step_elems(
+    const AST::NodeList* list, size_t num, size_t k, void const** vals)
 {
-    unexpected(arg);
+    if (k > 0 && vals != nullptr)
+        vals[k - 1] = obj_payload(stack.top().value);
+    if (k >= list->elems.first) {
+        visit(list, num, vals);
+        return;
+    }
+    if (k == 0)
+        vals = maker->list_values(list);
+    auto elem = list->elems.second[k];
+    if (elem->index != k)
+        error("invalid list index '%u' -- expected '%zu'", elem->index, k);
+    push(frame_t::eval_elems, list, k + 1, vals, num);
+    push(frame_t::eval_node, elem->node);
 }
 
 template<typename T>
-void Evaluator<T>::visit(const AST::NodeName* arg)
+void Evaluator<T>::step_args(const AST::ListArgs* args, size_t k)
 {
-    unexpected(arg);
+    if (k >= args->list.first)
+        return;
+    push(frame_t::eval_args, args, k + 1);
+    push(frame_t::eval_node, args->list.second[k]);
 }
 
 template<typename T>
-void Evaluator<T>::visit(const AST::NodeList* arg)
-{
-    eval<
-        AST::NodeList,
-        AST::ListElem,
-        AST::TreeNode,
-        &AST::ListElem::node>(
-        arg);
-    obj_t obj = maker->make_list(arg, stack);
-    if (opt.trace_eval)
-        dump(__PRETTY_FUNCTION__, obj.value);
+void Evaluator<T>::visit(const AST::Literal* arg, size_t num)
+{
+    obj_t obj = maker->make_cptr(arg);
+    trace(trace_t::visit_literal, num, obj.value);
+    stack.push(obj);
+}
+
+template<typename T>
+void Evaluator<T>::visit(const AST::NodeList* arg, size_t num, void const** vals)
+{
+    auto n = arg->elems.first;
+    obj_t obj = maker->make_list(arg, stack.top(n, vals));
+    stack.pop(n);
+    trace(trace_t::visit_list, num, obj.value);
     stack.push(obj);
 }
 
@@ -324,138 +374,290 @@ void Evaluator<T>::visit(const AST::ArgName* arg)
     if (obj.name)
         error("invalid %s: obj name is not null: '%s'", stack_name, obj.name);
     obj.name = arg->str;
+    obj.name_len = arg->str.size();
 }
 
 template<typename T>
-void Evaluator<T>::visit(const AST::ArgValue* arg)
+void Evaluator<T>::visit(const AST::TreeNode* arg, size_t num)
 {
-    abstract(arg);
+    // stev: each of the node arguments got exactly
+    // one object pushed onto the stack
+    auto l = AST::node_cast<AST::ListArgs>(arg->args);
+    auto n = l ? l->list.first : 1;
+    obj_t obj = maker->make_node(arg, stack.top(n));
+    stack.pop(n);
+    trace(trace_t::visit_node, num, obj.value);
+    stack.push(obj);
 }
 
 template<typename T>
-void Evaluator<T>::visit(const AST::NodeValue* arg)
+template<typename V>
+inline void Evaluator<T>::trace(
+    trace_t::event_t event, size_t num, const V& val) const
 {
-    eval(arg->node);
+    if (opt.trace != nullptr)
+        opt.trace->record(event, num, stack.size(), val);
+    if (opt.trace_eval)
+        *opt.out
+            << trace_t::name(event) << ": "
+            << print(val, opt) << std::endl;
 }
 
-template<typename T>
-void Evaluator<T>::visit(const AST::ListValue* arg)
+static const char trace_magic[8] = {
+    'T', 'R', 'E', 'E', 'T', 'R', 'C', '1'
+};
+
+static uint64_t trace_clock()
 {
-    eval(arg->list);
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return uint64_t(t.tv_sec) * 1000000000u + t.tv_nsec;
 }
 
-template<typename T>
-void Evaluator<T>::visit(const AST::LiteralValue* arg)
+const char* trace_t::name(event_t event)
 {
-    eval(arg->literal);
+    static const char* const names[] = {
+        "visit(const TreeAST::Literal*)",  // visit_literal
+        "visit(const TreeAST::NodeList*)", // visit_list
+        "visit(const TreeAST::TreeNode*)", // visit_node
+    };
+    return Ext::array(names)[event];
 }
 
-template<typename T>
-void Evaluator<T>::visit(const AST::NodeArg* arg)
+trace_t::trace_t(const char* _file) :
+    file(_file),
+    fd(open(_file, O_WRONLY | O_CREAT | O_TRUNC, 0666)),
+    start(trace_clock()),
+    buf(buf_size),
+    n_buf(0)
 {
-    eval(arg->value);
-    eval(arg->name);
+    CXX_ASSERT(sizeof(head_t) == 16);
+    CXX_ASSERT(sizeof(rec_t) == 40);
+
+    if (fd < 0)
+        error("trace: cannot open '%s': %s",
+            _file, strerror(errno));
+    head_t head;
+    memcpy(head.magic, trace_magic, sizeof trace_magic);
+    head.rec_size = sizeof(rec_t);
+    head.n_types = ast_type_t::n_types;
+    if (write(fd, &head, sizeof head) != ssize_t(sizeof head)) {
+        close(fd);
+        error("trace: cannot write '%s': %s",
+            _file, strerror(errno));
+    }
 }
 
-template<typename T>
-void Evaluator<T>::visit(const AST::NodeArgs* arg)
+trace_t::~trace_t()
 {
-    abstract(arg);
+    try {
+        flush();
+    }
+    catch (...) {
+    }
+    close(fd);
 }
 
-template<typename T>
-void Evaluator<T>::visit(const AST::ListArgs* arg)
+void trace_t::flush()
 {
-    using namespace std;
-    auto beg = arg->list.second;
-    auto end = beg + arg->list.first;
-    for_each(beg, end, [this](const AST::Node* node)
-        { eval(node); });
+    auto n = n_buf * sizeof(rec_t);
+    n_buf = 0;
+    if (n && write(fd, buf.data(), n) != ssize_t(n))
+        error("trace: cannot write '%s': %s",
+            file.c_str(), strerror(errno));
 }
 
-template<typename T>
-void Evaluator<T>::visit(const AST::LiteralArgs* arg)
+inline trace_t::rec_t& trace_t::next(
+    event_t event, size_t node, size_t depth)
 {
-    eval(arg->literal);
+    if (n_buf >= buf_size)
+        flush();
+    auto& rec = buf[n_buf ++];
+    memset(&rec, 0, sizeof rec);
+    rec.time = trace_clock() - start;
+    rec.node = node;
+    rec.depth = depth;
+    rec.event = event;
+    return rec;
 }
 
-template<typename T>
-void Evaluator<T>::visit(const AST::TreeNode* arg)
+void trace_t::record(
+    event_t event, size_t node, size_t depth, const obj_type_t& obj)
 {
-    eval(arg->args);
-    obj_t obj = maker->make_node(arg, stack);
-    if (opt.trace_eval)
-        dump(__PRETTY_FUNCTION__, obj.value);
-    stack.push(obj);
+    auto& rec = next(event, node, depth);
+    rec.type = obj.as<obj_type_t::type_t>();
+    if (auto p = obj.cast<obj_type_t::node_t>())
+        rec.ast_type = p->ast_type->index();
+    else
+    if (auto p = obj.cast<obj_type_t::list_t>())
+        rec.ast_type = p->ast_type->index();
 }
 
-template<typename T>
-void Evaluator<T>::visit(const AST::Tree* arg)
+void trace_t::record(
+    event_t event, size_t node, size_t depth, const obj_value_t& obj)
 {
-    eval(arg->root);
+    auto& rec = next(event, node, depth);
+    rec.type = obj.as<obj_value_t::type_t>();
+    rec.value = true;
+    rec.ptr = Ext::ptr_to_int(obj.payload());
+    if (obj.is<obj_value_t::node_t>())
+        rec.ast_type = obj.as<obj_type_t::node_t>().ast_type->index();
+    else
+    if (obj.is<obj_value_t::list_t>()) {
+        rec.ast_type = obj.as<obj_type_t::list_t>().ast_type->index();
+        rec.size = obj.as<obj_value_t::list_t>().size;
+    }
+    else
+    if (obj.is<obj_value_t::cptr_t>())
+        rec.size = obj.as<obj_value_t::cptr_t>().len;
+}
+
+// stev: the payloads of the objects traced are not valid
+// anymore: the decoded objects are printed 'detached'
+
+void trace_t::decode(
+    const char* file, std::ostream& ost, const print_info_t& info)
+{
+    std::ifstream inp(file, std::ios::binary);
+    if (!inp)
+        error("trace: cannot open '%s': %s",
+            file, strerror(errno));
+
+    head_t head;
+    if (!inp.read(reinterpret_cast<char*>(&head), sizeof head) ||
+        memcmp(head.magic, trace_magic, sizeof trace_magic) ||
+        head.rec_size != sizeof(rec_t))
+        error("trace: invalid trace file '%s'", file);
+    if (head.n_types != ast_type_t::n_types)
+        error("trace: trace file '%s' was not written "
+            "by this extension module", file);
+
+    const print_info_t dinfo(info.verbose, true);
+    const cptr_type_t* cptr = cptr_type<const char*>();
+    rec_t rec;
+    for (size_t k = 0;
+        inp.read(reinterpret_cast<char*>(&rec), sizeof rec);
+        k ++) {
+        if (rec.event > visit_node ||
+            rec.type > obj_consts_t::cptr_obj ||
+            rec.ast_type > ast_type_t::n_types)
+            error("trace: invalid record #%zu of '%s'", k, file);
+
+        auto type = ast_type_t::type_at(rec.ast_type);
+        if (info.verbose)
+            ost << '#' << rec.node
+                << " [" << rec.depth << "] "
+                << rec.time << "ns ";
+        ost << name(static_cast<event_t>(rec.event)) << ": ";
+        if (!rec.value) {
+            ost << print(
+                rec.type == obj_consts_t::node_obj ? node_obj_type(type) :
+                rec.type == obj_consts_t::list_obj ? list_obj_type(type) :
+                cptr_obj_type(cptr),
+                dinfo);
+        }
+        else {
+            auto ptr = Ext::int_to_ptr<const void>(uintptr_t(rec.ptr));
+            ost << print(
+                rec.type == obj_consts_t::node_obj
+                ? node_obj_value(type, ptr) :
+                rec.type == obj_consts_t::list_obj
+                ? list_obj_value(type, rec.size,
+                    static_cast<void const* const*>(ptr)) :
+                obj_value_t(
+                    obj_types_t::make_cptr(cptr),
+                    obj_values_t::make_cptr(
+                        static_cast<const char*>(ptr), rec.size)),
+                dinfo);
+        }
+        ost << std::endl;
+    }
+    if (inp.gcount() != 0)
+        error("trace: truncated trace file '%s'", file);
 }
-// < EVALUATOR_VISITOR_IMPL
 
 template<typename T>
-template<typename V>
-void Evaluator<T>::dump(const char* where, const V& val) const
+void TypeCheck<T>::report(const diag_t& diag) const
 {
-    using namespace std;
-    cout << where_print(where) << ": " << print(val, opt) << endl;
+    if (diags == nullptr)
+        throw ObjError(diag.message());
+    diags->push(diag);
 }
 
 template<typename T>
 void TypeCheck<T>::check_node_arg_name(
-    const ast_type_t* type, const arg_def_t* def, size_t k, const obj_t& obj) const
+    const AST::Node* node, const ast_type_t* type, const arg_def_t* def,
+    size_t k, const obj_t& obj) const
 {
     if (strcmp(def->arg_name, obj.name))
-        error("ast-type %s: arg #%zu: expected name '%s', but got '%s'",
-            type->name, k, def->arg_name, obj.name);
+        report(diag_t(diag_t::arg_name, node, type, def, k, 0, obj.name));
 }
 
 template<typename T>
 void TypeCheck<T>::check_node_arg_value(
-    const ast_type_t* type, const arg_def_t* def, size_t k, const obj_t& obj) const
+    const AST::Node* node, const ast_type_t* type, const arg_def_t* def,
+    size_t k, const obj_t& obj) const
 {
-    if (!def->arg_type.type_cast(obj.value, info))
-        error("ast-type %s: arg #%zu: cannot cast from type '%s' to '%s'",
-            type->name, k, obj.value.type_name().c_str(), def->arg_type.type_name().c_str());
+    // stev: the objects of unknown type got reported already
+    if (!def->arg_type.type_cast(obj.value, info) &&
+        !is_unknown_obj(obj.value))
+        report(diag_t(diag_t::arg_type, node, type, def, k, 0, nullptr, obj.value));
 }
 
 template<typename T>
 void TypeCheck<T>::check_node_arg(
-    const ast_type_t* type, const arg_def_t* def, size_t k, const obj_t& obj) const
+    const AST::Node* node, const ast_type_t* type, const arg_def_t* def,
+    size_t k, const obj_t& obj) const
 {
-    check_node_arg_name(type, def, k, obj);
-    check_node_arg_value(type, def, k, obj);
+    check_node_arg_name(node, type, def, k, obj);
+    check_node_arg_value(node, type, def, k, obj);
+}
+
+// stev: 'match_node_arg' is the fast path of 'check_node_arg':
+// it compares lengths prior to bytes and reports no error; the
+// latter is left to 'check_node_arg' which is called only when
+// 'match_node_arg' failed
+
+template<typename T>
+inline bool TypeCheck<T>::match_node_arg(
+    const arg_def_t* def, const obj_t& obj) const
+{
+    return
+        obj.name_len == def->name_len &&
+        memcmp(obj.name, def->arg_name, def->name_len) == 0 &&
+        def->arg_type.type_cast(obj.value, info);
 }
 
 template<typename T>
 void TypeCheck<T>::check_node_args(
-    const ast_type_t* type, const AST::TreeNode* node, obj_stack_t& args)
+    const ast_type_t* type, const AST::TreeNode* node, const obj_args_t& args) const
 {
     using namespace AST;
 
+    // stev: 'type_names_t' indexes the 'new_funcs'
+    // tables by the order of their names
+    SYS_ASSERT(strcmp(type->name, node->name->ident) == 0);
+
     if (node_cast<LiteralArgs>(node->args)) {
         if (type->narg != 1) {
-            narg_error = true;
-            error("ast-type %s: expected %zu args, but got one",
-                type->name, type->narg);
+            report(diag_t(diag_t::literal_args, node, type,
+                nullptr, 1, type->narg));
+            return;
         }
-        check_node_arg_value(type, type->args, 1, args[0]);
+        check_node_arg_value(node, type, type->args, 1, args[0]);
     }
     else
     if (const ListArgs* list_args = node_cast<ListArgs>(node->args)) {
         if (type->narg != list_args->list.first) {
-            narg_error = true;
-            error("ast-type %s: expected %zu args, but got %zu",
-                type->name, type->narg, list_args->list.first);
+            report(diag_t(diag_t::args_count, node, type,
+                nullptr, list_args->list.first, type->narg));
+            return;
+        }
+        auto def = type->args;
+        for (size_t k = 0; k < type->narg; k ++, def ++) {
+            if (!match_node_arg(def, args[k]))
+                check_node_arg(node, type, def, k + 1, args[k]);
         }
-        size_t k = type->narg - 1;
-        auto ptr = type->args;
-        auto end = ptr + type->narg;
-        for (; ptr != end; ++ ptr, -- k)
-            check_node_arg(type, ptr, type->narg - k, args[k]);
     }
     else
         SYS_UNEXPECT_ERR("node args instance is not literal nor list");
@@ -463,59 +665,48 @@ void TypeCheck<T>::check_node_args(
 
 template<typename T>
 void TypeCheck<T>::check_list_arg(
-    const ast_type_t* type, size_t k, const obj_t& obj) const
+    const AST::NodeList* list, const ast_type_t* type, size_t k, const obj_t& obj) const
 {
-    if (!type->list_type_cast(obj.value, info))
-        error("list<%s>: arg #%zu: cannot cast from type '%s'",
-            type->name, k, obj.value.type_name().c_str());
+    if (!type->list_type_cast(obj.value, info) &&
+        !is_unknown_obj(obj.value))
+        report(diag_t(diag_t::elem_type, list, type, nullptr, k, 0, nullptr, obj.value));
 }
 
 template<typename T>
 void TypeCheck<T>::check_list_args(
-    const ast_type_t* type, const AST::NodeList* list, obj_stack_t& args) const
+    const ast_type_t* type, const AST::NodeList* list, const obj_args_t& args) const
 {
-    size_t n = list->elems.first;
-    for (auto k = n; k; k --)
-        check_list_arg(type, n - k, args[k - 1]);
-}
+    SYS_ASSERT(strcmp(type->name, list->base->ident) == 0);
 
-template<typename T>
-void TypeCheck<T>::pop_args(size_t n_arg, obj_stack_t& args)
-{
-    if (!narg_error) {
-        if (n_arg > 0) args.pop(n_arg);
-    }
-    else
-        narg_error = false;
+    for (size_t k = 0; k < list->elems.first; k ++)
+        check_list_arg(list, type, k, args[k]);
 }
 
 // stev: shared library template instance: TypeCheck<obj_type_t>
 
 template
-void TypeCheck<obj_type_t>::check_node_args(
-    const ast_type_t*, const TreeAST::TreeNode*, obj_stack_t&);
+void TypeCheck<obj_type_t>::report(const diag_t&) const;
 
 template
-void TypeCheck<obj_type_t>::check_list_args(
-    const ast_type_t*, const TreeAST::NodeList*, obj_stack_t&) const;
+void TypeCheck<obj_type_t>::check_node_args(
+    const ast_type_t*, const TreeAST::TreeNode*, const obj_args_t&) const;
 
 template
-void TypeCheck<obj_type_t>::pop_args(
-    size_t n_arg, obj_stack_t& args);
+void TypeCheck<obj_type_t>::check_list_args(
+    const ast_type_t*, const TreeAST::NodeList*, const obj_args_t&) const;
 
 // stev: shared library template instance: TypeCheck<obj_value_t>
 
 template
-void TypeCheck<obj_value_t>::check_node_args(
-    const ast_type_t*, const TreeAST::TreeNode*, obj_stack_t&);
+void TypeCheck<obj_value_t>::report(const diag_t&) const;
 
 template
-void TypeCheck<obj_value_t>::check_list_args(
-    const ast_type_t*, const TreeAST::NodeList*, obj_stack_t&) const;
+void TypeCheck<obj_value_t>::check_node_args(
+    const ast_type_t*, const TreeAST::TreeNode*, const obj_args_t&) const;
 
 template
-void TypeCheck<obj_value_t>::pop_args(
-    size_t n_arg, obj_stack_t& args);
+void TypeCheck<obj_value_t>::check_list_args(
+    const ast_type_t*, const TreeAST::NodeList*, const obj_args_t&) const;
 
 // stev: shared library template instance: ObjMaker<obj_type_t>
 
@@ -539,6 +730,30 @@ obj_value_t eval(
     return Obj::Evaluator<obj_value_t>(maker, opt).eval(tree);
 }
 
+template<typename V>
+eval_session_t<V>::eval_session_t(ObjMaker<V>* maker) :
+    impl(new Evaluator<V>(maker, eval_opts_t()))
+{}
+
+template<typename V>
+eval_session_t<V>::~eval_session_t()
+{}
+
+template<typename V>
+V eval_session_t<V>::eval(const AST::Tree* tree, const eval_opts_t& opt)
+{
+    return impl->eval(tree, opt);
+}
+
+// stev: shared library template instances: eval_session_t<obj_type_t>
+// and eval_session_t<obj_value_t>
+
+template
+class eval_session_t<obj_type_t>;
+
+template
+class eval_session_t<obj_value_t>;
+
 char const* const obj_consts_t::types[3] = {
     "node", // node_obj
     "list", // list_obj
@@ -568,19 +783,8 @@ bool ast_type_t::type_cast(const ast_type_t* src, const type_cast_info_t& info)
 {
     if (info.strict)
         return src == this;
-    auto ptr = src;
-    do {
-        if (ptr == this)
-            return true;
-        if (ptr->base == nullptr)
-            return false;
-        ptr = ptr->base;
-    }
-    while (ptr != src);
-    SYS_UNEXPECT_ERR(
-        "cycle in ast-type: src='" UINTPTR_FORMAT "'",
-        Ext::ptr_to_int(src));
-    return false; // make the compiler happy
+    SYS_ASSERT(enter < leave);
+    return src->enter - enter < leave - enter;
 }
 
 bool ast_type_t::list_type_cast(const obj_type_t& src, const type_cast_info_t& info) const
@@ -615,6 +819,151 @@ bool obj_type_t::type_cast(const obj_type_t& src, const type_cast_info_t& info)
     }
 }
 
+const ast_type_t ast_type_t::unknown("?", nullptr, nullptr, 0);
+
+thread_local ast_type_t const* const* ast_type_t::types = nullptr;
+
+thread_local size_t ast_type_t::n_types = 0;
+
+std::string diag_t::message() const
+{
+    std::ostringstream ost;
+    print(ost);
+    return ost.str();
+}
+
+void diag_t::print(std::ostream& ost) const
+{
+    switch (code) {
+    case unknown_type:
+        ost << "unknown AST type name '" << name << '\'';
+        break;
+    case literal_args:
+        ost << "ast-type " << type->name << ": expected "
+            << count << " args, but got one";
+        break;
+    case args_count:
+        ost << "ast-type " << type->name << ": expected "
+            << count << " args, but got " << index;
+        break;
+    case arg_name:
+        ost << "ast-type " << type->name << ": arg #" << index
+            << ": expected name '" << def->arg_name
+            << "', but got '" << name << '\'';
+        break;
+    case arg_type:
+        ost << "ast-type " << type->name << ": arg #" << index
+            << ": cannot cast from type '" << src.type_name()
+            << "' to '" << def->arg_type.type_name() << '\'';
+        break;
+    case elem_type:
+        ost << "list<" << type->name << ">: arg #" << index
+            << ": cannot cast from type '" << src.type_name() << '\'';
+        break;
+    default:
+        SYS_UNEXPECT_ERR("diag code=%d", code);
+    }
+}
+
+// stev: 'node_path_t' maps each 'TreeNode' and 'NodeList' of a
+// tree to the node of which argument or element it is the value
+// of; the shared nodes of hash-consed trees keep their first parent
+
+class node_path_t
+{
+public:
+    explicit node_path_t(const AST::Tree* tree);
+
+    void print(std::ostream& ost, const AST::Node* node) const;
+
+private:
+    struct step_t
+    {
+        const AST::Node* parent;
+        const AST::ArgName* name; // stev: when 'parent' is a 'TreeNode'
+        size_t index;             // stev: when 'parent' is a 'NodeList'
+    };
+
+    void add(const AST::Node* node, const step_t& step,
+        std::vector<const AST::Node*>& work);
+
+    typedef std::unordered_map<const AST::Node*, step_t> steps_t;
+
+    const AST::TreeNode* root;
+    steps_t steps;
+};
+
+void node_path_t::add(const AST::Node* node, const step_t& step,
+    std::vector<const AST::Node*>& work)
+{
+    if (steps.insert(steps_t::value_type(node, step)).second)
+        work.push_back(node);
+}
+
+node_path_t::node_path_t(const AST::Tree* tree) :
+    root(tree->root)
+{
+    using namespace AST;
+
+    std::vector<const Node*> work(1, root);
+    while (!work.empty()) {
+        auto node = work.back();
+        work.pop_back();
+        if (auto list = node_cast<NodeList>(node)) {
+            for (size_t k = 0; k < list->elems.first; k ++) {
+                auto elem = list->elems.second[k];
+                add(elem->node, step_t{list, nullptr, elem->index}, work);
+            }
+            continue;
+        }
+        auto args = node_cast<ListArgs>(
+            static_cast<const TreeNode*>(node)->args);
+        if (args == nullptr)
+            continue;
+        for (size_t k = 0; k < args->list.first; k ++) {
+            auto arg = args->list.second[k];
+            if (auto val = node_cast<NodeValue>(arg->value))
+                add(val->node, step_t{node, arg->name, 0}, work);
+            else
+            if (auto val = node_cast<ListValue>(arg->value))
+                add(val->list, step_t{node, arg->name, 0}, work);
+        }
+    }
+}
+
+void node_path_t::print(std::ostream& ost, const AST::Node* node) const
+{
+    std::vector<const step_t*> path;
+    while (node != root) {
+        auto ptr = steps.find(node);
+        SYS_ASSERT(ptr != steps.end());
+        path.push_back(&ptr->second);
+        node = ptr->second.parent;
+    }
+    ost << root->name->ident;
+    for (auto ptr = path.rbegin(); ptr != path.rend(); ++ ptr) {
+        if ((*ptr)->name)
+            ost << '.' << (*ptr)->name->str;
+        else
+            ost << '[' << (*ptr)->index << ']';
+    }
+}
+
+void diags_t::print(std::ostream& ost, const char* prefix,
+    const AST::Tree* tree) const
+{
+    if (empty())
+        return;
+    node_path_t path(tree);
+    for (auto& diag : *this) {
+        ost << prefix;
+        path.print(ost, diag.node);
+        ost << ": ";
+        diag.print(ost);
+        ost << std::endl;
+    }
+}
+
 struct type_name_print_t
 {
     type_name_print_t(const char* _name) :
@@ -757,18 +1106,22 @@ void cptr_type_t::print(std::ostream& ost, const print_info_t& info) const
 void obj_value_t::print(std::ostream& ost, const print_info_t& info) const
 {
     ost << Obj::obj_head_print("obj_value_t", as<type_t>(), false, info) << '(';
-    if (auto node = cast<node_t>())
+    if (is<node_t>())
         ost << ".ast_type = " << Obj::print(as<obj_type_t::node_t>().ast_type, info)
-            << " .ptr = " << Obj::print(node->ptr, info);
+            << " .ptr = " << Obj::print(as<node_t>().ptr, info);
     else
-    if (auto list = cast<list_t>())
+    if (is<list_t>())
         ost << ".ast_type = " << Obj::print(as<obj_type_t::list_t>().ast_type, info)
-            << " .size = " << Obj::print(list->size, info)
-            << " .ptr = " << Obj::print(list->ptr, info);
+            << " .size = " << Obj::print(as<list_t>().size, info)
+            << " .ptr = " << Obj::print(as<list_t>().ptr, info);
     else
-    if (auto cptr = cast<cptr_t>())
+    if (is<cptr_t>() && info.detached)
+        ost << ".cptr_type = " << Obj::print(as<obj_type_t::cptr_t>().cptr_type, info)
+            << " .ptr = " << Obj::print(static_cast<const void*>(as<cptr_t>().ptr), info);
+    else
+    if (is<cptr_t>())
         ost << ".cptr_type = " << Obj::print(as<obj_type_t::cptr_t>().cptr_type, info)
-            << " .ptr = " << Obj::print(cptr->ptr, info);
+            << " .ptr = " << Obj::print(as<cptr_t>().ptr, info);
     else
         SYS_UNEXPECT_ERR("type = '%d'", as<type_t>());
     ost << "))";
@@ -799,6 +1152,58 @@ template<>
 const char* cptr_def_t<const char*>::cast(const char* arg)
 { return arg; }
 
+size_t ast_type_t::number_types(const ast_type_t* type, size_t num)
+{
+    type->enter = num ++;
+    auto ptr = ast_type_t::types;
+    auto end = ptr + ast_type_t::n_types;
+    for (; ptr != end; ptr ++) {
+        if ((*ptr)->base == type)
+            num = number_types(*ptr, num);
+    }
+    type->leave = num;
+    return num;
+}
+
+void ast_type_t::init_types()
+{
+    auto beg = ast_type_t::types;
+    auto end = beg + ast_type_t::n_types;
+    size_t num = 0;
+    for (auto ptr = beg; ptr != end; ptr ++) {
+        (*ptr)->idx = ptr - beg;
+        if ((*ptr)->base == nullptr)
+            num = number_types(*ptr, num);
+    }
+    // stev: the types not numbered above are not
+    // reachable from a root type: their 'base'
+    // links end up in a cycle
+    for (auto ptr = beg; ptr != end; ptr ++) {
+        if ((*ptr)->leave == 0)
+            SYS_UNEXPECT_ERR(
+                "cycle in ast-type: name='%s'",
+                (*ptr)->name);
+    }
+    SYS_ASSERT(num == ast_type_t::n_types);
+}
+
+// stev: a table is numbered once, by the first thread entering it;
+// the numbered tables are told apart by their own numbers -- for
+// 'leave' is not null once numbered --, not by their addresses, since
+// a module unloaded and loaded again may well get the same address
+
+void ast_type_t::set_types(ast_type_t const* const* types, size_t n)
+{
+    static std::mutex mutex;
+
+    ast_type_t::types = types;
+    ast_type_t::n_types = n;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (n > 0 && types[0]->leave == 0)
+        init_types();
+}
+
 void ast_type_t::print_types(std::ostream& ost)
 {
     auto ptr = ast_type_t::types;
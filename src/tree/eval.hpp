@@ -20,8 +20,13 @@
 
 #include "config.h"
 
+#include <cstdint>
 #include <cstring>
 
+#include <string>
+#include <vector>
+#include <memory>
+#include <sstream>
 #include <iostream>
 #include <algorithm>
 #include <functional>
@@ -66,7 +71,10 @@ struct ast_type_t
         name(_name),
         base(_base),
         args(_args),
-        narg(_narg)
+        narg(_narg),
+        enter(0),
+        leave(0),
+        idx(0)
     {}
 
     bool type_cast(const ast_type_t* src, const type_cast_info_t& info) const;
@@ -81,8 +89,45 @@ struct ast_type_t
 
     static void print_types(std::ostream&);
 
-    static ast_type_t const* const types[];
-    static size_t            const n_types;
+    // stev: install 'types' as the table of the calling thread --
+    // numbering them once per process, prior to any relaxed cast
+    // and prior to building any 'obj_value_t' out of them
+    static void set_types(ast_type_t const* const* types, size_t n);
+
+    // stev: the index of the type in 'types' -- 'unknown' is
+    // of index 'n_types'; 'type_at' is the inverse of 'index'
+    size_t index() const
+    { return this != &unknown ? idx : n_types; }
+
+    static const ast_type_t* type_at(size_t idx)
+    { return idx < n_types ? types[idx] : &unknown; }
+
+    // stev: the AST types of the extension module: a static table
+    // of the type libs compiled from grammar files, or a table built
+    // at load time by the extensions reading grammar files at runtime;
+    // set by the extension module upon entry by 'set_types'; these
+    // are of thread scope, for the threads may each evaluate trees
+    // of another type lib -- the numbers of the types in the table
+    // are though of process scope: a table is numbered only once
+    static thread_local ast_type_t const* const* types;
+    static thread_local size_t                   n_types;
+
+    // stev: the type of the objects of unknown AST type names
+    // evaluated by 'validate': casting from it fails quietly
+    static const ast_type_t unknown;
+
+private:
+    static void init_types();
+    static size_t number_types(const ast_type_t* type, size_t num);
+
+    // stev: the DFS numbers of the type in the forest made of the
+    // 'base' links of 'types': 'enter' is the pre-order number of
+    // the type and 'leave' is one past the last number its subtree
+    // got; thus 'src' derives from 'this' iff 'src->enter' is in
+    // '[enter, leave)'
+    mutable size_t enter;
+    mutable size_t leave;
+    mutable size_t idx;
 };
 
 struct cptr_type_t
@@ -387,6 +432,8 @@ public:
     // stev: type is initialized by base_t
     { SYS_ASSERT(is<V>()); }
 
+    obj_type_t(const obj_value_t& v);
+
     obj_type_t& operator=(const obj_type_t& o)
     // stev: type is assigned by base_t
     { base_t::operator=(o.base()); SYS_ASSERT(is(o.type)); return *this; }
@@ -396,6 +443,8 @@ public:
     // stev: type is assigned by base_t
     { base_t::operator=(v); SYS_ASSERT(is<V>()); return *this; }
 
+    obj_type_t& operator=(const obj_value_t& v);
+
     using base_t::is;
     using base_t::as;
     using base_t::cast;
@@ -408,9 +457,7 @@ public:
 
 private:
     friend class obj_base_t<obj_type_t, obj_types_t, false>;
-    friend class obj_base_t<obj_value_t, obj_values_t, false>;
     friend class obj_base_t<obj_type_t, obj_types_t, true>;
-    friend class obj_base_t<obj_value_t, obj_values_t, true>;
 
     const base_t& base() const
     { return *this; }
@@ -422,6 +469,7 @@ struct arg_def_t
 {
     arg_def_t() :
         arg_name(nullptr),
+        name_len(0),
         arg_type()
     {}
 
@@ -429,12 +477,14 @@ struct arg_def_t
         const char* _arg_name,
         const obj_type_t& _arg_type) :
         arg_name(_arg_name),
+        name_len(strlen(_arg_name)),
         arg_type(_arg_type)
     {}
 
     void print(std::ostream& ost, const print_info_t& info) const;
 
     char const* const arg_name;
+    size_t      const name_len;
     obj_type_t  const arg_type;
 };
 
@@ -537,6 +587,7 @@ struct obj_values_t : obj_consts_t
     struct cptr_t
     {
         const char* ptr;
+        size_t len;
     };
 
     static node_t make_node(const void* ptr)
@@ -545,8 +596,8 @@ struct obj_values_t : obj_consts_t
     static list_t make_list(size_t size, void const* const* ptr)
     { list_t r; r.size = size; r.ptr = ptr; return r; }
 
-    static cptr_t make_cptr(const char* ptr)
-    { cptr_t r; r.ptr = ptr; return r; }
+    static cptr_t make_cptr(const char* ptr, size_t len)
+    { cptr_t r; r.ptr = ptr; r.len = len; return r; }
 
     template<typename V>
     static bool is(type_t type)
@@ -565,30 +616,34 @@ template<> struct obj_values_t::traits_t<obj_values_t::list_t>
 template<> struct obj_values_t::traits_t<obj_values_t::cptr_t>
 { static const type_t type = cptr_obj; };
 
-class obj_value_t :
-    public  obj_type_t,
-    private obj_base_t<obj_value_t, obj_values_t, false>
+// stev: 'obj_value_t' is packed into 16 bytes: 'ptr' is the payload
+// of the object -- the AST node, the array of the elements of the
+// list or the chars of the string --, while 'bits' packs the kind of
+// the object, the index of its AST type in 'ast_type_t::types' and
+// the size of the list or of the string; note that the only 'cptr'
+// type of the values of objects is 'cptr_type<const char*>()'
+
+class obj_value_t : public obj_consts_t
 {
 public:
-    typedef obj_base_t<obj_value_t, obj_values_t, false> base_t;
-
-    typedef base_t::type_t type_t;
-    typedef base_t::node_t node_t;
-    typedef base_t::list_t list_t;
-    typedef base_t::cptr_t cptr_t;
+    typedef obj_values_t::type_t type_t;
+    typedef obj_values_t::node_t node_t;
+    typedef obj_values_t::list_t list_t;
+    typedef obj_values_t::cptr_t cptr_t;
 
     template<typename T, typename V>
-    obj_value_t(T t, V v) : obj_type_t(t), base_t(v)
+    obj_value_t(T t, V v)
     {
         CXX_ASSERT(
-            obj_type_t::traits_t<T>::type ==
-            base_t::traits_t<V>::type);
-        SYS_ASSERT(obj_type_t::is<T>());
-        SYS_ASSERT(base_t::is<V>());
+            Obj::obj_types_t::traits_t<T>::type ==
+            Obj::obj_values_t::traits_t<V>::type);
+        pack(
+            obj_values_t::traits_t<V>::type,
+            type_index(t), value_size(v), value_ptr(v));
     }
 
     bool is(type_t type) const
-    { return obj_type_t::is(type); }
+    { return kind() == type; }
 
     template<typename V>
     bool is() const
@@ -598,26 +653,107 @@ public:
     V as() const
     { return traits_t<V>::as(*this); }
 
-    template<typename V>
-    const V* cast() const
-    { return traits_t<V>::cast(*this); }
+    obj_type_t obj_type() const;
+
+    // stev: the payload pointer of the object, unchecked
+    const void* payload() const
+    { return ptr; }
+
+    bool operator==(const obj_value_t& o) const
+    { return ptr == o.ptr && bits == o.bits; }
+    bool operator!=(const obj_value_t& o) const
+    { return ptr != o.ptr || bits != o.bits; }
 
     void print(std::ostream& ost, const print_info_t& info) const;
 
 private:
-    friend class obj_base_t<obj_value_t, obj_values_t, false>;
+    enum : unsigned {
+        kind_bits  = 2,
+        index_bits = 30,
+        size_bits  = 32,
+    };
+
+    static const uint64_t kind_mask  = (uint64_t(1) << kind_bits) - 1;
+    static const uint64_t index_mask = (uint64_t(1) << index_bits) - 1;
+    static const uint64_t size_mask  = (uint64_t(1) << size_bits) - 1;
 
     template<typename V>
     struct traits_t;
+
+    type_t kind() const
+    { return static_cast<type_t>(bits & kind_mask); }
+
+    size_t index() const
+    { return (bits >> kind_bits) & index_mask; }
+
+    size_t size() const
+    { return bits >> (kind_bits + index_bits); }
+
+    void check(type_t type) const
+    {
+        if (kind() != type)
+            error("type mismatch '%s': actual type is '%s'",
+                Ext::array(types)[type],
+                Ext::array(types)[kind()]);
+    }
+
+    void pack(type_t kind, size_t index, size_t size, const void* ptr);
+
+    static size_t type_index(const obj_types_t::node_t& t)
+    { return t.ast_type->index(); }
+
+    static size_t type_index(const obj_types_t::list_t& t)
+    { return t.ast_type->index(); }
+
+    static size_t type_index(const obj_types_t::cptr_t& t)
+    { SYS_ASSERT(t.cptr_type == cptr_type<const char*>()); return 0; }
+
+    static size_t value_size(const node_t&)
+    { return 0; }
+
+    static size_t value_size(const list_t& v)
+    { return v.size; }
+
+    static size_t value_size(const cptr_t& v)
+    { return v.len; }
+
+    static const void* value_ptr(const node_t& v)
+    { return v.ptr; }
+
+    static const void* value_ptr(const list_t& v)
+    { return v.ptr; }
+
+    static const void* value_ptr(const cptr_t& v)
+    { return v.ptr; }
+
+    const void* ptr;
+    uint64_t    bits;
 };
 
+inline void obj_value_t::pack(
+    type_t kind, size_t index, size_t size, const void* ptr)
+{
+    CXX_ASSERT(sizeof(obj_value_t) == 16);
+    SYS_ASSERT(index <= index_mask);
+    // stev: lists are of at most 256 elements; only
+    // string literals could get past the size limit
+    if (size > size_mask)
+        error("%s object too large: size is %zu",
+            Ext::array(types)[kind], size);
+    this->ptr = ptr;
+    bits =
+        uint64_t(kind) |
+        uint64_t(index) << kind_bits |
+        uint64_t(size) << (kind_bits + index_bits);
+}
+
 template<>
-struct obj_value_t::traits_t<obj_type_t::type_t>
+struct obj_value_t::traits_t<obj_value_t::type_t>
 {
-    typedef obj_type_t::type_t type_t;
+    typedef obj_value_t::type_t type_t;
 
     static type_t as(const obj_value_t& o)
-    { return o.obj_type_t::as<type_t>(); }
+    { return o.kind(); }
 };
 
 template<>
@@ -626,13 +762,14 @@ struct obj_value_t::traits_t<obj_type_t::node_t>
     typedef obj_type_t::node_t type_t;
 
     static bool is(const obj_value_t& o)
-    { return o.obj_type_t::is<type_t>(); }
+    { return o.kind() == node_obj; }
 
     static type_t as(const obj_value_t& o)
-    { return o.obj_type_t::as<type_t>(); }
-
-    static const type_t* cast(const obj_value_t& o)
-    { return o.obj_type_t::cast<type_t>(); }
+    {
+        o.check(node_obj);
+        return obj_types_t::make_node(
+            ast_type_t::type_at(o.index()));
+    }
 };
 
 template<>
@@ -641,13 +778,14 @@ struct obj_value_t::traits_t<obj_type_t::list_t>
     typedef obj_type_t::list_t type_t;
 
     static bool is(const obj_value_t& o)
-    { return o.obj_type_t::is<type_t>(); }
+    { return o.kind() == list_obj; }
 
     static type_t as(const obj_value_t& o)
-    { return o.obj_type_t::as<type_t>(); }
-
-    static const type_t* cast(const obj_value_t& o)
-    { return o.obj_type_t::cast<type_t>(); }
+    {
+        o.check(list_obj);
+        return obj_types_t::make_list(
+            ast_type_t::type_at(o.index()));
+    }
 };
 
 template<>
@@ -656,13 +794,14 @@ struct obj_value_t::traits_t<obj_type_t::cptr_t>
     typedef obj_type_t::cptr_t type_t;
 
     static bool is(const obj_value_t& o)
-    { return o.obj_type_t::is<type_t>(); }
+    { return o.kind() == cptr_obj; }
 
     static type_t as(const obj_value_t& o)
-    { return o.obj_type_t::as<type_t>(); }
-
-    static const type_t* cast(const obj_value_t& o)
-    { return o.obj_type_t::cast<type_t>(); }
+    {
+        o.check(cptr_obj);
+        return obj_types_t::make_cptr(
+            cptr_type<const char*>());
+    }
 };
 
 template<>
@@ -671,13 +810,13 @@ struct obj_value_t::traits_t<obj_value_t::node_t>
     typedef obj_value_t::node_t type_t;
 
     static bool is(const obj_value_t& o)
-    { return o.base_t::is<type_t>(); }
+    { return o.kind() == node_obj; }
 
     static type_t as(const obj_value_t& o)
-    { return o.base_t::as<type_t>(); }
-
-    static const type_t* cast(const obj_value_t& o)
-    { return o.base_t::cast<type_t>(); }
+    {
+        o.check(node_obj);
+        return obj_values_t::make_node(o.ptr);
+    }
 };
 
 template<>
@@ -686,13 +825,14 @@ struct obj_value_t::traits_t<obj_value_t::list_t>
     typedef obj_value_t::list_t type_t;
 
     static bool is(const obj_value_t& o)
-    { return o.base_t::is<type_t>(); }
+    { return o.kind() == list_obj; }
 
     static type_t as(const obj_value_t& o)
-    { return o.base_t::as<type_t>(); }
-
-    static const type_t* cast(const obj_value_t& o)
-    { return o.base_t::cast<type_t>(); }
+    {
+        o.check(list_obj);
+        return obj_values_t::make_list(o.size(),
+            static_cast<void const* const*>(o.ptr));
+    }
 };
 
 template<>
@@ -701,15 +841,39 @@ struct obj_value_t::traits_t<obj_value_t::cptr_t>
     typedef obj_value_t::cptr_t type_t;
 
     static bool is(const obj_value_t& o)
-    { return o.base_t::is<type_t>(); }
+    { return o.kind() == cptr_obj; }
 
     static type_t as(const obj_value_t& o)
-    { return o.base_t::as<type_t>(); }
-
-    static const type_t* cast(const obj_value_t& o)
-    { return o.base_t::cast<type_t>(); }
+    {
+        o.check(cptr_obj);
+        return obj_values_t::make_cptr(
+            static_cast<const char*>(o.ptr), o.size());
+    }
 };
 
+inline obj_type_t obj_value_t::obj_type() const
+{
+    switch (kind()) {
+    case node_obj:
+        return obj_type_t(as<obj_type_t::node_t>());
+    case list_obj:
+        return obj_type_t(as<obj_type_t::list_t>());
+    case cptr_obj:
+        return obj_type_t(as<obj_type_t::cptr_t>());
+    default:
+        SYS_UNEXPECT_ERR("type = '%d'", kind());
+    }
+}
+
+inline obj_type_t::obj_type_t(const obj_value_t& v) :
+    obj_type_t(v.obj_type())
+{}
+
+inline obj_type_t& obj_type_t::operator=(const obj_value_t& v)
+{
+    return *this = v.obj_type();
+}
+
 inline obj_type_t node_obj_type(const ast_type_t* ast_type)
 {
     return obj_type_t(obj_types_t::make_node(ast_type));
@@ -764,28 +928,49 @@ inline obj_value_t list_obj_value(
         obj_values_t::make_list(sz, ptr));
 }
 
-inline obj_value_t cptr_obj_value(const char* ptr)
+inline obj_value_t cptr_obj_value(const AST::str_t& str)
 {
     return obj_value_t(
         obj_types_t::make_cptr(cptr_type<const char*>()),
-        obj_values_t::make_cptr(ptr));
+        obj_values_t::make_cptr(str.ptr, str.len));
 }
 
 template<typename T>
-T cptr_obj(const char* cptr);
+T cptr_obj(const AST::str_t& cptr);
 
 template<>
-inline obj_type_t cptr_obj<obj_type_t>(const char* cptr UNUSED)
+inline obj_type_t cptr_obj<obj_type_t>(const AST::str_t& cptr UNUSED)
 {
     return cptr_obj_type();
 }
 
 template<>
-inline obj_value_t cptr_obj<obj_value_t>(const char* cptr)
+inline obj_value_t cptr_obj<obj_value_t>(const AST::str_t& cptr)
 {
     return cptr_obj_value(cptr);
 }
 
+template<typename T>
+T unknown_obj();
+
+template<>
+inline obj_type_t unknown_obj<obj_type_t>()
+{
+    return node_obj_type(&ast_type_t::unknown);
+}
+
+template<>
+inline obj_value_t unknown_obj<obj_value_t>()
+{
+    return node_obj_value(&ast_type_t::unknown, nullptr);
+}
+
+inline bool is_unknown_obj(const obj_type_t& obj)
+{
+    auto node = obj.cast<obj_type_t::node_t>();
+    return node && node->ast_type == &ast_type_t::unknown;
+}
+
 std::string type_name(const obj_type_t& obj);
 
 template<typename T>
@@ -793,45 +978,61 @@ struct obj_t
 {
     typedef T value_t;
 
-    obj_t(const char* _name, value_t _value) :
+    obj_t(const char* _name, size_t _name_len, value_t _value) :
         name(_name),
+        name_len(_name_len),
         value(_value)
     {}
 
     obj_t(value_t _value) :
         name(nullptr),
+        name_len(0),
         value(_value)
     {}
 
     void print(std::ostream& ost, const print_info_t& info) const;
 
     const char* name;
+    size_t      name_len;
     value_t     value;
 };
 
+// stev: 'obj_args_t' is a view of the topmost 'size()' objects
+// of the evaluator's stack, in the order they were pushed: for a
+// tree node, 'args[k]' is the object of its argument #k + 1; for
+// a list, 'args[k]' is the object of its element of index 'k';
+// the evaluator pops these objects off its stack once 'ObjMaker'
+// returned; for a list, 'values()' is the array which 'ObjMaker'
+// obtained through 'list_values', holding the payloads of these
+// objects -- or 'nullptr' if 'ObjMaker' provided no such array
+
 template<typename T>
-class obj_stack_t
+class obj_args_t
 {
 public:
     typedef Obj::obj_t<T> obj_t;
 
-    obj_stack_t(const obj_stack_t&) = delete;
-    obj_stack_t& operator=(const obj_stack_t&) = delete;
+    obj_args_t(const obj_t* _ptr, size_t _size, void const* const* _vals = nullptr) :
+        ptr(_ptr),
+        sz(_size),
+        vals(_vals)
+    {}
 
-    obj_stack_t(obj_stack_t&&) = delete;
-    obj_stack_t& operator=(obj_stack_t&&) = delete;
+    bool empty() const { return sz == 0; }
+    size_t size() const { return sz; }
 
-    virtual ~obj_stack_t() {}
+    void const* const* values() const { return vals; }
 
-    virtual bool empty() const = 0;
-    virtual size_t size() const = 0;
+    const obj_t& operator[](size_t k) const
+    { SYS_ASSERT(k < sz); return ptr[k]; }
 
-    virtual const obj_t& operator[](size_t k) const = 0;
-    virtual const obj_t& top() const = 0;
-    virtual void  pop(size_t n) = 0;
+    const obj_t* begin() const { return ptr; }
+    const obj_t* end() const { return ptr + sz; }
 
-protected:
-    obj_stack_t() {}
+private:
+    const obj_t*       ptr;
+    size_t             sz;
+    void const* const* vals;
 };
 
 template<typename T>
@@ -839,31 +1040,121 @@ struct ObjMaker
 {
     typedef T val_t;
     typedef Obj::obj_t<val_t> obj_t;
-    typedef Obj::obj_stack_t<val_t> obj_stack_t;
+    typedef Obj::obj_args_t<val_t> obj_args_t;
 
     virtual ~ObjMaker() {}
 
-    virtual val_t make_node(const TreeAST::TreeNode* node, obj_stack_t& args) = 0;
-    virtual val_t make_list(const TreeAST::NodeList* list, obj_stack_t& args) = 0;
+    virtual val_t make_node(const TreeAST::TreeNode* node, const obj_args_t& args) = 0;
+    virtual val_t make_list(const TreeAST::NodeList* list, const obj_args_t& args) = 0;
     virtual val_t make_cptr(const TreeAST::Literal* cptr) = 0;
+
+    // stev: an array of 'list->elems.first' slots into which the
+    // evaluator stores the payload of each element of 'list' right
+    // after evaluating it; the array is passed on to 'make_list' by
+    // 'args.values()'; 'nullptr' stands for no array
+    virtual void const** list_values(const TreeAST::NodeList* list UNUSED)
+    { return nullptr; }
+};
+
+// stev: 'trace_t' writes the evaluation trace into a file in binary:
+// a 'head_t' followed by one fixed-size 'rec_t' for each object which
+// the evaluator pushes onto its stack; the records are buffered into
+// memory and written out when the buffer got full and at the end;
+// 'decode' prints out a trace file in the format of the text trace
+// of the evaluator
+
+class trace_t
+{
+public:
+    enum event_t {
+        visit_literal,
+        visit_list,
+        visit_node,
+    };
+
+    static const char* name(event_t event);
+
+    explicit trace_t(const char* _file);
+    ~trace_t();
+
+    trace_t(const trace_t&) = delete;
+    trace_t& operator=(const trace_t&) = delete;
+
+    // stev: 'node' is the DFS pre-order number of the tree node
+    // visited; 'depth' is the size of the evaluator's stack prior
+    // to pushing 'obj' onto it
+    void record(event_t event, size_t node, size_t depth, const obj_type_t& obj);
+    void record(event_t event, size_t node, size_t depth, const obj_value_t& obj);
+
+    void flush();
+
+    static void decode(const char* file, std::ostream& ost, const print_info_t& info);
+
+private:
+    struct head_t
+    {
+        char     magic[8];
+        uint32_t rec_size;
+        uint32_t n_types;
+    };
+
+    struct rec_t
+    {
+        uint64_t time;     // nanoseconds since the start of the trace
+        uint32_t node;
+        uint32_t depth;
+        uint32_t ast_type; // the index of the type in 'ast_type_t::types'
+        uint8_t  event;
+        uint8_t  type;     // the 'obj_consts_t::type_t' of the object
+        uint8_t  value;    // whether the object is an 'obj_value_t'
+        uint8_t  pad;
+        uint64_t ptr;      // the payload of an 'obj_value_t'
+        uint64_t size;     // the size of the list or of the string
+    };
+
+    enum { buf_size = 4096 };
+
+    rec_t& next(event_t event, size_t node, size_t depth);
+
+    std::string        file;
+    int                fd;
+    uint64_t           start;
+    std::vector<rec_t> buf;
+    size_t             n_buf;
 };
 
 struct eval_opts_t
 {
     eval_opts_t() :
         trace_eval(false),
-        verbose(false)
+        verbose(false),
+        n_obj(0),
+        trace(nullptr),
+        out(&std::cout)
     {}
 
     eval_opts_t(
         bool _trace_eval,
-        bool _verbose) :
+        bool _verbose,
+        size_t _n_obj = 0,
+        trace_t* _trace = nullptr,
+        std::ostream* _out = &std::cout) :
         trace_eval(_trace_eval),
-        verbose(_verbose)
+        verbose(_verbose),
+        n_obj(_n_obj),
+        trace(_trace),
+        out(_out)
     {}
 
     bool trace_eval;
     bool verbose;
+    // stev: the number of objects to reserve room for
+    // on the evaluator's stack prior to the evaluation
+    size_t n_obj;
+    // stev: the binary trace of the evaluation -- if any
+    trace_t* trace;
+    // stev: the stream of the text trace of 'trace_eval'
+    std::ostream* out;
 };
 
 template<typename T, typename V>
@@ -873,18 +1164,122 @@ inline T eval(const TreeAST::Tree* tree, ObjMaker<V>* maker, const eval_opts_t&
     return static_cast<T>(eval(tree, maker, opt));
 }
 
+template<typename T>
+class Evaluator;
+
+// stev: 'eval_session_t' evaluates a sequence of trees through one
+// and the same maker and evaluator: the evaluator's work and object
+// stacks, once grown, are only emptied from one tree to the next
+
+template<typename V>
+class eval_session_t
+{
+public:
+    explicit eval_session_t(ObjMaker<V>* maker);
+    ~eval_session_t();
+
+    eval_session_t(const eval_session_t&) = delete;
+    eval_session_t& operator=(const eval_session_t&) = delete;
+
+    V eval(const TreeAST::Tree* tree, const eval_opts_t& opt);
+
+    template<typename T>
+    T eval(const TreeAST::Tree* tree, const eval_opts_t& opt)
+    { return static_cast<T>(eval(tree, opt)); }
+
+private:
+    std::unique_ptr<Evaluator<V>> impl;
+};
+
+// stev: 'diag_t' is a type error found by 'TypeCheck' while in
+// 'validate' mode; its message gets formatted only when printed;
+// 'node' is the tree node -- 'TreeNode' or 'NodeList' -- at which
+// the error was found and 'index' is the one-based number of the
+// argument, or the index of the list element, in error
+
+struct diag_t
+{
+    enum code_t {
+        unknown_type, // unknown AST type name 'name'
+        literal_args, // 'type' expected 'count' args, but got one
+        args_count,   // 'type' expected 'count' args, but got 'index'
+        arg_name,     // 'type' arg #'index': expected name 'def', but got 'name'
+        arg_type,     // 'type' arg #'index': cannot cast from 'src' to 'def'
+        elem_type,    // list<'type'> arg #'index': cannot cast from 'src'
+    };
+
+    diag_t(
+        code_t _code,
+        const TreeAST::Node* _node,
+        const ast_type_t* _type = nullptr,
+        const arg_def_t* _def = nullptr,
+        size_t _index = 0,
+        size_t _count = 0,
+        const char* _name = nullptr,
+        const obj_type_t& _src = obj_type_t()) :
+        code(_code),
+        node(_node),
+        type(_type),
+        def(_def),
+        index(_index),
+        count(_count),
+        name(_name),
+        src(_src)
+    {}
+
+    std::string message() const;
+    void print(std::ostream& ost) const;
+
+    code_t               code;
+    const TreeAST::Node* node;
+    const ast_type_t*    type;
+    const arg_def_t*     def;
+    size_t               index;
+    size_t               count;
+    const char*          name;
+    obj_type_t           src;
+};
+
+// stev: 'diags_t' collects the 'diag_t' objects in the order
+// they were found; 'print' builds the path of the tree node of
+// each diagnostic -- e.g. 'N.y.b[0]' -- by walking 'tree' once
+
+class diags_t : private std::vector<diag_t>
+{
+public:
+    typedef std::vector<diag_t> base_t;
+
+    using base_t::empty;
+    using base_t::size;
+    using base_t::begin;
+    using base_t::end;
+    using base_t::operator[];
+
+    void push(const diag_t& diag)
+    { base_t::push_back(diag); }
+
+    void print(std::ostream& ost, const char* prefix,
+        const TreeAST::Tree* tree) const;
+};
+
 template<typename T>
 class TypeCheck
 {
 public:
     typedef T val_t;
     typedef Obj::obj_t<val_t> obj_t;
-    typedef Obj::obj_stack_t<val_t> obj_stack_t;
-
-    TypeCheck(const type_cast_info_t& _info) :
-        info(_info), narg_error(false)
+    typedef Obj::obj_args_t<val_t> obj_args_t;
+
+    // stev: 'diags' is null when the type errors are to be thrown
+    // as 'ObjError' exceptions -- the default; otherwise, they're
+    // pushed onto 'diags', the type checking moving on regardless
+    TypeCheck(const type_cast_info_t& _info, diags_t* _diags = nullptr) :
+        info(_info),
+        diags(_diags)
     {}
 
+    void report(const diag_t& diag) const;
+
     template<typename V>
     class auto_t
     {
@@ -961,26 +1356,23 @@ public:
             TypeCheck* _self,
             const type_t* _type,
             const node_t* _node,
-            obj_stack_t& _args,
-            size_t _narg) :
+            const obj_args_t& _args) :
             self(_self),
             type(_type),
             node(_node),
-            args(&_args),
-            narg(_narg)
+            args(&_args)
         {}
 
-        TypeCheck*    const self;
-        type_t const* const type;
-        node_t const* const node;
-        obj_stack_t*  const args;
-        size_t        const narg;
+        TypeCheck*        const self;
+        type_t const*     const type;
+        node_t const*     const node;
+        obj_args_t const* const args;
 
     protected:
+        // stev: nothing to do: the evaluator
+        // pops the arguments off its stack
         void done()
-        {
-            self->pop_args(narg, *args);
-        }
+        {}
     };
 
     class check0_node_t : public check0_t<ast_type_t, TreeAST::TreeNode>
@@ -994,13 +1386,12 @@ public:
             TypeCheck* _self,
             const type_t* _type,
             const node_t* _node,
-            obj_stack_t& _args) :
+            const obj_args_t& _args) :
             base_t(
                 _self,
                 _type,
                 _node,
-                _args,
-                _type->narg)
+                _args)
         {}
 
     private:
@@ -1028,13 +1419,12 @@ public:
             TypeCheck* _self,
             const type_t* _type,
             const node_t* _node,
-            obj_stack_t& _args) :
+            const obj_args_t& _args) :
             base_t(
                 _self,
                 _type,
                 _node,
-                _args,
-                _node->elems.first)
+                _args)
         {}
 
     private:
@@ -1055,59 +1445,159 @@ public:
     typedef auto_t<check0_list_t> check_list_t;
 
     template<typename N>
-    check_node_t check_node(const TreeAST::TreeNode* node, obj_stack_t& args)
+    check_node_t check_node(const TreeAST::TreeNode* node, const obj_args_t& args)
     {
         return check_node(ast_type<N>(), node, args);
     }
 
     template<typename N>
-    check_list_t check_list(const TreeAST::NodeList* list, obj_stack_t& args)
+    check_list_t check_list(const TreeAST::NodeList* list, const obj_args_t& args)
     {
         return check_list(ast_type<N>(), list, args);
     }
 
-private:
-    template<typename V>
-    auto_t<V> make_auto(
-        const typename V::type_t* type, const typename V::node_t* node, obj_stack_t& args)
-    {
-        return auto_t<V>(V(this, type, node, args));
-    }
-
+    // stev: for the AST types not known at compile-time
     check_node_t check_node(
-        const ast_type_t* type, const TreeAST::TreeNode* node, obj_stack_t& args)
+        const ast_type_t* type, const TreeAST::TreeNode* node, const obj_args_t& args)
     {
         return make_auto<check0_node_t>(type, node, args);
     }
 
     check_list_t check_list(
-        const ast_type_t* type, const TreeAST::NodeList* list, obj_stack_t& args)
+        const ast_type_t* type, const TreeAST::NodeList* list, const obj_args_t& args)
     {
         return make_auto<check0_list_t>(type, list, args);
     }
 
+private:
+    template<typename V>
+    auto_t<V> make_auto(
+        const typename V::type_t* type, const typename V::node_t* node, const obj_args_t& args)
+    {
+        return auto_t<V>(V(this, type, node, args));
+    }
+
     void check_node_arg_name(
-        const ast_type_t* type, const arg_def_t* def, size_t k, const obj_t& obj) const;
+        const TreeAST::Node* node, const ast_type_t* type, const arg_def_t* def,
+        size_t k, const obj_t& obj) const;
 
     void check_node_arg_value(
-        const ast_type_t* type, const arg_def_t* def, size_t k, const obj_t& obj) const;
+        const TreeAST::Node* node, const ast_type_t* type, const arg_def_t* def,
+        size_t k, const obj_t& obj) const;
 
     void check_node_arg(
-        const ast_type_t* type, const arg_def_t* def, size_t k, const obj_t& obj) const;
+        const TreeAST::Node* node, const ast_type_t* type, const arg_def_t* def,
+        size_t k, const obj_t& obj) const;
+
+    bool match_node_arg(const arg_def_t* def, const obj_t& obj) const;
 
     void check_node_args(
-        const ast_type_t* type, const TreeAST::TreeNode* node, obj_stack_t& args);
+        const ast_type_t* type, const TreeAST::TreeNode* node, const obj_args_t& args) const;
 
     void check_list_arg(
-        const ast_type_t* type, size_t k, const obj_t& obj) const;
+        const TreeAST::NodeList* list, const ast_type_t* type, size_t k,
+        const obj_t& obj) const;
 
     void check_list_args(
-        const ast_type_t* type, const TreeAST::NodeList* list, obj_stack_t& args) const;
-
-    void pop_args(size_t n_arg, obj_stack_t& args);
+        const ast_type_t* type, const TreeAST::NodeList* list, const obj_args_t& args) const;
 
     const type_cast_info_t info;
-    bool narg_error;
+    diags_t* const diags;
+};
+
+// stev: 'type_names_t' maps the AST type names of an extension to
+// their indices in the 'new_funcs' tables of 'TypeMaker' and 'NodeMaker'
+// -- the two tables list the types in the same order. The map is a perfect
+// hash: the upper 'n_bit' bits of the FNV-1a hash of a name multiplied by
+// 'seed' is the slot holding the index of that name; the unused slots hold
+// 'n_name', the index of the empty name closing 'names'. Hence 'find' has
+// no loop, no state and no allocation, and compares one pair of strings.
+// The tables are produced by 'tree-phash' out of the names of 'new_funcs'
+// and each extension verifies them at compile-time by the means of 'check'
+// -- which also ties each name to the entry of 'new_funcs' of same index.
+
+struct type_names_t
+{
+    typedef unsigned char slot_t;
+
+    static const size_t npos = SIZE_MAX;
+
+    template<size_t N, size_t S>
+    constexpr type_names_t(
+        const char* const (&_names)[N],
+        const slot_t (&_slots)[S],
+        uint32_t _seed) :
+        names(_names),
+        slots(_slots),
+        n_name(N - 1),
+        n_slot(S),
+        n_bit(log2(S)),
+        seed(_seed)
+    {}
+
+    size_t find(const char* name) const
+    {
+        size_t k = slots[slot(name)];
+        return strcmp(names[k], name) == 0 ? k : npos;
+    }
+
+    constexpr bool check() const
+    {
+        return
+            n_bit > 0 && n_bit < 32 &&
+            n_slot == size_t(1) << n_bit &&
+            n_name < n_slot &&
+            names[n_name][0] == 0 &&
+            check_names(0) &&
+            check_slots(0);
+    }
+
+    template<typename F, size_t N>
+    constexpr bool check(const F (&funcs)[N]) const
+    { return check() && n_name == N && check_funcs(funcs, 0); }
+
+    char const* const* const names;
+    slot_t const*      const slots;
+    size_t             const n_name;
+    size_t             const n_slot;
+    unsigned           const n_bit;
+    uint32_t           const seed;
+
+private:
+    static constexpr unsigned log2(size_t n)
+    { return n > 1 ? 1 + log2(n / 2) : 0; }
+
+    static constexpr uint32_t hash(const char* str, uint32_t h = 2166136261u)
+    {
+        return *str
+            ? hash(str + 1, (h ^ static_cast<unsigned char>(*str)) * 16777619u)
+            : h;
+    }
+
+    constexpr size_t slot(const char* name) const
+    { return static_cast<uint32_t>(hash(name) * seed) >> (32 - n_bit); }
+
+    constexpr bool check_names(size_t k) const
+    {
+        return k >= n_name || (
+            names[k][0] &&
+            slots[slot(names[k])] == k &&
+            check_names(k + 1));
+    }
+
+    constexpr bool check_slots(size_t k) const
+    { return k >= n_slot || (slots[k] <= n_name && check_slots(k + 1)); }
+
+    template<typename F, size_t N>
+    constexpr bool check_funcs(const F (&funcs)[N], size_t k) const
+    {
+        return k >= N || (
+            equal(names[k], funcs[k].name) &&
+            check_funcs(funcs, k + 1));
+    }
+
+    static constexpr bool equal(const char* a, const char* b)
+    { return *a == *b && (*a == 0 || equal(a + 1, b + 1)); }
 };
 
 template<typename M, typename T>
@@ -1120,27 +1610,23 @@ protected:
     typedef ObjMaker<T> base_t;
     typedef typename base_t::val_t val_t;
     typedef typename base_t::obj_t obj_t;
-    typedef typename base_t::obj_stack_t obj_stack_t;
+    typedef typename base_t::obj_args_t obj_args_t;
     typedef TypeCheck<T> type_check_t;
 
-    BasicMaker(const type_cast_info_t& _info) :
-        type_check_t(_info)
+    BasicMaker(const type_cast_info_t& _info, diags_t* _diags = nullptr) :
+        type_check_t(_info, _diags)
     {}
 
-    val_t make_node(const TreeAST::TreeNode* node, obj_stack_t& args);
-    val_t make_list(const TreeAST::NodeList* list, obj_stack_t& args);
+    val_t make_node(const TreeAST::TreeNode* node, const obj_args_t& args);
+    val_t make_list(const TreeAST::NodeList* list, const obj_args_t& args);
     val_t make_cptr(const TreeAST::Literal* cptr);
 
     struct new_funcs_t
     {
-        typedef val_t (self_t::*new_node_t)(const TreeAST::TreeNode*, obj_stack_t&);
-        typedef val_t (self_t::*new_list_t)(const TreeAST::NodeList*, obj_stack_t&);
+        typedef val_t (self_t::*new_node_t)(const TreeAST::TreeNode*, const obj_args_t&);
+        typedef val_t (self_t::*new_list_t)(const TreeAST::NodeList*, const obj_args_t&);
 
-        new_funcs_t(const char* _name) :
-            name(_name), new_node(nullptr), new_list(nullptr)
-        {}
-
-        new_funcs_t(const char* _name, new_node_t _new_node, new_list_t _new_list) :
+        constexpr new_funcs_t(const char* _name, new_node_t _new_node, new_list_t _new_list) :
             name(_name), new_node(_new_node), new_list(_new_list)
         {}
 
@@ -1149,48 +1635,48 @@ protected:
         new_list_t  new_list;
     };
 
+public:
+    // stev: each extension asserts this upon
+    // defining its 'type_names' and 'new_funcs'
+    static constexpr bool check_type_names()
+    { return self_t::type_names.check(self_t::new_funcs); }
+
 private:
     self_t* self() { return static_cast<self_t*>(this); }
 
-    static const new_funcs_t* find(const char* name);
+    const new_funcs_t* find(const TreeAST::Node* node, const char* name) const;
 };
 
 template<typename M, typename T>
-const typename BasicMaker<M, T>::new_funcs_t* BasicMaker<M, T>::find(
-    const char* name)
-{
-    using namespace std;
-    static const new_funcs_t* cache = nullptr;
-    if (cache && strcmp(cache->name, name) == 0)
-        return cache;
-    auto beg = self_t::new_funcs;
-    auto end = beg + self_t::n_new_func;
-    auto rng = equal_range(beg, end, name,
-        [](const new_funcs_t& a, const new_funcs_t& b)
-            { return strcmp(a.name, b.name) < 0; });
-    SYS_ASSERT(
-        rng.second == rng.first ||
-        rng.second == rng.first + 1);
-    if (rng.second == rng.first)
-        error("unknown AST type name '%s'", name);
-    size_t k = Ext::ptr_diff(rng.first, beg);
+inline const typename BasicMaker<M, T>::new_funcs_t* BasicMaker<M, T>::find(
+    const TreeAST::Node* node, const char* name) const
+{
+    SYS_ASSERT(self_t::type_names.n_name == self_t::n_new_func);
+    auto k = self_t::type_names.find(name);
+    if (k == type_names_t::npos) {
+        // stev: returns only when validating
+        this->report(diag_t(diag_t::unknown_type, node,
+            nullptr, nullptr, 0, 0, name));
+        return nullptr;
+    }
     SYS_ASSERT(k < self_t::n_new_func);
-    cache = &self_t::new_funcs[k];
-    return cache;
+    return &self_t::new_funcs[k];
 }
 
 template<typename M, typename T>
 typename BasicMaker<M, T>::val_t BasicMaker<M, T>::make_node(
-    const TreeAST::TreeNode* node, obj_stack_t& args)
+    const TreeAST::TreeNode* node, const obj_args_t& args)
 {
-    return (self()->*find(node->name->ident)->new_node)(node, args);
+    auto f = find(node, node->name->ident);
+    return f ? (self()->*f->new_node)(node, args) : unknown_obj<val_t>();
 }
 
 template<typename M, typename T>
 typename BasicMaker<M, T>::val_t BasicMaker<M, T>::make_list(
-    const TreeAST::NodeList* list, obj_stack_t& args)
+    const TreeAST::NodeList* list, const obj_args_t& args)
 {
-    return (self()->*find(list->base->ident)->new_list)(list, args);
+    auto f = find(list, list->base->ident);
+    return f ? (self()->*f->new_list)(list, args) : unknown_obj<val_t>();
 }
 
 template<typename M, typename T>
@@ -1203,18 +1689,24 @@ typename BasicMaker<M, T>::val_t BasicMaker<M, T>::make_cptr(
 struct print_info_t
 {
     print_info_t() :
-        verbose(false)
+        verbose(false),
+        detached(false)
     {}
 
-    print_info_t(bool _verbose) :
-        verbose(_verbose)
+    print_info_t(bool _verbose, bool _detached = false) :
+        verbose(_verbose),
+        detached(_detached)
     {}
 
     print_info_t(const eval_opts_t& opt) :
-        verbose(opt.verbose)
+        verbose(opt.verbose),
+        detached(false)
     {}
 
     bool verbose;
+    // stev: the payloads of the objects printed are not
+    // to be dereferenced -- e.g. when decoding a trace
+    bool detached;
 };
 
 template<typename T>
@@ -52,6 +52,8 @@ $(BIN): ast-base.o ${AST_OBJS} $(TREE)
 
 $(MODS): $(BIN)
 
+$(OBJS): CFLAGS += -fvisibility=hidden -fvisibility-inlines-hidden
+
 # building rules
 
 $(GRAM_OBJS): %.o: ${GRAM_DIR}/%.cpp
@@ -25,10 +25,10 @@ enum {
     no_input_given,
 };
 
-static inline void print_error(const char* err, ...)
-    PRINTF_FMT(1);
+static inline void print_error(std::ostream& ost, const char* err, ...)
+    PRINTF_FMT(2);
 
-static inline void print_error(const char* err, ...)
+static inline void print_error(std::ostream& ost, const char* err, ...)
 {
     va_list args;
 
@@ -36,22 +36,21 @@ static inline void print_error(const char* err, ...)
     auto r = Sys::svformat(err, args);
     va_end(args);
 
-    std::cerr
-        << program << ": "
+    ost << program << ": "
         << extension << ": error: "
         << r << std::endl;
 }
 
 template<size_t E>
-void print_error();
+void print_error(std::ostream& ost);
 
 template<>
-inline void print_error<ext_func_not_supported>()
-{ print_error("extension functions are not supported"); }
+inline void print_error<ext_func_not_supported>(std::ostream& ost)
+{ print_error(ost, "extension functions are not supported"); }
 
 template<>
-inline void print_error<no_input_given>()
-{ print_error("no input given"); }
+inline void print_error<no_input_given>(std::ostream& ost)
+{ print_error(ost, "no input given"); }
 
 } // namespace ExtErr
 
@@ -0,0 +1,238 @@
+// Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+// 
+// This file is part of C++Py-Tree.
+// 
+// C++Py-Tree is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// C++Py-Tree is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __EXT_EVAL_IMPL_HPP
+#define __EXT_EVAL_IMPL_HPP
+
+// stev: the part of the implementation of the extension functions
+// which doesn't depend on the target AST of the extension module:
+// type checking, validating, printing the AST types and decoding
+// evaluation traces; the type makers 'M' below are constructible
+// from a 'type_cast_info_t' and an optional 'diags_t' pointer
+
+#include "sys.hpp"
+#include "eval.hpp"
+#include "opts.hpp"
+#include "cache.hpp"
+
+#include "ext-err-impl.hpp"
+
+namespace Obj {
+
+inline type_cast_info_t type_cast_info(const options_t* opt)
+{
+    return type_cast_info_t(
+        opt->casts_type == options_t::strict_casts);
+}
+
+// stev: the binary trace file is opened by the first evaluation
+// asking for it and is appended to by the evaluations of all the
+// inputs of the driver's options -- those of the run of 'tree' or
+// of one request of 'tree --serve'; the file gets closed together
+// with these options
+
+inline trace_t* eval_trace(const options_t* opt)
+{
+    if (opt->trace_file == nullptr)
+        return nullptr;
+    auto& state = opt->parent->ext_state;
+    if (!state)
+        state = std::make_shared<trace_t>(opt->trace_file);
+    return static_cast<trace_t*>(state.get());
+}
+
+// stev: the evaluator's stack holds at most one object
+// for each 'TreeNode', 'NodeList' and 'Literal' node of
+// the tree AST -- unless hash-consing made some shared
+
+inline eval_opts_t eval_opts(const TreeAST::AST* ast, const options_t* opt)
+{
+    using namespace TreeAST;
+
+    return eval_opts_t (
+        opt->trace_eval,
+        opt->verbose,
+        ast->count<TreeNode>() +
+        ast->count<NodeList>() +
+        ast->count<Literal>(),
+        eval_trace(opt),
+        opt->out);
+}
+
+inline print_info_t print_info(const options_t* opt)
+{
+    return print_info_t(
+        opt->verbose);
+}
+
+template<typename M>
+class type_session_t
+{
+public:
+    explicit type_session_t(const options_t* opt) :
+        maker(type_cast_info(opt)),
+        session(&maker)
+    {}
+
+    obj_type_t eval(const TreeAST::Tree* tree, const eval_opts_t& opt)
+    { return session.eval(tree, opt); }
+
+    // stev: one session per cast mode, for the requests
+    // of 'tree --serve' may each ask for another mode, and
+    // per thread, for the threads may evaluate concurrently
+    static type_session_t& instance(const options_t* opt)
+    {
+        static thread_local std::unique_ptr<type_session_t> sessions[2];
+        auto& session = sessions[
+            opt->casts_type == options_t::strict_casts];
+        if (!session)
+            session.reset(new type_session_t(opt));
+        return *session;
+    }
+
+private:
+    M                          maker;
+    eval_session_t<obj_type_t> session;
+};
+
+typedef Sys::ext_func_result_t (*exec_func_t)(
+    const TreeAST::AST*, const TreeAST::Tree*, const options_t*);
+
+template<typename M>
+inline Sys::ext_func_result_t exec_type_check(
+    const TreeAST::AST* tree_ast, const TreeAST::Tree* tree, const options_t* opt)
+{
+    // stev: record the verdict of the type check into the type
+    // cache of the driver program -- if there is any in place;
+    // the trace of the evaluation is not part of the verdict
+    auto cache = !opt->trace_eval && !opt->trace_file;
+    auto obj = [&]() {
+        try {
+            return type_session_t<M>::instance(opt).eval(
+                tree, eval_opts(tree_ast, opt));
+        }
+        catch (const ObjError& err) {
+            if (cache)
+                Tree::TypeCache::record(1, err.what());
+            throw;
+        }
+    }();
+
+    std::ostringstream ost;
+    ost << print(obj, print_info(opt));
+    if (cache)
+        Tree::TypeCache::record(0, ost.str());
+
+    *opt->out << ost.str() << std::endl;
+
+    return 0;
+}
+
+// stev: type-check 'tree' pushing its type errors onto 'diags'
+// instead of throwing the first one; return whether none was found
+
+template<typename M>
+inline bool validate(const TreeAST::Tree* tree, const type_cast_info_t& info,
+    const eval_opts_t& opt, diags_t& diags)
+{
+    M maker(info, &diags);
+    eval<obj_type_t>(tree, &maker, opt);
+    return diags.empty();
+}
+
+template<typename M>
+inline Sys::ext_func_result_t exec_validate(
+    const TreeAST::AST* tree_ast, const TreeAST::Tree* tree, const options_t* opt)
+{
+    diags_t diags;
+    if (validate<M>(tree, type_cast_info(opt), eval_opts(tree_ast, opt), diags))
+        return 0;
+
+    diags.print(*opt->err,
+        std::string(program).append(": error: ").c_str(),
+        tree);
+
+    return 1;
+}
+
+} // namespace Obj
+
+namespace ExtErr {
+
+enum {
+    invalid_root_node_type = no_input_given + 1,
+    no_trace_file_given,
+};
+
+template<size_t E>
+void print_error(std::ostream& ost, const TreeAST::Node* node);
+
+template<>
+inline void print_error<invalid_root_node_type>(
+    std::ostream& ost, const TreeAST::Node* node)
+{ print_error(ost, "invalid root node type: %s", node->name()); }
+
+template<>
+inline void print_error<no_trace_file_given>(std::ostream& ost)
+{ print_error(ost, "no trace file given"); }
+
+} // namespace ExtErr
+
+namespace Obj {
+
+// stev: 'funcs' is indexed by the actions of 'options_t' from
+// 'ext_func_action' on; the actions which need no input are done
+// prior to checking the input; 'ast_type_t::types' must be in place
+
+template<size_t N>
+inline Sys::ext_func_result_t ext_func_dispatch(
+    const TreeAST::AST* ast, const Tree::options_t* opts,
+    const options_t* opt, exec_func_t const (&funcs)[N])
+{
+    if (opt->action == options_t::print_types_action) {
+        ast_type_t::print_types(*opt->out);
+        return 0;
+    }
+    if (opt->action == options_t::decode_trace_action) {
+        if (opt->trace_file == nullptr) {
+            using namespace ExtErr;
+            print_error<no_trace_file_given>(*opt->err);
+            return 1;
+        }
+        trace_t::decode(opt->trace_file, *opt->out, print_info(opt));
+        return 0;
+    }
+    if (ast == nullptr || opts->argc == 0) {
+        using namespace ExtErr;
+        print_error<no_input_given>(*opt->err);
+        return 1;
+    }
+
+    auto tree = TreeAST::node_cast<TreeAST::Tree>(ast->root_node());
+    if (tree == nullptr) {
+        using namespace ExtErr;
+        print_error<invalid_root_node_type>(*opt->err, ast->root_node());
+        return 1;
+    }
+
+    return Ext::array(funcs)[
+        opt->action - options_t::ext_func_action](ast, tree, opt);
+}
+
+} // namespace Obj
+
+#endif /* __EXT_EVAL_IMPL_HPP */
@@ -18,7 +18,10 @@
 #ifndef __EXT_PRINTER_IMPL_HPP
 #define __EXT_PRINTER_IMPL_HPP
 
+#include <sstream>
+
 #include "tree/opts.hpp"
+#include "tree/api.hpp"
 #include "tree/ext-err-impl.hpp"
 
 static inline Sys::ext_func_result_t ext_print_func_entry(
@@ -26,19 +29,36 @@ static inline Sys::ext_func_result_t ext_print_func_entry(
 {
     if (opt->action == Obj::options_t::ext_func_action) {
         using namespace ExtErr;
-        print_error<ext_func_not_supported>();
+        print_error<ext_func_not_supported>(*opt->err);
         return 1;
     }
     if (obj == nullptr) {
         using namespace ExtErr;
-        print_error<no_input_given>();
+        print_error<no_input_given>(*opt->err);
         return 1;
     }
     if (!opt->help_ext_func)
-        AST::Printer(std::cout).print(obj);
+        AST::Printer(*opt->out).print(obj);
     return 0;
 }
 
+// stev: the entry of the functions '*_print' of "api.h"
+
+static inline int ext_print_api_entry(
+    const AST::Node* obj, char* buf, size_t size, size_t* len)
+try {
+    SYS_ASSERT(obj != nullptr);
+    std::ostringstream ost;
+    AST::Printer(ost).print(obj);
+    auto text = ost.str();
+    if (!text.empty() && text.back() == '\n')
+        text.pop_back();
+    return Api::put_text(0, text, buf, size, len);
+}
+catch (const std::exception& err) {
+    return Api::put_text(1, err.what(), buf, size, len);
+}
+
 #endif /* __EXT_PRINTER_IMPL_HPP */
 
 
@@ -66,7 +66,7 @@ protected:
     typedef typename base_t::Level Level;
 
     void print(const root_t* root)
-    { base_t::print(root); std::cout << std::endl; }
+    { base_t::print(root); ost << std::endl; }
 
     void print_attr(const char* attr)
     { ost << '.' << attr << "="; }
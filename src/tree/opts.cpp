@@ -25,14 +25,23 @@ namespace Obj {
 
 options_t::options_t() :
     casts_type(strict_casts),
-    trace_eval(false)
+    trace_eval(false),
+    hash_cons(false),
+    extract(false),
+    mem_stats(false),
+    fingerprint(false),
+    trace_file(nullptr),
+    parent(nullptr)
 {
     action = type_check_action;
 }
 
-void options_t::parse(const Tree::options_t* parent)
+void options_t::parse(const Tree::options_t* _parent)
 {
+    parent = _parent;
     base_t::parse(parent->ext_argc, parent->ext_argv);
+    out = parent->out;
+    err = parent->err;
 #ifdef DEBUG
     debug |= parent->debug_ext_func;
 #endif
@@ -44,27 +53,42 @@ void options_t::parse(const Tree::options_t* parent)
 
 const options_t* options_t::options(const Tree::options_t* parent)
 {
-    static options_t opts;
-    opts.parse(parent);
-    return &opts;
+    // stev: the options are parsed anew on each call, for the
+    // requests of 'tree --serve' carry arguments of their own;
+    // these are valid until the next call of the same thread
+    static thread_local std::unique_ptr<options_t> opts;
+    opts.reset(new options_t);
+    opts->parse(parent);
+    return opts.get();
 }
 
 void options_t::collect_opts(
     std::vector<char>& res_short_opts,
     std::vector<struct option>& res_long_opts) const
 {
-    static const char short_opts[] = "cAorstT";
+    static const char short_opts[] = "cVAHorstT";
     static const auto n_short_opts = Ext::array_size(short_opts) - 1;
 
     static struct option long_opts[] = {
-        { "type-check",    0, nullptr, opt_type_t::type_check },
-        { "ast-build",     0, nullptr, opt_type_t::ast_build },
-        { "print-obj",     0, nullptr, opt_type_t::print_obj },
-        { "print-types",   0, nullptr, opt_type_t::print_types },
-        { "relaxed-casts", 0, nullptr, opt_type_t::relaxed_casts },
-        { "strict-casts",  0, nullptr, opt_type_t::strict_casts },
-        { "trace-eval",    0, nullptr, opt_type_t::trace_eval },
-        { "no-trace-eval", 0, nullptr, opt_type_t::no_trace_eval },
+        { "type-check",     0, nullptr, opt_type_t::type_check },
+        { "validate",       0, nullptr, opt_type_t::validate },
+        { "ast-build",      0, nullptr, opt_type_t::ast_build },
+        { "print-obj",      0, nullptr, opt_type_t::print_obj },
+        { "print-types",    0, nullptr, opt_type_t::print_types },
+        { "relaxed-casts",  0, nullptr, opt_type_t::relaxed_casts },
+        { "strict-casts",   0, nullptr, opt_type_t::strict_casts },
+        { "trace-eval",     0, nullptr, opt_type_t::trace_eval },
+        { "no-trace-eval",  0, nullptr, opt_type_t::no_trace_eval },
+        { "hash-cons",      0, nullptr, opt_type_t::hash_cons },
+        { "no-hash-cons",   0, nullptr, opt_type_t::no_hash_cons },
+        { "extract",        0, nullptr, opt_type_t::extract },
+        { "no-extract",     0, nullptr, opt_type_t::no_extract },
+        { "mem-stats",      0, nullptr, opt_type_t::mem_stats },
+        { "no-mem-stats",   0, nullptr, opt_type_t::no_mem_stats },
+        { "fingerprint",    0, nullptr, opt_type_t::fingerprint },
+        { "no-fingerprint", 0, nullptr, opt_type_t::no_fingerprint },
+        { "trace-file",     1, nullptr, opt_type_t::trace_file },
+        { "decode-trace",   0, nullptr, opt_type_t::decode_trace },
     };
     static const auto n_long_opts = Ext::array_size(long_opts);
 
@@ -79,9 +103,11 @@ void options_t::usage_acts() const
     using namespace std;	
     cout
         << "  -c|--type-check      type check given input (default)" << endl
+        << "  -V|--validate        type check given input reporting all type errors" << endl
         << "  -A|--ast-build       build the AST object of given input" << endl
         << "  -t|--print-types     output the AST type definitions of given module" << endl
-        << "  -o|--print-obj       build and print the AST object of given input" << endl;
+        << "  -o|--print-obj       build and print the AST object of given input" << endl
+        << "     --decode-trace    print out in text the binary evaluation trace of '--trace-file'" << endl;
 }
 
 void options_t::usage_opts() const
@@ -92,7 +118,16 @@ void options_t::usage_opts() const
         << "  -r|--relaxed-casts   when evaluating AST objects make polymorphic type casts" << endl
         << "  -s|--strict-casts    when evaluating AST objects make exact type casts (default)" << endl
         << "  -T|--trace-eval      trace or not the tree evaluation algorithm (default not)" << endl
-        << "     --no-trace-eval" << endl;
+        << "     --no-trace-eval" << endl
+        << "  -H|--hash-cons       hash-cons or not the built AST (default not)" << endl
+        << "     --no-hash-cons" << endl
+        << "     --extract         extract or not the built AST into a copy having pools sized to fit (default not)" << endl
+        << "     --no-extract" << endl
+        << "     --mem-stats       print or not memory statistics of the built AST (default not)" << endl
+        << "     --no-mem-stats" << endl
+        << "     --fingerprint     print or not the structural fingerprint of the built AST (default not)" << endl
+        << "     --no-fingerprint" << endl
+        << "     --trace-file=FILE write the binary trace of the tree evaluation algorithm into FILE" << endl;
 }
 
 void options_t::dump_opts() const
@@ -105,16 +140,23 @@ void options_t::dump_opts() const
     using namespace std;
     cout
         << "casts-type:     " << Ext::array(casts_types)[casts_type] << endl
-        << "trace-eval:     " << Ext::array(noyes)[trace_eval] << endl;
+        << "trace-eval:     " << Ext::array(noyes)[trace_eval] << endl
+        << "hash-cons:      " << Ext::array(noyes)[hash_cons] << endl
+        << "extract:        " << Ext::array(noyes)[extract] << endl
+        << "mem-stats:      " << Ext::array(noyes)[mem_stats] << endl
+        << "fingerprint:    " << Ext::array(noyes)[fingerprint] << endl
+        << "trace-file:     " << (trace_file ? trace_file : "-") << endl;
 }
 
 const char* options_t::act_name() const
 {
     static char const* actions[] = {
-        "type-check",  // type_check_action
-        "ast-build",   // ast_build_action
-        "print-obj",   // print_obj_action
-        "print-types", // print_types_action
+        "type-check",   // type_check_action
+        "validate",     // validate_action
+        "ast-build",    // ast_build_action
+        "print-obj",    // print_obj_action
+        "print-types",  // print_types_action
+        "decode-trace", // decode_trace_action
     };
     return action >= type_check_action
         ? Ext::array(actions)[action - type_check_action]
@@ -126,6 +168,7 @@ const char* options_t::get_ext_func_name() const
     static const char* ext_funcs[] = {
         "printer::print", // action_t::print_obj_action
         nullptr,          // action_t::print_types_action
+        nullptr,          // action_t::decode_trace_action
     };
     return action >= print_obj_action
         ? Ext::array(ext_funcs)[action - print_obj_action]
@@ -140,6 +183,9 @@ bool options_t::parse_opt(opt_t opt, const char* opt_arg)
     case opt_type_t::type_check:
         action = type_check_action;
         break;
+    case opt_type_t::validate:
+        action = validate_action;
+        break;
     case opt_type_t::ast_build:
         action = ast_build_action;
         break;
@@ -161,6 +207,36 @@ bool options_t::parse_opt(opt_t opt, const char* opt_arg)
     case opt_type_t::no_trace_eval:
         trace_eval = false;
         break;
+    case opt_type_t::hash_cons:
+        hash_cons = true;
+        break;
+    case opt_type_t::no_hash_cons:
+        hash_cons = false;
+        break;
+    case opt_type_t::extract:
+        extract = true;
+        break;
+    case opt_type_t::no_extract:
+        extract = false;
+        break;
+    case opt_type_t::mem_stats:
+        mem_stats = true;
+        break;
+    case opt_type_t::no_mem_stats:
+        mem_stats = false;
+        break;
+    case opt_type_t::fingerprint:
+        fingerprint = true;
+        break;
+    case opt_type_t::no_fingerprint:
+        fingerprint = false;
+        break;
+    case opt_type_t::trace_file:
+        trace_file = opt_arg;
+        break;
+    case opt_type_t::decode_trace:
+        action = decode_trace_action;
+        break;
     default:
         return false;
     }
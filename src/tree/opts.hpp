@@ -31,9 +31,11 @@ public:
     typedef Opts::options_t base_t;
     enum {
         type_check_action = base_t::ext_func_action + 1,
+        validate_action,
         ast_build_action,
         print_obj_action,
         print_types_action,
+        decode_trace_action,
     };
 
     enum casts_type_t {
@@ -43,6 +45,12 @@ public:
 
     casts_type_t casts_type;
     bool trace_eval;
+    bool hash_cons;
+    bool extract;
+    bool mem_stats;
+    bool fingerprint;
+    const char* trace_file;
+    const Tree::options_t* parent;
 
     const char* act_name() const;
 
@@ -52,14 +60,25 @@ protected:
     struct opt_type_t : base_t::opt_type_t
     {
         enum {
-            type_check    = 'c',
-            ast_build     = 'A',
-            print_obj     = 'o',
-            print_types   = 't',
-            relaxed_casts = 'r',
-            strict_casts  = 's',
-            trace_eval    = 'T',
-            no_trace_eval = 127,
+            type_check     = 'c',
+            validate       = 'V',
+            ast_build      = 'A',
+            print_obj      = 'o',
+            print_types    = 't',
+            relaxed_casts  = 'r',
+            strict_casts   = 's',
+            trace_eval     = 'T',
+            no_trace_eval  = 127,
+            hash_cons      = 'H',
+            no_hash_cons   = 128,
+            extract        = 133,
+            no_extract     = 134,
+            mem_stats      = 129,
+            no_mem_stats   = 130,
+            fingerprint    = 131,
+            no_fingerprint = 132,
+            trace_file     = 135,
+            decode_trace   = 136,
         };
     };
 
@@ -54,6 +54,8 @@ Parser::Parser(
     bool _debug,
 #endif
     bool _verbose_error,
+    bool _hash_cons,
+    bool _fingerprints,
     input_type_t _input_type,
     const char* _input_name,
     const char* _input) :
@@ -66,6 +68,8 @@ Parser::Parser(
         _input),
     input_beg(nullptr),
     verbose_error(_verbose_error),
+    hash_cons(_hash_cons),
+    fingerprints(_fingerprints),
     arg_ctxt(false),
     ast(nullptr)
 { input_beg = input_ptr; }
@@ -182,6 +186,12 @@ inline bool Parser::istoken(const range_t& rng, const char* tok, size_t len)
     return rng.size() == len && memcmp(rng.beg, tok, len) == 0;
 }
 
+template<typename L>
+static inline AST::str_t lex_str(const L& lex)
+{
+    return AST::str_t(lex.get(), lex.size());
+}
+
 static inline bool is_plain_char(char ch)
 {
     return isascii(ch) && !iscntrl(ch);
@@ -418,6 +428,8 @@ std::unique_ptr<AST::AST> Parser::parse()
     );
 
     this->ast = ast.get();
+    this->ast->hash_cons(hash_cons);
+    this->ast->fingerprints(fingerprints);
 
     struct Cleanup
     {
@@ -500,7 +512,7 @@ const AST::NodeName* Parser::parse_node_name()
         dump(__func__);
 #endif
     need_token(token_type_t::ident);
-    return ast->new_nodename(prev_tok.lex);
+    return ast->new_nodename(lex_str(prev_tok.lex));
 }
 
 // <NodeArgs> node_args
@@ -565,7 +577,7 @@ const AST::ArgName* Parser::parse_arg_name()
         dump(__func__);
 #endif
     need_token(token_type_t::name);
-    return ast->new_argname(prev_tok.lex);
+    return ast->new_argname(lex_str(prev_tok.lex));
 }
 
 // <ArgValue> arg_value
@@ -638,7 +650,7 @@ const AST::Literal* Parser::parse_literal()
         dump(__func__);
 #endif
     need_token(token_type_t::str);
-    return ast->new_literal(prev_tok.lex);
+    return ast->new_literal(lex_str(prev_tok.lex));
 }
 // < PARSER_METHOD_IMPL
 
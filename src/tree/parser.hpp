@@ -72,6 +72,8 @@ public:
         bool _debug,
 #endif
         bool _verbose_error,
+        bool _hash_cons,
+        bool _fingerprints,
         input_type_t _input_type,
         const char* _input_name,
         const char* _input);
@@ -155,6 +157,8 @@ private:
     ln_ptrs_t   ln_ptrs;
     const char *input_beg;
     const bool  verbose_error;
+    const bool  hash_cons;
+    const bool  fingerprints;
     bool        arg_ctxt;
     AST::AST   *ast;
 
@@ -0,0 +1,259 @@
+// Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+//
+// This file is part of C++Py-Tree.
+//
+// C++Py-Tree is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// C++Py-Tree is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <cstdint>
+
+#include <getopt.h>
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "sys.hpp"
+
+extern const char program[];
+extern const char verdate[];
+extern const char license[];
+
+const char program[] = "tree-phash";
+const char verdate[] = "0.1 -- 2021-05-30 11:02"; // $ date +'%F %R'
+
+const char license[] =
+"Copyright (C) 2016, 2017, 2021  Stefan Vargyas.\n"
+"License GPLv3+: GNU GPL version 3 or later <http://gnu.org/licenses/gpl.html>.\n"
+"This is free software: you are free to change and redistribute it.\n"
+"There is NO WARRANTY, to the extent permitted by law.\n";
+
+namespace PHash {
+
+struct Error : public std::runtime_error
+{
+    Error(const std::string& msg) :
+        std::runtime_error(msg)
+    {}
+};
+
+struct options_t
+{
+    options_t() :
+        bits(0)
+    {}
+
+    unsigned bits;
+
+    std::vector<std::string> names;
+
+    void parse(int argc, char* argv[]);
+};
+
+static void usage()
+{
+    using namespace std;
+    cout
+        << "usage: " << program << " [OPTION]... NAME..." << endl
+        << "where the options are:" << endl
+        << "  -b|--bits=NUM    use 2^NUM slots (default: the least number of slots" << endl
+        << "                     exceeding the number of names)" << endl
+        << "     --version     print version numbers and exit" << endl
+        << "  -?|--help        display this help info and exit" << endl
+        << "print out the tables 'type_names', 'type_slots' and 'type_seed' by which" << endl
+        << "'type_names_t' of 'eval.hpp' maps each NAME -- taken in the order given --" << endl
+        << "to its index; the seed is the least odd one making a perfect hash" << endl;
+}
+
+static void version()
+{
+    std::cout << program << ": version " << verdate << "\n\n" << license;
+}
+
+// stev: the slots are of type 'unsigned char'
+// and one of them is left empty
+
+static const unsigned max_bits = 8;
+
+static unsigned parse_bits(const char* opt_arg)
+{
+    char* end;
+    errno = 0;
+    auto n = strtoul(opt_arg, &end, 10);
+    if (errno || *end || !isdigit(*opt_arg) || n < 1 || n > max_bits)
+        throw Error(Sys::format(
+            "invalid argument for 'bits' option: '%s'", opt_arg));
+    return n;
+}
+
+void options_t::parse(int argc, char* argv[])
+{
+    static const struct option long_opts[] = {
+        { "bits",    1, nullptr, 'b' },
+        { "version", 0, nullptr, 'v' },
+        { "help",    0, nullptr, 'h' },
+        { nullptr,   0, nullptr, 0 }
+    };
+
+    int opt;
+    opterr = 0;
+    while ((opt = getopt_long(
+        argc, argv, ":b:", long_opts, nullptr)) != EOF) {
+        switch (opt) {
+        case 'b':
+            bits = parse_bits(optarg);
+            break;
+        case 'v':
+            version();
+            exit(0);
+        case ':':
+            throw Error(Sys::format(
+                "argument for option '%s' not found", argv[optind - 1]));
+        case 'h':
+            usage();
+            exit(0);
+        case '?':
+            if (optopt == '?') {
+                usage();
+                exit(0);
+            }
+            throw Error(Sys::format(
+                "invalid command line option '%s'", argv[optind - 1]));
+        default:
+            SYS_UNEXPECT_ERR("opt='%c'", opt);
+        }
+    }
+    names.assign(argv + optind, argv + argc);
+
+    if (names.empty())
+        throw Error("no name given");
+    for (auto i = names.begin(); i < names.end(); i ++) {
+        if (i->empty())
+            throw Error("empty name given");
+        if (std::find(names.begin(), i, *i) != i)
+            throw Error(Sys::format(
+                "name '%s' given twice", i->c_str()));
+    }
+    if (bits == 0) {
+        while (bits < max_bits && (size_t(1) << bits) <= names.size())
+            bits ++;
+    }
+    if ((size_t(1) << bits) <= names.size())
+        throw Error(Sys::format(
+            "too many names for %zu slots", size_t(1) << bits));
+}
+
+// stev: the hash and the slot function below are
+// those of 'type_names_t' -- which 'check' verifies
+// upon compiling the tables printed out
+
+static uint32_t hash(const char* str)
+{
+    uint32_t h = 2166136261u;
+    for (; *str; str ++)
+        h = (h ^ static_cast<unsigned char>(*str)) * 16777619u;
+    return h;
+}
+
+static inline size_t slot(uint32_t hash, uint32_t seed, unsigned bits)
+{ return static_cast<uint32_t>(hash * seed) >> (32 - bits); }
+
+// stev: the search is plain trial of odd seeds;
+// 'used' is a bitmap of the at most 256 slots
+
+static bool search(
+    const std::vector<uint32_t>& hashes, unsigned bits, uint32_t& seed)
+{
+    const auto b = hashes.data();
+    const auto e = b + hashes.size();
+    const unsigned shift = 32 - bits;
+    uint32_t s = 1;
+    do {
+        uint64_t used[4] = {0, 0, 0, 0};
+        auto h = b;
+        for (; h < e; h ++) {
+            uint32_t k = (*h * s) >> shift;
+            uint64_t m = uint64_t(1) << (k & 63);
+            if (used[k >> 6] & m)
+                break;
+            used[k >> 6] |= m;
+        }
+        if (h == e) {
+            seed = s;
+            return true;
+        }
+    }
+    while ((s += 2) != 1);
+    return false;
+}
+
+static void print(
+    const std::vector<std::string>& names,
+    const std::vector<uint32_t>& hashes,
+    unsigned bits, uint32_t seed)
+{
+    using namespace std;
+
+    auto n = names.size();
+    vector<size_t> slots(size_t(1) << bits, n);
+    for (size_t k = 0; k < n; k ++)
+        slots[slot(hashes[k], seed, bits)] = k;
+
+    cout << "static constexpr const char* type_names[] = {\n";
+    for (const auto& s : names)
+        cout << "    \"" << s << "\",\n";
+    cout << "    \"\"\n"
+         << "};\n\n"
+         << "static constexpr type_names_t::slot_t type_slots[] = {";
+    auto w = to_string(n).size();
+    for (size_t k = 0; k < slots.size(); k ++) {
+        cout << (k ? "," : "") << (k % 16 ? " " : "\n    ")
+             << setw(w) << slots[k];
+    }
+    cout << "\n"
+         << "};\n\n"
+         << "static constexpr uint32_t type_seed = " << seed << ";\n";
+}
+
+} // namespace PHash
+
+int main(int argc, char* argv[])
+try
+{
+    using namespace PHash;
+
+    options_t opts;
+    opts.parse(argc, argv);
+
+    std::vector<uint32_t> hashes;
+    for (const auto& s : opts.names)
+        hashes.push_back(hash(s.c_str()));
+
+    uint32_t seed;
+    if (!search(hashes, opts.bits, seed))
+        throw Error(Sys::format(
+            "no seed found for %zu slots", size_t(1) << opts.bits));
+
+    print(opts.names, hashes, opts.bits, seed);
+    return 0;
+}
+catch (const std::exception& exc) {
+    std::cerr << program << ": error: " << exc.what() << std::endl;
+    return 1;
+}
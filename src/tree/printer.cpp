@@ -22,6 +22,7 @@
 #include "std-ext.hpp"
 
 #include "ast.hpp"
+#include "compact.hpp"
 
 namespace AST {
 
@@ -53,6 +54,7 @@ public:
     };
 
     bool indent_dots;
+    bool compact;
 
     const char* act_name() const;
 
@@ -68,6 +70,8 @@ protected:
             terse_ast      = 'T',
             indent_dots    = 'i',
             no_indent_dots = 'I',
+            compact        = 'c',
+            no_compact     = 'C',
         };
     };
 
@@ -86,7 +90,8 @@ protected:
 };
 
 options_t::options_t() :
-    indent_dots(false)
+    indent_dots(false),
+    compact(false)
 {
     action = print_ast_action;
 }
@@ -94,6 +99,8 @@ options_t::options_t() :
 void options_t::parse(const Tree::options_t* parent)
 {
     base_t::parse(parent->ext_argc, parent->ext_argv);
+    out = parent->out;
+    err = parent->err;
 #ifdef DEBUG
     debug |= parent->debug_ext_func;
 #endif
@@ -105,16 +112,20 @@ void options_t::parse(const Tree::options_t* parent)
 
 const options_t* options_t::options(const Tree::options_t* parent)
 {
-    static options_t opts;
-    opts.parse(parent);
-    return &opts;
+    // stev: the options are parsed anew on each call, for the
+    // requests of 'tree --serve' carry arguments of their own;
+    // these are valid until the next call of the same thread
+    static thread_local std::unique_ptr<options_t> opts;
+    opts.reset(new options_t);
+    opts->parse(parent);
+    return opts.get();
 }
 
 void options_t::collect_opts(
     std::vector<char>& res_short_opts,
     std::vector<struct option>& res_long_opts) const
 {
-    static const char short_opts[] = "iIpPuT";
+    static const char short_opts[] = "cCiIpPuT";
     static const auto n_short_opts = Ext::array_size(short_opts) - 1;
 
     static struct option long_opts[] = {
@@ -124,6 +135,8 @@ void options_t::collect_opts(
         { "terse-ast",      0, nullptr, opt_type_t::terse_ast },
         { "indent-dots",    0, nullptr, opt_type_t::indent_dots },
         { "no-indent-dots", 0, nullptr, opt_type_t::no_indent_dots },
+        { "compact",        0, nullptr, opt_type_t::compact },
+        { "no-compact",     0, nullptr, opt_type_t::no_compact },
     };
     static const auto n_long_opts = Ext::array_size(long_opts);
 
@@ -149,7 +162,10 @@ void options_t::usage_opts() const
     using namespace std;
     cout
         << "  -i|--indent-dots     print or not indenting dots (default not)" << endl
-        << "  -I|--no-indent-dots" << endl;
+        << "  -I|--no-indent-dots" << endl
+        << "  -c|--compact         use or not the compact AST representation when printing" << endl
+        << "                         prettily or tersely (default not)" << endl
+        << "  -C|--no-compact" << endl;
 }
 
 void options_t::dump_opts() const
@@ -157,7 +173,8 @@ void options_t::dump_opts() const
     base_t::dump_opts();
     using namespace std;
     cout
-        << "indent-dots:    " << Ext::array(noyes)[indent_dots] << endl;
+        << "indent-dots:    " << Ext::array(noyes)[indent_dots] << endl
+        << "compact:        " << Ext::array(noyes)[compact] << endl;
 }
 
 const char* options_t::act_name() const
@@ -196,6 +213,12 @@ bool options_t::parse_opt(opt_t opt, const char* opt_arg)
     case opt_type_t::no_indent_dots:
         indent_dots = false;
         break;
+    case opt_type_t::compact:
+        compact = true;
+        break;
+    case opt_type_t::no_compact:
+        compact = false;
+        break;
     default:
         return false;
     }
@@ -797,19 +820,135 @@ void SourcePrinter::visit(const Tree* arg)
 }
 // <PRETTY_PRINTER_VISITOR_IMPL
 
+// stev: 'CompactPrinter' produces the very same output as
+// 'SourcePrinter', but out of a 'CompactTree' built of the AST
+
+class CompactPrinter
+{
+public:
+    CompactPrinter(std::ostream& _ost, const options_t* _opt, bool _pretty) :
+        ost(_ost),
+        opt(_opt),
+        pretty(_pretty),
+        level(0)
+    {}
+
+    void print(const AST* ast)
+    {
+        CompactTree tree(ast);
+        print(tree.root());
+        ost << std::endl;
+    }
+
+private:
+    typedef CompactTree::node_t node_t;
+    typedef CompactTree::child_iterator child_iterator;
+
+    void print(node_t);
+    void print(child_iterator, child_iterator);
+    void print_index(size_t);
+
+    void abstract(node_t);
+
+    DotsEndlPrint endl(short inc = 0) const
+    { return DotsEndlPrint(level + inc, opt->indent_dots); }
+
+    std::ostream&    ost;
+    const options_t* opt;
+    bool             pretty;
+    short            level;
+};
+
+inline void CompactPrinter::print_index(size_t idx)
+{
+    ost << '[' << idx << (pretty ? "] = " : "]=");
+}
+
+void CompactPrinter::print(child_iterator ptr, child_iterator end)
+{
+    level ++;
+    auto beg = ptr;
+    for (; ptr != end; ++ ptr) {
+        if (pretty)
+            ost << endl();
+        print(*ptr);
+    }
+    if (pretty && beg != end)
+        ost << endl(-1);
+    level --;
+}
+
+void CompactPrinter::abstract(node_t node)
+{
+    using TreeAST::error;
+    error("cannot visit abstract node '%s'", node.name());
+}
+
+void CompactPrinter::print(node_t node)
+{
+    auto ptr = node.begin();
+    switch (node.kind()) {
+    case AST::node_t::Literal:
+        ost << '\'' << node.str() << '\''; //!!!STR_QUOTE
+        break;
+    case AST::node_t::ListElem:
+        print_index(node.index());
+        print(*ptr);
+        break;
+    case AST::node_t::NodeName:
+        ost << node.str();
+        break;
+    case AST::node_t::NodeList:
+        ost << "list<";
+        print(*ptr ++);
+        ost << (pretty ? "> [" : ">[");
+        print(ptr, node.end());
+        ost << ']';
+        break;
+    case AST::node_t::ArgName:
+        ost << '.' << node.str() << (pretty ? " = " : "=");
+        break;
+    case AST::node_t::NodeValue:
+    case AST::node_t::ListValue:
+    case AST::node_t::LiteralValue:
+    case AST::node_t::LiteralArgs:
+    case AST::node_t::Tree:
+        print(*ptr);
+        break;
+    case AST::node_t::NodeArg:
+        print(*ptr ++);
+        print(*ptr);
+        break;
+    case AST::node_t::ListArgs:
+        print(ptr, node.end());
+        break;
+    case AST::node_t::TreeNode:
+        print(*ptr ++);
+        ost << '(';
+        print(*ptr);
+        ost << ')';
+        break;
+    default:
+        abstract(node);
+    }
+}
+
 } // namespace AST
 
 template<typename T>
 static void print(const TreeAST::AST* ast, const options_t* opt)
 {
     typedef T printer_t;
-    printer_t(std::cout, opt).print(ast);
+    printer_t(*opt->out, opt).print(ast);
 }
 
 template<bool pretty>
 static void source(const TreeAST::AST* ast, const options_t* opt)
 {
-    AST::SourcePrinter(std::cout, opt, pretty).print(ast);
+    if (opt->compact)
+        AST::CompactPrinter(*opt->out, opt, pretty).print(ast);
+    else
+        AST::SourcePrinter(*opt->out, opt, pretty).print(ast);
 }
 
 static Sys::ext_func_result_t exec(
@@ -820,12 +959,12 @@ static Sys::ext_func_result_t exec(
     auto opt = options_t::options(opts);
     if (opt->action == options_t::ext_func_action) {
         using namespace ExtErr;
-        print_error<ext_func_not_supported>();
+        print_error<ext_func_not_supported>(*opt->err);
         return 1;
     }
     if (ast == nullptr) {
         using namespace ExtErr;
-        print_error<no_input_given>();
+        print_error<no_input_given>(*opt->err);
         return 1;
     }
 
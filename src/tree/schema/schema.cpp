@@ -0,0 +1,669 @@
+// Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+// 
+// This file is part of C++Py-Tree.
+// 
+// C++Py-Tree is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// C++Py-Tree is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+#include "tree/tree.hpp"
+#include "tree/opts.hpp"
+#include "tree/ast.hpp"
+#include "tree/eval.hpp"
+
+const char program[] = "schema";
+const char verdate[] = "0.1 -- 2026-10-18 12:00"; // $ date +'%F %R'
+
+static const char extension[] = "schema";
+
+#include "tree/ext-eval-impl.hpp"
+
+namespace Schema {
+
+using Obj::ast_type_t;
+using Obj::cptr_type_t;
+using Obj::arg_def_t;
+using Obj::obj_type_t;
+
+class options_t : public Obj::options_t
+{
+public:
+    static const options_t* options(const Tree::options_t*);
+
+    typedef Obj::options_t base_t;
+
+    const char* schema;
+
+protected:
+    options_t();
+
+    struct opt_type_t : base_t::opt_type_t
+    {
+        enum {
+            schema = 138,
+        };
+    };
+
+    void collect_opts(
+        std::vector<char>& short_opts,
+        std::vector<struct option>& long_opts) const;
+    bool parse_opt(opt_t opt, const char* opt_arg);
+
+    void usage_opts() const;
+
+    void dump_opts() const;
+};
+
+options_t::options_t() :
+    schema(nullptr)
+{}
+
+const options_t* options_t::options(const Tree::options_t* parent)
+{
+    // stev: the options are parsed anew on each call, for the
+    // requests of 'tree --serve' carry arguments of their own;
+    // these are valid until the next call of the same thread
+    static thread_local std::unique_ptr<options_t> opts;
+    opts.reset(new options_t);
+    opts->parse(parent);
+    return opts.get();
+}
+
+void options_t::collect_opts(
+    std::vector<char>& res_short_opts,
+    std::vector<struct option>& res_long_opts) const
+{
+    static struct option long_opts[] = {
+        { "schema", 1, nullptr, opt_type_t::schema },
+    };
+    static const auto n_long_opts = Ext::array_size(long_opts);
+
+    base_t::collect_opts(res_short_opts, res_long_opts);
+    std::copy(long_opts, long_opts + n_long_opts, back_inserter(res_long_opts));
+}
+
+void options_t::usage_opts() const
+{
+    base_t::usage_opts();
+    using namespace std;
+    cout
+        << "     --schema=FILE     load the AST type definitions from the grammar file FILE" << endl;
+}
+
+void options_t::dump_opts() const
+{
+    base_t::dump_opts();
+    using namespace std;
+    cout
+        << "schema:         " << (schema ? schema : "-") << endl;
+}
+
+bool options_t::parse_opt(opt_t opt, const char* opt_arg)
+{
+    if (base_t::parse_opt(opt, opt_arg))
+        return true;
+    switch (opt) {
+    case opt_type_t::schema:
+        schema = opt_arg;
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+// stev: 'types_t' builds the table of AST types out of the type
+// definition lines of a grammar file -- the lines of form:
+//
+//   <Name> : Base @ <T>* [a], list<U> [b], <char*> [c];
+//
+// the rest of the lines -- the grammar rules included -- are skipped;
+// the types are kept in the order of their definitions; the names of
+// types are looked up in an open addressing hash table of FNV-1a hashes;
+// the subtyping relation is that of the 'enter'/'leave' intervals of
+// 'ast_type_t::init_types'; the 'cptr' types other than 'char*' accept
+// any literal, since their values are not converted by type checking
+
+class types_t
+{
+public:
+    explicit types_t(const char* _file);
+    ~types_t();
+
+    types_t(const types_t&) = delete;
+    types_t& operator=(const types_t&) = delete;
+
+    const ast_type_t* find(const char* name) const;
+
+    const ast_type_t* const* types() const
+    { return ptrs.data(); }
+
+    size_t size() const
+    { return ptrs.size(); }
+
+    // stev: load 'file' once, making its types those of the
+    // extension module; 'current' is the result of 'load' in
+    // the calling thread; the tables loaded are kept for the
+    // requests of 'tree --serve' naming the same schema files
+    // again, and are shared by the threads
+    static const types_t& load(const char* file);
+
+    static thread_local const types_t* current;
+
+private:
+    struct arg_t
+    {
+        enum kind_t { node, list, cptr };
+
+        kind_t      kind;
+        std::string type;
+        std::string name;
+    };
+
+    struct def_t
+    {
+        std::string        name;
+        std::string        base;
+        std::vector<arg_t> args;
+        size_t             line;
+    };
+
+    class parser_t;
+
+    typedef std::aligned_storage<
+        sizeof(ast_type_t), alignof(ast_type_t)>::type storage_t;
+
+    static const uint32_t npos = UINT32_MAX;
+
+    void error(size_t line, const char* msg, ...) const
+        PRINTF_FMT(3);
+
+    void parse();
+    void build();
+
+    uint32_t lookup(const char* name) const;
+    const ast_type_t* type_at(size_t k) const;
+    const ast_type_t* type_of(const def_t& def, const std::string& name) const;
+    const cptr_type_t* cptr_of(const std::string& name);
+
+    std::string                    file;
+    std::vector<def_t>             defs;
+    std::vector<uint32_t>          slots;
+    std::vector<arg_def_t>         args;
+    std::deque<cptr_type_t>        cptrs;
+    std::unique_ptr<storage_t[]>   store;
+    std::vector<const ast_type_t*> ptrs;
+};
+
+thread_local const types_t* types_t::current = nullptr;
+
+const uint32_t types_t::npos;
+
+void types_t::error(size_t line, const char* msg, ...) const
+{
+    va_list args;
+    va_start(args, msg);
+    auto err = Sys::vformat(msg, args);
+    va_end(args);
+
+    if (line)
+        Obj::error("schema: %s:%zu: %s", file.c_str(), line, err.c_str());
+    else
+        Obj::error("schema: %s: %s", file.c_str(), err.c_str());
+}
+
+class types_t::parser_t
+{
+public:
+    parser_t(const types_t* _types, const std::string& line, size_t _lno) :
+        types(_types),
+        ptr(line.c_str()),
+        lno(_lno)
+    {}
+
+    // stev: returns false on lines which are not type definitions
+    bool parse(def_t& def);
+
+private:
+    void space()
+    { while (isspace(*ptr)) ptr ++; }
+
+    bool peek(char c)
+    { space(); return *ptr == c; }
+
+    void expect(char c)
+    {
+        if (!peek(c))
+            types->error(lno, "expected '%c'", c);
+        ptr ++;
+    }
+
+    static bool is_ident(const std::string& str);
+
+    std::string ident();
+    std::string until(char c);
+
+    void arg(arg_t& res);
+
+    const types_t* types;
+    const char*    ptr;
+    size_t         lno;
+};
+
+bool types_t::parser_t::is_ident(const std::string& str)
+{
+    if (str.empty() || !(isalpha(str[0]) || str[0] == '_'))
+        return false;
+    for (auto c : str)
+        if (!(isalnum(c) || c == '_'))
+            return false;
+    return true;
+}
+
+std::string types_t::parser_t::ident()
+{
+    space();
+    auto beg = ptr;
+    while (isalnum(*ptr) || *ptr == '_')
+        ptr ++;
+    std::string res(beg, ptr);
+    if (!is_ident(res))
+        types->error(lno, "expected identifier");
+    return res;
+}
+
+std::string types_t::parser_t::until(char c)
+{
+    auto beg = ptr;
+    while (*ptr && *ptr != c)
+        ptr ++;
+    if (*ptr != c || ptr == beg)
+        types->error(lno, "expected type name");
+    return std::string(beg, ptr ++);
+}
+
+void types_t::parser_t::arg(arg_t& res)
+{
+    space();
+    if (*ptr == '<') {
+        ptr ++;
+        res.type = until('>');
+        if (*ptr == '*') {
+            ptr ++;
+            res.kind = arg_t::node;
+            if (!is_ident(res.type))
+                types->error(lno, "invalid type name '%s'", res.type.c_str());
+        }
+        else
+            res.kind = arg_t::cptr;
+    }
+    else
+    if (strncmp(ptr, "list", 4) == 0) {
+        ptr += 4;
+        expect('<');
+        res.type = ident();
+        expect('>');
+        res.kind = arg_t::list;
+    }
+    else
+        types->error(lno, "expected argument type");
+    expect('[');
+    res.name = ident();
+    expect(']');
+}
+
+bool types_t::parser_t::parse(def_t& def)
+{
+    if (!peek('<'))
+        return false;
+    ptr ++;
+    auto beg = ptr;
+    while (*ptr && *ptr != '>')
+        ptr ++;
+    if (*ptr != '>')
+        return false;
+    def.name.assign(beg, ptr ++);
+    // stev: the grammar rules go on by a rule name
+    if (!peek(';') && !peek(':'))
+        return false;
+    if (!is_ident(def.name))
+        types->error(lno, "invalid type name '%s'", def.name.c_str());
+    def.line = lno;
+    if (*ptr ++ == ':') {
+        def.base = ident();
+        if (peek('@')) {
+            ptr ++;
+            do {
+                def.args.emplace_back();
+                arg(def.args.back());
+            } while (peek(',') && ptr ++);
+        }
+        expect(';');
+    }
+    space();
+    if (*ptr && *ptr != '#')
+        types->error(lno, "unexpected '%c'", *ptr);
+    return true;
+}
+
+types_t::types_t(const char* _file) :
+    file(_file)
+{
+    parse();
+    build();
+}
+
+types_t::~types_t()
+{
+    for (auto p : ptrs)
+        p->~ast_type_t();
+}
+
+void types_t::parse()
+{
+    std::ifstream inp(file);
+    if (!inp)
+        error(0, "cannot open file: %s", strerror(errno));
+
+    std::string line;
+    size_t lno = 0;
+    def_t def;
+    while (std::getline(inp, line)) {
+        lno ++;
+        if (parser_t(this, line, lno).parse(def)) {
+            defs.push_back(std::move(def));
+            def = def_t();
+        }
+    }
+    if (inp.bad())
+        error(0, "cannot read file: %s", strerror(errno));
+    if (defs.empty())
+        error(0, "no type definitions found");
+}
+
+static uint32_t hash(const char* str)
+{
+    uint32_t h = 2166136261u;
+    for (; *str; str ++)
+        h = (h ^ static_cast<unsigned char>(*str)) * 16777619u;
+    return h;
+}
+
+uint32_t types_t::lookup(const char* name) const
+{
+    const size_t mask = slots.size() - 1;
+    for (size_t i = hash(name) & mask;; i = (i + 1) & mask) {
+        auto k = slots[i];
+        if (k == npos || defs[k].name == name)
+            return k;
+    }
+}
+
+const ast_type_t* types_t::find(const char* name) const
+{
+    auto k = lookup(name);
+    return k != npos ? ptrs[k] : nullptr;
+}
+
+// stev: the types are referred to prior to being constructed
+// -- the type definitions may refer to each other in cycles
+
+inline const ast_type_t* types_t::type_at(size_t k) const
+{
+    return reinterpret_cast<const ast_type_t*>(&store[k]);
+}
+
+const ast_type_t* types_t::type_of(
+    const def_t& def, const std::string& name) const
+{
+    auto k = lookup(name.c_str());
+    if (k == npos)
+        error(def.line, "unknown type '%s'", name.c_str());
+    return type_at(k);
+}
+
+const cptr_type_t* types_t::cptr_of(const std::string& name)
+{
+    if (name == "char*")
+        return Obj::cptr_type<const char*>();
+    for (const auto& c : cptrs)
+        if (name == c.name)
+            return &c;
+    cptrs.emplace_back(name.c_str());
+    return &cptrs.back();
+}
+
+void types_t::build()
+{
+    const size_t n = defs.size();
+    if (n >= npos / 2)
+        error(0, "too many type definitions");
+
+    size_t n_slot = 1;
+    while (n_slot < 2 * n)
+        n_slot *= 2;
+    slots.assign(n_slot, npos);
+    for (size_t k = 0; k < n; k ++) {
+        auto p = lookup(defs[k].name.c_str());
+        if (p != npos)
+            error(defs[k].line, "duplicate type '%s' -- see line %zu",
+                defs[k].name.c_str(), defs[p].line);
+        auto i = hash(defs[k].name.c_str()) & (n_slot - 1);
+        while (slots[i] != npos)
+            i = (i + 1) & (n_slot - 1);
+        slots[i] = k;
+    }
+
+    std::vector<uint32_t> bases(n, npos);
+    size_t n_arg = 0;
+    for (size_t k = 0; k < n; k ++) {
+        const auto& def = defs[k];
+        if (!def.base.empty()) {
+            type_of(def, def.base);
+            bases[k] = lookup(def.base.c_str());
+        }
+        n_arg += def.args.size();
+    }
+    // stev: 'ast_type_t::init_types' expects the base
+    // links of the types to make up a forest
+    for (size_t k = 0; k < n; k ++) {
+        auto b = bases[k];
+        for (size_t i = 0; b != npos; i ++, b = bases[b])
+            if (i >= n)
+                error(defs[k].line, "cyclic base of type '%s'",
+                    defs[k].name.c_str());
+    }
+
+    store.reset(new storage_t[n]);
+    args.reserve(n_arg);
+    std::vector<size_t> offs(n);
+    for (size_t k = 0; k < n; k ++) {
+        const auto& def = defs[k];
+        offs[k] = args.size();
+        for (const auto& a : def.args) {
+            auto type =
+                a.kind == arg_t::node
+                ? Obj::node_obj_type(type_of(def, a.type)) :
+                a.kind == arg_t::list
+                ? Obj::list_obj_type(type_of(def, a.type)) :
+                Obj::cptr_obj_type(cptr_of(a.type));
+            args.emplace_back(a.name.c_str(), type);
+        }
+    }
+
+    ptrs.reserve(n);
+    for (size_t k = 0; k < n; k ++) {
+        const auto& def = defs[k];
+        ptrs.push_back(new (&store[k]) ast_type_t(
+            def.name.c_str(),
+            bases[k] != npos ? type_at(bases[k]) : nullptr,
+            args.data() + offs[k],
+            def.args.size()));
+    }
+}
+
+const types_t& types_t::load(const char* file)
+{
+    static std::map<std::string, std::unique_ptr<types_t>> tables;
+    static std::mutex mutex;
+
+    const types_t* res;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& types = tables[file];
+        if (!types)
+            types.reset(new types_t(file));
+        res = types.get();
+    }
+    current = res;
+    ast_type_t::set_types(res->types(), res->size());
+    return *res;
+}
+
+class TypeMaker :
+    public Obj::ObjMaker<obj_type_t>,
+    protected Obj::TypeCheck<obj_type_t>
+{
+public:
+    typedef Obj::ObjMaker<obj_type_t> base_t;
+    typedef Obj::TypeCheck<obj_type_t> type_check_t;
+    typedef base_t::obj_args_t obj_args_t;
+
+    TypeMaker(const Obj::type_cast_info_t& _info, Obj::diags_t* _diags = nullptr) :
+        type_check_t(_info, _diags)
+    {}
+
+    obj_type_t make_node(const TreeAST::TreeNode* node, const obj_args_t& args);
+    obj_type_t make_list(const TreeAST::NodeList* list, const obj_args_t& args);
+    obj_type_t make_cptr(const TreeAST::Literal* cptr);
+
+private:
+    // stev: the types are looked up into the table of the
+    // last 'load', for the type sessions outlive the loads
+    const ast_type_t* find(const TreeAST::Node* node, const char* name) const;
+};
+
+inline const ast_type_t* TypeMaker::find(
+    const TreeAST::Node* node, const char* name) const
+{
+    using Obj::diag_t;
+
+    SYS_ASSERT(types_t::current != nullptr);
+    auto type = types_t::current->find(name);
+    if (type == nullptr)
+        // stev: returns only when validating
+        report(diag_t(diag_t::unknown_type, node,
+            nullptr, nullptr, 0, 0, name));
+    return type;
+}
+
+obj_type_t TypeMaker::make_node(
+    const TreeAST::TreeNode* node, const obj_args_t& args)
+{
+    auto type = find(node, node->name->ident);
+    if (type == nullptr)
+        return Obj::unknown_obj<obj_type_t>();
+    check_node(type, node, args);
+    return Obj::node_obj_type(type);
+}
+
+obj_type_t TypeMaker::make_list(
+    const TreeAST::NodeList* list, const obj_args_t& args)
+{
+    auto type = find(list, list->base->ident);
+    if (type == nullptr)
+        return Obj::unknown_obj<obj_type_t>();
+    check_list(type, list, args);
+    return Obj::list_obj_type(type);
+}
+
+obj_type_t TypeMaker::make_cptr(
+    const TreeAST::Literal* cptr)
+{
+    return Obj::cptr_obj<obj_type_t>(cptr->str);
+}
+
+} // namespace Schema
+
+namespace ExtErr {
+
+enum {
+    no_schema_given = no_trace_file_given + 1,
+    action_not_supported,
+};
+
+template<size_t E>
+void print_error(std::ostream& ost, const char* name);
+
+template<>
+inline void print_error<no_schema_given>(std::ostream& ost)
+{ print_error(ost, "no schema given"); }
+
+template<>
+inline void print_error<action_not_supported>(
+    std::ostream& ost, const char* name)
+{ print_error(ost, "action '%s' is not supported", name); }
+
+} // namespace ExtErr
+
+namespace Schema {
+
+// stev: there is no target AST to build objects into
+static Sys::ext_func_result_t exec_not_supported(
+    const TreeAST::AST*, const TreeAST::Tree*, const Obj::options_t* opt)
+{
+    using namespace ExtErr;
+    print_error<action_not_supported>(*opt->err, opt->act_name());
+    return 1;
+}
+
+} // namespace Schema
+
+EXT_FUNC_ENTRY
+Sys::ext_func_result_t schema(
+    const TreeAST::AST* ast, const Tree::options_t* opts)
+{
+    using namespace Obj;
+    using Schema::TypeMaker;
+    using Schema::exec_not_supported;
+
+    auto opt = Schema::options_t::options(opts);
+    if (opt->schema == nullptr) {
+        using namespace ExtErr;
+        print_error<no_schema_given>(*opt->err);
+        return 1;
+    }
+    Schema::types_t::load(opt->schema);
+
+    static const exec_func_t funcs[] = {
+        &exec_not_supported,          // options_t::ext_func_action
+        &exec_type_check<TypeMaker>,  // options_t::type_check_action
+        &exec_validate<TypeMaker>,    // options_t::validate_action
+        &exec_not_supported,          // options_t::ast_build_action
+        &exec_not_supported,          // options_t::print_obj_action
+    };
+    return ext_func_dispatch(ast, opts, opt, funcs);
+}
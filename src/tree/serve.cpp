@@ -0,0 +1,419 @@
+// Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+// 
+// This file is part of C++Py-Tree.
+// 
+// C++Py-Tree is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// C++Py-Tree is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+#include "sys.hpp"
+#include "std-ext.hpp"
+#include "serve.hpp"
+
+extern const char program[];
+
+namespace Tree {
+
+Server::Error::Error(const std::string& msg) :
+    std::runtime_error(msg)
+{}
+
+static void error(const char* what)
+{
+    throw Server::Error(
+        Sys::format("serve: %s: %s",
+            what, strerror(errno)));
+}
+
+static void error(const char* what, const char* socket)
+{
+    throw Server::Error(
+        Sys::format("serve: %s '%s': %s",
+            what, socket, strerror(errno)));
+}
+
+// stev: return false on end of file found prior
+// to the first byte of 'buf' if 'eof' is true
+
+static bool read_buf(int fd, void* buf, size_t n, bool eof = false)
+{
+    auto ptr = static_cast<char*>(buf);
+    auto end = ptr + n;
+    while (ptr < end) {
+        auto r = read(fd, ptr, Ext::ptr_diff(end, ptr));
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            error("cannot read");
+        }
+        if (r == 0) {
+            if (eof && ptr == buf)
+                return false;
+            throw Server::Error("serve: truncated frame");
+        }
+        ptr += r;
+    }
+    return true;
+}
+
+static void write_buf(int fd, const void* buf, size_t n)
+{
+    auto ptr = static_cast<const char*>(buf);
+    auto end = ptr + n;
+    while (ptr < end) {
+        auto r = write(fd, ptr, Ext::ptr_diff(end, ptr));
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            error("cannot write");
+        }
+        ptr += r;
+    }
+}
+
+template<typename T>
+static inline void put_int(std::string& buf, T val)
+{ buf.append(reinterpret_cast<const char*>(&val), sizeof val); }
+
+static inline void put_str(std::string& buf, const std::string& str)
+{
+    put_int(buf, Ext::integer_cast<uint32_t>(str.size()));
+    buf.append(str);
+}
+
+static void read_str(int fd, std::string& str, uint32_t max_len)
+{
+    uint32_t len;
+    read_buf(fd, &len, sizeof len);
+    if (len > max_len)
+        throw Server::Error(
+            Sys::format("serve: frame string too long: %u bytes", len));
+    str.resize(len);
+    if (len > 0)
+        read_buf(fd, &str[0], len);
+}
+
+bool Server::read_request(int fd, request_t& req)
+{
+    uint32_t n;
+    if (!read_buf(fd, &n, sizeof n, true))
+        return false;
+    if (n > max_args)
+        throw Error(
+            Sys::format("serve: too many request arguments: %u", n));
+    req.resize(n);
+    for (auto& arg : req)
+        read_str(fd, arg, max_len);
+    return true;
+}
+
+void Server::write_request(int fd, const request_t& req)
+{
+    std::string buf;
+    put_int(buf, Ext::integer_cast<uint32_t>(req.size()));
+    for (const auto& arg : req)
+        put_str(buf, arg);
+    write_buf(fd, buf.data(), buf.size());
+}
+
+bool Server::read_response(int fd, response_t& res)
+{
+    if (!read_buf(fd, &res.status, sizeof res.status, true))
+        return false;
+    read_str(fd, res.out, max_len);
+    read_str(fd, res.err, max_len);
+    return true;
+}
+
+void Server::write_response(int fd, const response_t& res)
+{
+    std::string buf;
+    put_int(buf, res.status);
+    put_str(buf, res.out);
+    put_str(buf, res.err);
+    write_buf(fd, buf.data(), buf.size());
+}
+
+// stev: serve the request read from 'in', if any; the state
+// returned tells whether more requests are to be read from 'in'
+
+Server::conn_state_t Server::serve_request(int in, int out)
+{
+    request_t req;
+    if (!read_request(in, req))
+        return conn_done;
+
+    response_t res;
+    if (req.empty()) {
+        write_response(out, res);
+        return conn_stop;
+    }
+    handler(req, res);
+    write_response(out, res);
+    return conn_more;
+}
+
+void Server::serve(int in, int out)
+{
+    signal(SIGPIPE, SIG_IGN);
+    while (serve_request(in, out) == conn_more);
+}
+
+// stev: 'pool_t' hands over the requests arriving on the connections
+// accepted on 'sock' to its worker threads: 'run' polls 'sock' along
+// with the idle connections, queueing up those having got a request;
+// a worker serves one request of the connection, then hands it back
+// to 'run' through 'conns' -- waking it up by writing into the pipe
+// 'wake'; thus an idle connection doesn't tie up a worker
+
+class Server::pool_t
+{
+public:
+    pool_t(const pool_t&) = delete;
+    pool_t& operator=(const pool_t&) = delete;
+
+    pool_t(Server* _server, int _sock, size_t n);
+    ~pool_t();
+
+    void run();
+
+private:
+    void work();
+    void stop();
+    void wake_up();
+
+    Server*                  server;
+    int                      sock;
+    int                      wake[2];
+    bool                     done;
+    std::mutex               mutex;
+    std::condition_variable  cond;
+    std::deque<int>          queue;
+    std::vector<int>         conns;
+    std::vector<int>         idle;
+    std::vector<std::thread> threads;
+};
+
+Server::pool_t::pool_t(Server* _server, int _sock, size_t n) :
+    server(_server),
+    sock(_sock),
+    done(false)
+{
+    if (pipe2(wake, O_CLOEXEC | O_NONBLOCK) < 0)
+        error("cannot create pipe");
+    threads.reserve(n);
+    for (size_t i = 0; i < n; i ++)
+        threads.emplace_back(&pool_t::work, this);
+}
+
+Server::pool_t::~pool_t()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        cond.notify_all();
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (auto fd : queue)
+        close(fd);
+    for (auto fd : conns)
+        close(fd);
+    for (auto fd : idle)
+        close(fd);
+    close(wake[0]);
+    close(wake[1]);
+}
+
+// stev: the pipe being full means 'run' is due to wake up anyway
+
+void Server::pool_t::wake_up()
+{
+    const char c = 0;
+    auto r UNUSED = write(wake[1], &c, 1);
+}
+
+void Server::pool_t::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        cond.notify_all();
+    }
+    wake_up();
+}
+
+void Server::pool_t::work()
+{
+    for (;;) {
+        int fd;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [this]() {
+                return done || !queue.empty();
+            });
+            if (done)
+                return;
+            fd = queue.front();
+            queue.pop_front();
+        }
+        // stev: the errors of a connection only end that
+        // connection; 'stderr' is written in one call, for
+        // the workers may report errors concurrently
+        auto state = conn_done;
+        try {
+            state = server->serve_request(fd, fd);
+        }
+        catch (const std::exception& exc) {
+            fprintf(stderr, "%s: error: %s\n", program, exc.what());
+        }
+        if (state == conn_more) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                conns.push_back(fd);
+            }
+            wake_up();
+        }
+        else {
+            close(fd);
+            if (state == conn_stop)
+                stop();
+        }
+    }
+}
+
+void Server::pool_t::run()
+{
+    std::vector<struct pollfd> fds;
+    for (;;) {
+        fds.clear();
+        fds.push_back({sock, POLLIN, 0});
+        fds.push_back({wake[0], POLLIN, 0});
+        for (auto fd : idle)
+            fds.push_back({fd, POLLIN, 0});
+
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            error("cannot poll connections");
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (done)
+            return;
+
+        // stev: the connections having got a request -- or
+        // having been closed -- are handed over to the workers
+        size_t k = 0;
+        for (size_t i = 0; i < idle.size(); i ++) {
+            if (fds[i + 2].revents)
+                queue.push_back(idle[i]);
+            else
+                idle[k ++] = idle[i];
+        }
+        idle.resize(k);
+
+        if (fds[1].revents) {
+            char buf[64];
+            while (read(wake[0], buf, sizeof buf) > 0);
+            idle.insert(idle.end(), conns.begin(), conns.end());
+            conns.clear();
+        }
+
+        if (fds[0].revents) {
+            auto fd = accept4(sock, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd >= 0)
+                idle.push_back(fd);
+            else
+            if (errno != EINTR &&
+                errno != EAGAIN &&
+                errno != ECONNABORTED)
+                error("cannot accept connections");
+        }
+
+        if (!queue.empty())
+            cond.notify_all();
+    }
+}
+
+// stev: a stale socket file left behind by a server which
+// didn't get to stop gets replaced; a live one is an error
+
+void Server::serve(const char* socket, size_t workers)
+{
+    signal(SIGPIPE, SIG_IGN);
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof addr);
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket) >= sizeof addr.sun_path)
+        throw Error(
+            Sys::format("serve: socket name too long: '%s'", socket));
+    strcpy(addr.sun_path, socket);
+
+    auto sock = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0)
+        error("cannot create socket", socket);
+
+    struct stat st;
+    if (lstat(socket, &st) == 0 && S_ISSOCK(st.st_mode)) {
+        if (connect(sock, reinterpret_cast<struct sockaddr*>(&addr),
+                sizeof addr) == 0) {
+            close(sock);
+            throw Error(
+                Sys::format("serve: socket in use: '%s'", socket));
+        }
+        unlink(socket);
+    }
+
+    if (bind(sock, reinterpret_cast<struct sockaddr*>(&addr),
+            sizeof addr) < 0 ||
+        listen(sock, SOMAXCONN) < 0) {
+        auto err = errno;
+        close(sock);
+        errno = err;
+        error("cannot listen on socket", socket);
+    }
+
+    try {
+        pool_t pool(this, sock, workers);
+        pool.run();
+    }
+    catch (...) {
+        close(sock);
+        unlink(socket);
+        throw;
+    }
+    close(sock);
+    unlink(socket);
+}
+
+} // namespace Tree
+
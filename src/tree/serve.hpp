@@ -0,0 +1,108 @@
+// Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+// 
+// This file is part of C++Py-Tree.
+// 
+// C++Py-Tree is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// C++Py-Tree is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __TREE_SERVE_HPP
+#define __TREE_SERVE_HPP
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <stdexcept>
+
+namespace Tree {
+
+// stev: 'Server' serves the requests of 'tree --serve' either read
+// from 'stdin' -- its responses being written to 'stdout' -- or read
+// from the connections accepted on a Unix domain socket; a request
+// is made of a 'uint32_t' count N followed by N arguments, each a
+// 'uint32_t' length followed by that many bytes: the first argument
+// is the input, the others are the arguments of the extension module
+// -- those given after '--' on the command line; a request of zero
+// arguments stops the server; a response is made of the 'int32_t'
+// exit status followed by the text the request printed to 'stdout'
+// and then by that printed to 'stderr', each a 'uint32_t' length
+// followed by that many bytes; the integers are of host byte order;
+// the pool of threads serving the connections executes the requests
+// concurrently, thus 'handler' must be reentrant: a request prints
+// to the streams of its own options -- not to the process' standard
+// streams -- and the state of 'getopt', which is process-wide, is
+// taken under a lock by the parsing of options
+
+class Server
+{
+public:
+    struct Error : public std::runtime_error
+    {
+        Error(const std::string& msg);
+    };
+
+    typedef std::vector<std::string> request_t;
+
+    struct response_t
+    {
+        response_t() : status(0) {}
+
+        int32_t     status;
+        std::string out;
+        std::string err;
+    };
+
+    typedef std::function<
+        void(const request_t&, response_t&)> handler_t;
+
+    // stev: the framing functions are shared with 'tree-client';
+    // the read functions return false on end of file found prior
+    // to the frame and throw 'Error' on errors and truncated frames
+    static bool read_request(int fd, request_t& req);
+    static void write_request(int fd, const request_t& req);
+    static bool read_response(int fd, response_t& res);
+    static void write_response(int fd, const response_t& res);
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    explicit Server(const handler_t& _handler) :
+        handler(_handler)
+    {}
+
+    void serve(int in, int out);
+    void serve(const char* socket, size_t workers);
+
+private:
+    enum : uint32_t {
+        max_args = 4096,
+        max_len  = 1u << 28
+    };
+
+    enum conn_state_t {
+        conn_more,
+        conn_done,
+        conn_stop
+    };
+
+    class pool_t;
+
+    conn_state_t serve_request(int in, int out);
+
+    handler_t handler;
+};
+
+} // namespace Tree
+
+#endif /* __TREE_SERVE_HPP */
@@ -0,0 +1,71 @@
+#!/bin/bash
+
+# Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+# 
+# This file is part of C++Py-Tree.
+# 
+# C++Py-Tree is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# C++Py-Tree is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#
+# Startup latency of the static program 'static/tree' compared
+# against that of the program './tree' loading its extension
+# modules by 'dlopen': run each of the two programs on the same
+# command line for a number of times and print out the average
+# wall time of one run, in microseconds. The script is to be run
+# from within src/tree, e.g.:
+#
+# $ static/bench.sh -n500 -F cxxpy/cxxpy.so 'Ident("a")' -- -c
+#
+
+n=200
+
+if [[ "$1" =~ ^-n[1-9][0-9]*$ ]]; then
+    n="${1:2}"
+    shift
+fi
+if [ "$#" -eq 0 ]; then
+    set -- -F cxxpy/cxxpy.so "Ident('a')" -- -c
+fi
+
+[ -x ./tree -a -x static/tree ] || {
+    echo >&2 "bench: error: './tree' and 'static/tree' not found"
+    exit 1
+}
+
+export LD_LIBRARY_PATH=.:abc:cxxpy
+
+bench()
+{
+    local i
+    local b
+    local e
+
+    "$@" > /dev/null || {
+        echo >&2 "bench: error: command failed: $*"
+        exit 1
+    }
+    b="$(date +%s%N)"
+    for ((i = 0; i < n; i ++)); do
+        "$@" > /dev/null
+    done
+    e="$(date +%s%N)"
+    echo $(( (e - b) / n / 1000 ))
+}
+
+d="$(bench ./tree "$@")" || exit 1
+s="$(bench static/tree "$@")" || exit 1
+
+printf "dynamic: %8d us\n" "$d"
+printf "static:  %8d us\n" "$s"
+printf "speedup: %8s\n" "$(awk "BEGIN { printf \"%.2fx\", $d / ($s ? $s : 1) }")"
@@ -0,0 +1,55 @@
+// Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+// 
+// This file is part of C++Py-Tree.
+// 
+// C++Py-Tree is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// 
+// C++Py-Tree is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "sys.hpp"
+#include "std-ext.hpp"
+
+// stev: the entry points of the extension modules linked into the
+// static program got renamed by 'objcopy' to 'ext_MOD__FUNC', for
+// not clashing with each other -- see the Makefile; the functions
+// are called through the pointers 'ext_func_t::call' casts to the
+// proper type, thus their parameters need not be declared herein
+
+#define EXT_FUNC_DECL(s, m, f) \
+    EXT_FUNC_ENTRY void ext_ ## s ## __ ## f();
+#define EXT_FUNC_ELEM(s, m, f) \
+    { m, #f, reinterpret_cast<void*>(&ext_ ## s ## __ ## f) },
+
+#define EXT_FUNCS(F)                              \
+    F(printer,        "printer",       printer)      \
+    F(printer,        "printer",       print)        \
+    F(printer,        "printer",       dump)         \
+    F(printer,        "printer",       pretty_print) \
+    F(printer,        "printer",       terse_print)  \
+    F(abc_abc,        "abc/abc",       abc)          \
+    F(abc_printer,    "abc/printer",   print)        \
+    F(cxxpy_cxxpy,    "cxxpy/cxxpy",   cxxpy)        \
+    F(cxxpy_printer,  "cxxpy/printer", print)        \
+    F(schema_schema,  "schema/schema", schema)
+
+EXT_FUNCS(EXT_FUNC_DECL)
+
+namespace Sys {
+
+const static_ext_func_t static_ext_funcs[] = {
+    EXT_FUNCS(EXT_FUNC_ELEM)
+};
+
+const size_t n_static_ext_funcs = Ext::array_size(static_ext_funcs);
+
+} // namespace Sys
+
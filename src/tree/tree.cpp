@@ -15,18 +15,26 @@
 // You should have received a copy of the GNU General Public License
 // along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <cerrno>
+#include <cctype>
 #include <cstdarg>
+#include <cstdlib>
 #include <cstring>
 #include <unistd.h>
 
 #include <iomanip>
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iterator>
 #include <exception>
 
 #include "sys.hpp"
 #include "std-ext.hpp"
 #include "parser.hpp"
 #include "tree.hpp"
+#include "cache.hpp"
+#include "serve.hpp"
 
 #include "demangle.hpp"
 
@@ -43,12 +51,33 @@ namespace Tree {
 
 const options_t* options_t::options(size_t argc, char* const argv[])
 {
-    static options_t opts;
+    static thread_local options_t opts;
     opts.parse(argc, argv);
     return &opts;
 }
 
-options_t::options_t()
+std::unique_ptr<const options_t> options_t::request(
+    size_t argc, char* const argv[], std::ostream& out, std::ostream& err)
+{
+    auto opts = new options_t;
+    std::unique_ptr<const options_t> res(opts);
+    opts->out = &out;
+    opts->err = &err;
+    opts->parse(argc, argv);
+    return res;
+}
+
+options_t::options_t() :
+    hash_cons(false),
+    relayout(false),
+    relayout_nodes(0),
+    extract(false),
+    mem_stats(false),
+    fingerprint(false),
+    type_cache(nullptr),
+    serve(false),
+    serve_socket(nullptr),
+    serve_workers(4)
 {
     action = pretty_print_action;
 }
@@ -57,12 +86,25 @@ void options_t::collect_opts(
     std::vector<char>& res_short_opts,
     std::vector<struct option>& res_long_opts) const
 {
-    static const char short_opts[] = "PT";
+    static const char short_opts[] = "HPRT";
     static const auto n_short_opts = Ext::array_size(short_opts) - 1;
 
     static struct option long_opts[] = {
-        { "pretty-print", 0, nullptr, opt_type_t::pretty_print },
-        { "terse-print",  0, nullptr, opt_type_t::terse_print },
+        { "pretty-print",   0, nullptr, opt_type_t::pretty_print },
+        { "terse-print",    0, nullptr, opt_type_t::terse_print },
+        { "hash-cons",      0, nullptr, opt_type_t::hash_cons },
+        { "no-hash-cons",   0, nullptr, opt_type_t::no_hash_cons },
+        { "relayout",       2, nullptr, opt_type_t::relayout },
+        { "no-relayout",    0, nullptr, opt_type_t::no_relayout },
+        { "extract",        0, nullptr, opt_type_t::extract },
+        { "no-extract",     0, nullptr, opt_type_t::no_extract },
+        { "mem-stats",      0, nullptr, opt_type_t::mem_stats },
+        { "no-mem-stats",   0, nullptr, opt_type_t::no_mem_stats },
+        { "fingerprint",    0, nullptr, opt_type_t::fingerprint },
+        { "no-fingerprint", 0, nullptr, opt_type_t::no_fingerprint },
+        { "type-cache",     1, nullptr, opt_type_t::type_cache },
+        { "serve",          2, nullptr, opt_type_t::serve },
+        { "workers",        1, nullptr, opt_type_t::workers },
     };
     static const auto n_long_opts = Ext::array_size(long_opts);
 
@@ -83,6 +125,43 @@ void options_t::usage_acts() const
         << "  -T|--terse-print     reprint tersely the parsed input" << endl;
 }
 
+void options_t::usage_opts() const
+{
+    base_t::usage_opts();
+    using namespace std;
+    cout
+        << "  -H|--hash-cons       hash-cons or not the parsed AST (default not)" << endl
+        << "     --no-hash-cons" << endl
+        << "  -R|--relayout[=NUM]  relayout or not the parsed AST in depth-first order -- into a node pool of NUM objects (default not)" << endl
+        << "     --no-relayout" << endl
+        << "     --extract         extract or not the parsed AST into a copy having pools sized to fit (default not)" << endl
+        << "     --no-extract" << endl
+        << "     --mem-stats       print or not memory statistics of the parsed AST (default not)" << endl
+        << "     --no-mem-stats" << endl
+        << "     --fingerprint     print or not the structural fingerprint of the parsed AST (default not)" << endl
+        << "     --no-fingerprint" << endl
+        << "     --type-cache=FILE cache in FILE the verdicts of the type checks of the extension module" << endl
+        << "     --serve[=SOCKET]  serve the requests read from stdin -- or else from connections to the Unix socket SOCKET" << endl
+        << "     --workers=NUM     serve the connections to SOCKET using NUM threads -- executing their requests concurrently (default 4)" << endl;
+}
+
+void options_t::dump_opts() const
+{
+    base_t::dump_opts();
+    using namespace std;
+    cout
+        << "hash-cons:      " << Ext::array(noyes)[hash_cons] << endl
+        << "relayout:       " << (relayout && relayout_nodes
+            ? to_string(relayout_nodes)
+            : string(Ext::array(noyes)[relayout])) << endl
+        << "extract:        " << Ext::array(noyes)[extract] << endl
+        << "mem-stats:      " << Ext::array(noyes)[mem_stats] << endl
+        << "fingerprint:    " << Ext::array(noyes)[fingerprint] << endl
+        << "type-cache:     " << (type_cache ? type_cache : "-") << endl
+        << "serve:          " << (!serve ? "-" : serve_socket ? serve_socket : "stdio") << endl
+        << "workers:        " << serve_workers << endl;
+}
+
 const char* options_t::act_name() const
 {
     static char const* actions[] = {
@@ -105,6 +184,27 @@ const char* options_t::get_ext_func_name() const
         : base_t::get_ext_func_name();
 }
 
+size_t options_t::parse_workers(const char* opt_arg)
+{
+    char* end;
+    errno = 0;
+    auto n = strtoul(opt_arg, &end, 10);
+    if (errno || *end || !isdigit(*opt_arg) ||
+        n < 1 || n > max_workers)
+        invalid_opt_arg("workers", opt_arg);
+    return n;
+}
+
+size_t options_t::parse_nodes(const char* opt_arg)
+{
+    char* end;
+    errno = 0;
+    auto n = strtoul(opt_arg, &end, 10);
+    if (errno || *end || !isdigit(*opt_arg) || n < 1)
+        invalid_opt_arg("relayout", opt_arg);
+    return n;
+}
+
 bool options_t::parse_opt(opt_t opt, const char* opt_arg)
 {
     if (base_t::parse_opt(opt, opt_arg))
@@ -116,6 +216,47 @@ bool options_t::parse_opt(opt_t opt, const char* opt_arg)
     case opt_type_t::terse_print:
         action = terse_print_action;
         break;
+    case opt_type_t::hash_cons:
+        hash_cons = true;
+        break;
+    case opt_type_t::no_hash_cons:
+        hash_cons = false;
+        break;
+    case opt_type_t::relayout:
+        relayout = true;
+        relayout_nodes = opt_arg ? parse_nodes(opt_arg) : 0;
+        break;
+    case opt_type_t::no_relayout:
+        relayout = false;
+        break;
+    case opt_type_t::extract:
+        extract = true;
+        break;
+    case opt_type_t::no_extract:
+        extract = false;
+        break;
+    case opt_type_t::mem_stats:
+        mem_stats = true;
+        break;
+    case opt_type_t::no_mem_stats:
+        mem_stats = false;
+        break;
+    case opt_type_t::fingerprint:
+        fingerprint = true;
+        break;
+    case opt_type_t::no_fingerprint:
+        fingerprint = false;
+        break;
+    case opt_type_t::type_cache:
+        type_cache = opt_arg;
+        break;
+    case opt_type_t::serve:
+        serve = true;
+        serve_socket = opt_arg;
+        break;
+    case opt_type_t::workers:
+        serve_workers = parse_workers(opt_arg);
+        break;
     default:
         return false;
     }
@@ -137,6 +278,8 @@ static inline std::unique_ptr<TreeAST::AST> parse_input(
         opts->debug,
 #endif
         opts->verbose,
+        opts->hash_cons,
+        opts->fingerprint,
         Ext::array(input_types)[opts->input_type],
         opts->input_type == options_t::text_input
         ? "<text>" : input,
@@ -145,6 +288,83 @@ static inline std::unique_ptr<TreeAST::AST> parse_input(
     return parser.parse();
 }
 
+// stev: the type cache applies only when nothing is printed out
+// prior to running the extension function on the parsed input;
+// 'hash' gets the part of the keys common to all inputs -- which
+// is to be computed before the extension function gets to permute
+// its arguments; the arguments naming files -- be they options of
+// form '--NAME=FILE', like the '--schema' of the Schema module --
+// add the identities of those files, for the verdicts depend on
+// the contents of these too
+
+static bool use_type_cache(
+    const options_t* opts, TypeCache::hasher_t& hash)
+{
+    if (opts->type_cache == nullptr ||
+        opts->ext_func_name == nullptr ||
+        opts->mem_stats ||
+        opts->fingerprint ||
+        (opts->hash_cons && opts->verbose))
+        return false;
+
+    auto stamp = Sys::load_ext_func<TreeAST::AST>(opts).stamp();
+    if (stamp.empty())
+        return false;
+    hash.add(stamp.c_str());
+    hash.add(opts->act_name());
+    hash.add(opts->input_type == options_t::text_input ? "text" : "file");
+    for (size_t i = 0; i < opts->ext_argc; i ++) {
+        const char* arg = opts->ext_argv[i];
+        hash.add(arg);
+        if (arg[0] == '-' && arg[1] == '-') {
+            auto val = strchr(arg, '=');
+            arg = val != nullptr ? val + 1 : "";
+        }
+        hash.add(Sys::file_stamp(arg).c_str());
+    }
+    return true;
+}
+
+// stev: input read from 'stdin' is not cached
+
+static bool type_cache_key(
+    const char* input, const TypeCache::hasher_t& base,
+    const options_t* opts, TypeCache::key_t& key)
+{
+    using namespace std;
+
+    TypeCache::hasher_t hash(base);
+    if (opts->input_type == options_t::text_input)
+        hash.add(input, strlen(input));
+    else {
+        if (!strcmp(input, "-"))
+            return false;
+        ifstream file(input, ios::binary);
+        if (!file)
+            return false;
+        string text(
+            (istreambuf_iterator<char>(file)),
+            istreambuf_iterator<char>());
+        if (file.bad())
+            return false;
+        hash.add(text.data(), text.size());
+    }
+    key = hash.result();
+    return true;
+}
+
+static inline Sys::ext_func_result_t print_verdict(
+    const TypeCache::verdict_t& verdict, const options_t* opts)
+{
+    if (opts->verbose)
+        *opts->err << program << ": type-cache: hit" << std::endl;
+    if (verdict.status == 0)
+        *opts->out << verdict.text << std::endl;
+    else
+        *opts->err << program << ": error: " << verdict.text << std::endl;
+    return verdict.status;
+}
+
 } // namespace Tree
 
 static inline void print_error(
@@ -183,6 +403,165 @@ static inline void print_error(std::ostream& ost)
         << std::endl;
 }
 
+static inline void print_fingerprint(
+    std::ostream& ost, const TreeAST::AST& ast)
+{
+    AST::fingerprint_t f;
+    ast.fingerprint(ast.root_node(), f);
+    ost << program
+        << ": fingerprint: "
+        << f
+        << std::endl;
+}
+
+static Sys::ext_func_result_t run_input(
+    const char* input, const Tree::options_t* opts)
+{
+    auto ast = Tree::parse_input(input, opts);
+    if (opts->hash_cons && opts->verbose)
+        *opts->err << program << ": hash-cons: "
+                   << ast->cons_stats() << std::endl;
+    if (opts->relayout)
+        ast->compact(opts->relayout_nodes);
+    if (opts->extract)
+        ast = ast->extract(ast->root_node());
+    if (opts->mem_stats)
+        ast->mem_stats().print(*opts->err,
+            std::string(program).append(": mem-stats: ").c_str());
+    if (opts->fingerprint)
+        print_fingerprint(*opts->err, *ast);
+    return Sys::run_ext_func(ast, opts);
+}
+
+// stev: the options making the extension modules print out some
+// text and then exit the program are not allowed in the requests
+// of 'tree --serve'; abbreviations of long options and clusters
+// of short options are taken into account -- conservatively
+
+static bool is_exit_opt(const char* arg)
+{
+    static const char* const exit_opts[] = {
+        "help", "help-ext-func", "version", "dump-options"
+    };
+
+    if (arg[0] != '-' || arg[1] == 0)
+        return false;
+    if (arg[1] != '-')
+        return strpbrk(arg + 1, "v?") != nullptr;
+
+    auto name = arg + 2;
+    auto len = strcspn(name, "=");
+    for (auto opt : exit_opts) {
+        if (len > 0 && !strncmp(opt, name, len))
+            return true;
+    }
+    return false;
+}
+
+// stev: run the request 'req' of 'tree --serve' having the options
+// 'beg'..'end' of the server prepended to its own arguments; these
+// are all copied, for the parsing of options writes into them; the
+// output of the request goes to 'out' and 'err' -- not to 'std::cout'
+// and 'std::cerr' -- thus the requests may run concurrently
+
+static Sys::ext_func_result_t run_request(
+    const std::string& prog, char* const* beg, char* const* end,
+    const Tree::Server::request_t& req, std::ostream& out, std::ostream& err)
+try
+{
+    using namespace Tree;
+
+    const auto& input = req.front();
+    if (input[0] == '-')
+        throw Server::Error(Sys::format(
+            "serve: invalid request input '%s'", input.c_str()));
+    for (auto ptr = req.begin() + 1; ptr != req.end(); ++ ptr) {
+        if (is_exit_opt(ptr->c_str()))
+            throw Server::Error(Sys::format(
+                "serve: request option not allowed: '%s'", ptr->c_str()));
+    }
+
+    std::vector<std::string> args;
+    args.reserve(Ext::ptr_diff(end, beg) + req.size() + 2);
+    args.push_back(prog);
+    args.insert(args.end(), beg, end);
+    args.push_back(input);
+    if (req.size() > 1) {
+        args.push_back("--");
+        args.insert(args.end(), req.begin() + 1, req.end());
+    }
+
+    std::vector<char*> argv;
+    argv.reserve(args.size() + 1);
+    for (auto& arg : args)
+        argv.push_back(&arg[0]);
+    argv.push_back(nullptr);
+
+    auto opts = options_t::request(args.size(), argv.data(), out, err);
+    return run_input(*opts->argv, opts.get());
+}
+catch (const Parser::ParserError& exc) {
+    print_error(err, exc);
+    return 1;
+}
+catch (const std::runtime_error& exc) {
+    print_error(err, exc);
+    return 1;
+}
+catch (const std::exception& exc) {
+    print_error(err, exc);
+    return 1;
+}
+catch (...) {
+    print_error(err);
+    return 1;
+}
+
+static void serve_request(
+    const std::string& prog, char* const* beg, char* const* end,
+    const Tree::Server::request_t& req, Tree::Server::response_t& res)
+{
+    std::ostringstream out, err;
+    res.status = run_request(prog, beg, end, req, out, err);
+    res.out = out.str();
+    res.err = err.str();
+}
+
+// stev: the inputs and the arguments of the extension module are
+// given by the requests; the requests get an 'argv[0]' which the
+// parsing of options reduces to the 'home_dir' of the server; the
+// extension module is loaded upfront
+
+static int serve(const Tree::options_t* opts, char* const argv[])
+{
+    using namespace Tree;
+
+    if (opts->argc > 0)
+        throw Server::Error(
+            "serve: inputs are given by requests");
+    if (opts->ext_argc > 0)
+        throw Server::Error(
+            "serve: extension module arguments are given by requests");
+    if (opts->help_ext_func)
+        throw Server::Error(
+            "serve: option not allowed: '--help-ext-func'");
+
+    if (opts->ext_func_name != nullptr)
+        Sys::load_ext_func<TreeAST::AST>(opts);
+
+    auto prog = Sys::format("%s/%s", opts->home_dir, program);
+    Server server(
+        [&](const Server::request_t& req, Server::response_t& res) {
+            serve_request(prog, argv + 1, opts->argv, req, res);
+        });
+    if (opts->serve_socket != nullptr)
+        server.serve(opts->serve_socket, opts->serve_workers);
+    else
+        server.serve(0, 1);
+
+    return 0;
+}
+
 int main(int argc, char* const argv[])
 try
 {
@@ -190,18 +569,39 @@ try
     using namespace Tree;
 
     auto opts = options_t::options(argc, argv);
+    if (opts->serve)
+        return serve(opts, argv);
     if (opts->help_ext_func || opts->argc == 0) {
         if (auto r = run_ext_func<TreeAST::AST>(nullptr, opts))
             return r;
     }
     else {
+        TypeCache::hasher_t base;
+        std::unique_ptr<TypeCache> cache(
+            use_type_cache(opts, base)
+            ? new TypeCache(opts->type_cache)
+            : nullptr);
         auto ptr = opts->argv;
         auto end = ptr + opts->argc;
         for (; ptr < end; ptr ++) {
-            auto ast = parse_input(*ptr, opts);
-            if (auto r = run_ext_func(ast, opts))
+            TypeCache::key_t key;
+            auto cached = cache && type_cache_key(*ptr, base, opts, key);
+            if (cached) {
+                TypeCache::verdict_t verdict;
+                if (cache->find(key, verdict)) {
+                    if (auto r = print_verdict(verdict, opts))
+                        return r;
+                    continue;
+                }
+                cache->begin(key);
+            }
+            if (auto r = run_input(*ptr, opts))
                 return r;
+            if (cached)
+                cache->end();
         }
+        if (cache)
+            cache->commit();
     }
 
     return 0;
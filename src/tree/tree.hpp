@@ -18,6 +18,8 @@
 #ifndef __TREE_HPP
 #define __TREE_HPP
 
+#include <memory>
+
 #include "options.hpp"
 
 namespace Tree {
@@ -27,12 +29,36 @@ class options_t : public Opts::input_options_t
 public:
     static const options_t* options(size_t argc, char* const argv[]);
 
+    // stev: the options of a request of 'tree --serve', parsed
+    // out of the arguments of the server followed by those of
+    // the request; 'argv', 'out' and 'err' must outlive the
+    // options returned
+    static std::unique_ptr<const options_t> request(
+        size_t argc, char* const argv[],
+        std::ostream& out, std::ostream& err);
+
     typedef Opts::input_options_t base_t;
     enum {
         pretty_print_action = base_t::dump_action + 1,
         terse_print_action
     };
 
+    bool hash_cons;
+    bool relayout;
+    size_t relayout_nodes;
+    bool extract;
+    bool mem_stats;
+    bool fingerprint;
+    const char* type_cache;
+    bool serve;
+    const char* serve_socket;
+    size_t serve_workers;
+
+    // stev: the state which the extension module keeps for the
+    // lifetime of these options -- that is for the run of the
+    // program or for one request of 'tree --serve'
+    mutable std::shared_ptr<void> ext_state;
+
     const char* act_name() const;
 
 protected:
@@ -43,8 +69,21 @@ protected:
     struct opt_type_t : base_t::opt_type_t
     {
         enum {
-            pretty_print = 'P',
-            terse_print  = 'T',
+            pretty_print   = 'P',
+            terse_print    = 'T',
+            hash_cons      = 'H',
+            no_hash_cons   = 260,
+            relayout       = 'R',
+            no_relayout    = 261,
+            extract        = 266,
+            no_extract     = 267,
+            mem_stats      = 262,
+            no_mem_stats   = 263,
+            fingerprint    = 264,
+            no_fingerprint = 265,
+            type_cache     = 268,
+            serve          = 269,
+            workers        = 270,
         };
     };
 
@@ -54,7 +93,17 @@ protected:
     const char* get_ext_func_name() const;
     bool parse_opt(opt_t opt, const char* opt_arg);
 
+    enum { max_workers = 256 };
+
+    static size_t parse_workers(const char* opt_arg);
+    static size_t parse_nodes(const char* opt_arg);
+
+    using base_t::noyes;
+
     void usage_acts() const;
+    void usage_opts() const;
+
+    void dump_opts() const;
 };
 
 } // namespace Tree
@@ -74,7 +74,199 @@ tree: error: list<R>: arg #0: cannot cast from type '\''A'\''
 command failed: tree "L(.q=list<R>[[0]=A()])" -- -os
 $ tree "L(.q=list<R>[[0]=A()])" -- -or
 tree: error: list<R>: arg #0: cannot cast from type '\''A'\''
-command failed: tree "L(.q=list<R>[[0]=A()])" -- -or'
+command failed: tree "L(.q=list<R>[[0]=A()])" -- -or
+$ tree "M(.a=A().b=list<B>[[0]=B(.a=A())[1]=B(.a=A())].c='\''x'\'')" -- -o -H --extract --mem-stats
+tree: abc: mem-stats: pool=node objs=3 max-objs=3 bytes=112 max-bytes=112 padding=24 rollbacks=0 high-water=112
+tree: abc: mem-stats: pool=raw objs=2 max-objs=2 bytes=27 max-bytes=27 padding=9 rollbacks=0 high-water=27
+tree: abc: mem-stats: type=A count=1 bytes=16
+tree: abc: mem-stats: type=B count=1 bytes=24
+tree: abc: mem-stats: type=M count=1 bytes=48
+M(.a=A().b=list<B>[[0]=B(.a=A())[1]=B(.a=A())]'\''x'\'')
+$ tree "X()"
+tree: error: unknown AST type name '\''X'\''
+command failed: tree "X()"
+$ tree "No()"
+tree: error: unknown AST type name '\''No'\''
+command failed: tree "No()"
+$ tree "Nodes()"
+tree: error: unknown AST type name '\''Nodes'\''
+command failed: tree "Nodes()"
+$ tree "N(.x=B(.a=Q()).y=C(.b=list<B>[[0]=B(.a=R())]).z=D(.c='\''x'\''))" -- -or
+N(.x=B(.a=Q()).y=C(.b=list<B>[[0]=B(.a=R())]).z=D('\''x'\''))
+$ tree "S(.bb='\''0'\'')"
+tree: error: ast-type S: arg #1: expected name '\''b'\'', but got '\''bb'\''
+command failed: tree "S(.bb='\''0'\'')"
+$ tree "P(.x=A().y=A())"
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''P'\''))
+$ tree "P(.x=A().yy=A())"
+tree: error: ast-type P: arg #2: expected name '\''y'\'', but got '\''yy'\''
+command failed: tree "P(.x=A().yy=A())"
+$ tree '\''P(.x=A().y=A())'\'' -- -V
+$ tree '\''S(.b=A())'\'' -- -V
+tree: error: S: ast-type S: arg #1: cannot cast from type '\''A'\'' to '\''bool'\''
+command failed: tree '\''S(.b=A())'\'' -- -V
+$ tree '\''P(.x=S(.a='\''\'\'''\''0'\''\'\'''\'').y=Q())'\'' -- -V
+tree: error: P.x: ast-type S: arg #1: expected name '\''b'\'', but got '\''a'\''
+tree: error: P: ast-type P: arg #1: cannot cast from type '\''S'\'' to '\''A'\''
+tree: error: P: ast-type P: arg #2: cannot cast from type '\''Q'\'' to '\''A'\''
+command failed: tree '\''P(.x=S(.a='\''\'\'''\''0'\''\'\'''\'').y=Q())'\'' -- -V
+$ tree '\''P(.x=X().y=A(.k=A()))'\'' -- -V
+tree: error: P.x: unknown AST type name '\''X'\''
+tree: error: P.y: ast-type A: expected 0 args, but got 1
+command failed: tree '\''P(.x=X().y=A(.k=A()))'\'' -- -V
+$ tree '\''N(.x=Z().y=C(.b=list<B>[[0]=B(.a=A()) [1]=A() [2]=X()]).z=D(.c=A()))'\'' -- -V
+tree: error: N.x: unknown AST type name '\''Z'\''
+tree: error: N.y.b[2]: unknown AST type name '\''X'\''
+tree: error: N.y.b: list<B>: arg #1: cannot cast from type '\''A'\''
+tree: error: N.z: ast-type D: arg #1: cannot cast from type '\''A'\'' to '\''char*'\''
+command failed: tree '\''N(.x=Z().y=C(.b=list<B>[[0]=B(.a=A()) [1]=A() [2]=X()]).z=D(.c=A()))'\'' -- -V
+$ tree '\''C(.b=list<A>[[0]=B(.a=Q())])'\'' -- -V
+tree: error: C.b[0]: ast-type B: arg #1: cannot cast from type '\''Q'\'' to '\''A'\''
+tree: error: C.b: list<A>: arg #0: cannot cast from type '\''B'\''
+tree: error: C: ast-type C: arg #1: cannot cast from type '\''list<A>'\'' to '\''list<B>'\''
+command failed: tree '\''C(.b=list<A>[[0]=B(.a=Q())])'\'' -- -V
+$ tree "P(.x=A().y=A())" "M(.a=A().b=list<B>[[0]=B(.a=A())[1]=B(.a=A())].c='\''x'\'')" "D(.c='\''x'\'')" -- -o -H --mem-stats
+tree: abc: mem-stats: pool=node objs=2 max-objs=256 bytes=64 max-bytes=16384 padding=16 rollbacks=0 high-water=64
+tree: abc: mem-stats: pool=raw objs=0 max-objs=256 bytes=0 max-bytes=16384 padding=0 rollbacks=0 high-water=0
+tree: abc: mem-stats: type=A count=1 bytes=16
+tree: abc: mem-stats: type=P count=1 bytes=32
+P(.x=A().y=A())
+tree: abc: mem-stats: pool=node objs=3 max-objs=256 bytes=112 max-bytes=16384 padding=24 rollbacks=0 high-water=112
+tree: abc: mem-stats: pool=raw objs=2 max-objs=256 bytes=27 max-bytes=16384 padding=9 rollbacks=0 high-water=27
+tree: abc: mem-stats: type=A count=1 bytes=16
+tree: abc: mem-stats: type=B count=1 bytes=24
+tree: abc: mem-stats: type=M count=1 bytes=48
+M(.a=A().b=list<B>[[0]=B(.a=A())[1]=B(.a=A())]'\''x'\'')
+tree: abc: mem-stats: pool=node objs=1 max-objs=256 bytes=32 max-bytes=16384 padding=8 rollbacks=0 high-water=32
+tree: abc: mem-stats: pool=raw objs=1 max-objs=256 bytes=3 max-bytes=16384 padding=1 rollbacks=0 high-water=3
+tree: abc: mem-stats: type=D count=1 bytes=24
+D('\''x'\'')
+$ tree "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" -- -o -H --extract --mem-stats
+tree: abc: mem-stats: pool=node objs=3 max-objs=3 bytes=112 max-bytes=112 padding=24 rollbacks=0 high-water=112
+tree: abc: mem-stats: pool=raw objs=2 max-objs=2 bytes=19 max-bytes=19 padding=9 rollbacks=0 high-water=19
+tree: abc: mem-stats: type=A count=1 bytes=16
+tree: abc: mem-stats: type=B count=1 bytes=24
+tree: abc: mem-stats: type=M count=1 bytes=48
+M(.a=A().b=list<B>[[0]=B(.a=A())]'\''x'\'')
+tree: abc: mem-stats: pool=node objs=3 max-objs=3 bytes=112 max-bytes=112 padding=24 rollbacks=0 high-water=112
+tree: abc: mem-stats: pool=raw objs=2 max-objs=2 bytes=19 max-bytes=19 padding=9 rollbacks=0 high-water=19
+tree: abc: mem-stats: type=A count=1 bytes=16
+tree: abc: mem-stats: type=B count=1 bytes=24
+tree: abc: mem-stats: type=M count=1 bytes=48
+M(.a=A().b=list<B>[[0]=B(.a=A())]'\''x'\'')
+$ tree "D(.c='\''x'\'')" "S('\''0'\'')" "P(.x=A().y=A())" -- -c
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''D'\''))
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''S'\''))
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''P'\''))
+$ rm -f /tmp/tree-type-cache-test{,.lock,.log}
+$ tree --type-cache=/tmp/tree-type-cache-test --verbose "D(.c='\''x'\'')" "S('\''0'\'')" "D(.c='\''x'\'')" -- -c
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''D'\''))
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''S'\''))
+tree: type-cache: hit
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''D'\''))
+$ tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''0'\'')" "P(.x=A().y=A())" -- -c
+tree: type-cache: hit
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''S'\''))
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''P'\''))
+$ tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -c
+tree: error: ast-type P: arg #2: cannot cast from type '\''Q'\'' to '\''A'\''
+command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -c
+$ tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -c
+tree: type-cache: hit
+tree: error: ast-type P: arg #2: cannot cast from type '\''Q'\'' to '\''A'\''
+command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -c
+$ tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -cr
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''P'\''))
+$ tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -cr
+tree: type-cache: hit
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''P'\''))
+$ rm -f /tmp/tree-type-cache-test{,.lock,.log}
+$ tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''0'\'')" -- -c
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''S'\''))
+$ f=/tmp/tree-type-cache-test.log; printf 1|dd of=$f bs=1 seek=$(($(stat -c%s $f) - 128)) conv=notrunc status=none
+$ tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''0'\'')" -- -c
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''S'\''))
+$ tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''0'\'')" -- -c
+tree: type-cache: hit
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''S'\''))
+$ rm -f /tmp/tree-type-cache-test{,.lock,.log}
+$ tree --type-cache=/tmp/tree-type-cache-test $(for i in {0..1029}; do echo -n "S('\''$i'\'') "; done) -- -c|uniq -c
+   1030 ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''S'\''))
+$ ls /tmp/tree-type-cache-test*; stat -c%s /tmp/tree-type-cache-test
+/tmp/tree-type-cache-test
+/tmp/tree-type-cache-test.lock
+131856
+$ tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''1000'\'')" "S('\''x'\'')" -- -c
+tree: type-cache: hit
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''S'\''))
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''S'\''))
+$ ls /tmp/tree-type-cache-test*
+/tmp/tree-type-cache-test
+/tmp/tree-type-cache-test.lock
+/tmp/tree-type-cache-test.log
+$ tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''1000'\'')" "S('\''x'\'')" -- -c
+tree: type-cache: hit
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''S'\''))
+tree: type-cache: hit
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''S'\''))
+$ rm -f /tmp/tree-type-cache-test{,.lock,.log}
+$ tree --type-cache=/tmp/tree-type-cache-test-none/x "P(.x=A().y=Q())" -- -c
+tree: error: type-cache: cannot open '\''/tmp/tree-type-cache-test-none/x.lock'\'': No such file or directory
+tree: error: ast-type P: arg #2: cannot cast from type '\''Q'\'' to '\''A'\''
+command failed: tree --type-cache=/tmp/tree-type-cache-test-none/x "P(.x=A().y=Q())" -- -c
+$ rm -f /tmp/tree-trace-test
+$ tree "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "P(.x=A().y=Q())" -- -T
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''A'\''))
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''A'\''))
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''B'\''))
+visit(const TreeAST::NodeList*): ObjType(.type = '\''list'\'' .list = ListObjType(.ast_type = '\''B'\''))
+visit(const TreeAST::Literal*): ObjType(.type = '\''cptr'\'' .cptr = CptrObjType(.cptr_type = '\''char*'\''))
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''M'\''))
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''M'\''))
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''A'\''))
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''Q'\''))
+tree: error: ast-type P: arg #2: cannot cast from type '\''Q'\'' to '\''A'\''
+command failed: tree "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "P(.x=A().y=Q())" -- -T
+$ tree "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "P(.x=A().y=Q())" -- --trace-file=/tmp/tree-trace-test
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''M'\''))
+tree: error: ast-type P: arg #2: cannot cast from type '\''Q'\'' to '\''A'\''
+command failed: tree "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "P(.x=A().y=Q())" -- --trace-file=/tmp/tree-trace-test
+$ tree -- --decode-trace --trace-file=/tmp/tree-trace-test
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''A'\''))
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''A'\''))
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''B'\''))
+visit(const TreeAST::NodeList*): ObjType(.type = '\''list'\'' .list = ListObjType(.ast_type = '\''B'\''))
+visit(const TreeAST::Literal*): ObjType(.type = '\''cptr'\'' .cptr = CptrObjType(.cptr_type = '\''char*'\''))
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''M'\''))
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''A'\''))
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''Q'\''))
+$ tree -- --decode-trace
+tree: abc: error: no trace file given
+command failed: tree -- --decode-trace
+$ rm -f /tmp/tree-trace-test
+$ ./tree-phash $(sed -n '\''/> AST_TYPEMAKER_NEW_FUNCS/,/< AST_TYPEMAKER_NEW_FUNCS/s/^ *new_funcs_t("\([^"]*\)".*/\1/p'\'' abc/abc.cpp)|diff -u - <(sed -n '\''/^static constexpr const char\* type_names\[\]/,/^static constexpr uint32_t type_seed/p'\'' abc/abc.cpp)
+$ ./tree-phash -b3 A B C
+static constexpr const char* type_names[] = {
+    "A",
+    "B",
+    "C",
+    ""
+};
+
+static constexpr type_names_t::slot_t type_slots[] = {
+    3, 3, 3, 0, 2, 1, 3, 3
+};
+
+static constexpr uint32_t type_seed = 15;
+$ ./tree-phash A B A
+tree-phash: error: name '\''A'\'' given twice
+command failed: ./tree-phash A B A
+$ ./tree-phash -b2 A B C D
+tree-phash: error: too many names for 4 slots
+command failed: ./tree-phash -b2 A B C D
+$ ./tree-phash
+tree-phash: error: no name given
+command failed: ./tree-phash'
 ) -L abc.new <(
 echo '$ cd ../src/tree'
 cd ../src/tree 2>&1 ||
@@ -139,5 +331,197 @@ echo 'command failed: tree "L(.q=list<R>[[0]=A()])" -- -os'
 echo '$ tree "L(.q=list<R>[[0]=A()])" -- -or'
 tree "L(.q=list<R>[[0]=A()])" -- -or 2>&1 ||
 echo 'command failed: tree "L(.q=list<R>[[0]=A()])" -- -or'
+
+echo '$ tree "M(.a=A().b=list<B>[[0]=B(.a=A())[1]=B(.a=A())].c='\''x'\'')" -- -o -H --extract --mem-stats'
+tree "M(.a=A().b=list<B>[[0]=B(.a=A())[1]=B(.a=A())].c='x')" -- -o -H --extract --mem-stats 2>&1 ||
+echo 'command failed: tree "M(.a=A().b=list<B>[[0]=B(.a=A())[1]=B(.a=A())].c='\''x'\'')" -- -o -H --extract --mem-stats'
+
+echo '$ tree "X()"'
+tree "X()" 2>&1 ||
+echo 'command failed: tree "X()"'
+
+echo '$ tree "No()"'
+tree "No()" 2>&1 ||
+echo 'command failed: tree "No()"'
+
+echo '$ tree "Nodes()"'
+tree "Nodes()" 2>&1 ||
+echo 'command failed: tree "Nodes()"'
+
+echo '$ tree "N(.x=B(.a=Q()).y=C(.b=list<B>[[0]=B(.a=R())]).z=D(.c='\''x'\''))" -- -or'
+tree "N(.x=B(.a=Q()).y=C(.b=list<B>[[0]=B(.a=R())]).z=D(.c='x'))" -- -or 2>&1 ||
+echo 'command failed: tree "N(.x=B(.a=Q()).y=C(.b=list<B>[[0]=B(.a=R())]).z=D(.c='\''x'\''))" -- -or'
+
+echo '$ tree "S(.bb='\''0'\'')"'
+tree "S(.bb='0')" 2>&1 ||
+echo 'command failed: tree "S(.bb='\''0'\'')"'
+
+echo '$ tree "P(.x=A().y=A())"'
+tree "P(.x=A().y=A())" 2>&1 ||
+echo 'command failed: tree "P(.x=A().y=A())"'
+
+echo '$ tree "P(.x=A().yy=A())"'
+tree "P(.x=A().yy=A())" 2>&1 ||
+echo 'command failed: tree "P(.x=A().yy=A())"'
+
+echo '$ tree '\''P(.x=A().y=A())'\'' -- -V'
+tree 'P(.x=A().y=A())' -- -V 2>&1 ||
+echo 'command failed: tree '\''P(.x=A().y=A())'\'' -- -V'
+
+echo '$ tree '\''S(.b=A())'\'' -- -V'
+tree 'S(.b=A())' -- -V 2>&1 ||
+echo 'command failed: tree '\''S(.b=A())'\'' -- -V'
+
+echo '$ tree '\''P(.x=S(.a='\''\'\'''\''0'\''\'\'''\'').y=Q())'\'' -- -V'
+tree 'P(.x=S(.a='\''0'\'').y=Q())' -- -V 2>&1 ||
+echo 'command failed: tree '\''P(.x=S(.a='\''\'\'''\''0'\''\'\'''\'').y=Q())'\'' -- -V'
+
+echo '$ tree '\''P(.x=X().y=A(.k=A()))'\'' -- -V'
+tree 'P(.x=X().y=A(.k=A()))' -- -V 2>&1 ||
+echo 'command failed: tree '\''P(.x=X().y=A(.k=A()))'\'' -- -V'
+
+echo '$ tree '\''N(.x=Z().y=C(.b=list<B>[[0]=B(.a=A()) [1]=A() [2]=X()]).z=D(.c=A()))'\'' -- -V'
+tree 'N(.x=Z().y=C(.b=list<B>[[0]=B(.a=A()) [1]=A() [2]=X()]).z=D(.c=A()))' -- -V 2>&1 ||
+echo 'command failed: tree '\''N(.x=Z().y=C(.b=list<B>[[0]=B(.a=A()) [1]=A() [2]=X()]).z=D(.c=A()))'\'' -- -V'
+
+echo '$ tree '\''C(.b=list<A>[[0]=B(.a=Q())])'\'' -- -V'
+tree 'C(.b=list<A>[[0]=B(.a=Q())])' -- -V 2>&1 ||
+echo 'command failed: tree '\''C(.b=list<A>[[0]=B(.a=Q())])'\'' -- -V'
+
+echo '$ tree "P(.x=A().y=A())" "M(.a=A().b=list<B>[[0]=B(.a=A())[1]=B(.a=A())].c='\''x'\'')" "D(.c='\''x'\'')" -- -o -H --mem-stats'
+tree "P(.x=A().y=A())" "M(.a=A().b=list<B>[[0]=B(.a=A())[1]=B(.a=A())].c='x')" "D(.c='x')" -- -o -H --mem-stats 2>&1 ||
+echo 'command failed: tree "P(.x=A().y=A())" "M(.a=A().b=list<B>[[0]=B(.a=A())[1]=B(.a=A())].c='\''x'\'')" "D(.c='\''x'\'')" -- -o -H --mem-stats'
+
+echo '$ tree "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" -- -o -H --extract --mem-stats'
+tree "M(.a=A().b=list<B>[[0]=B(.a=A())].c='x')" "M(.a=A().b=list<B>[[0]=B(.a=A())].c='x')" -- -o -H --extract --mem-stats 2>&1 ||
+echo 'command failed: tree "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" -- -o -H --extract --mem-stats'
+
+echo '$ tree "D(.c='\''x'\'')" "S('\''0'\'')" "P(.x=A().y=A())" -- -c'
+tree "D(.c='x')" "S('0')" "P(.x=A().y=A())" -- -c 2>&1 ||
+echo 'command failed: tree "D(.c='\''x'\'')" "S('\''0'\'')" "P(.x=A().y=A())" -- -c'
+
+echo '$ rm -f /tmp/tree-type-cache-test{,.lock,.log}'
+rm -f /tmp/tree-type-cache-test{,.lock,.log} 2>&1 ||
+echo 'command failed: rm -f /tmp/tree-type-cache-test{,.lock,.log}'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test --verbose "D(.c='\''x'\'')" "S('\''0'\'')" "D(.c='\''x'\'')" -- -c'
+tree --type-cache=/tmp/tree-type-cache-test --verbose "D(.c='x')" "S('0')" "D(.c='x')" -- -c 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "D(.c='\''x'\'')" "S('\''0'\'')" "D(.c='\''x'\'')" -- -c'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''0'\'')" "P(.x=A().y=A())" -- -c'
+tree --type-cache=/tmp/tree-type-cache-test --verbose "S('0')" "P(.x=A().y=A())" -- -c 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''0'\'')" "P(.x=A().y=A())" -- -c'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -c'
+tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -c 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -c'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -c'
+tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -c 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -c'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -cr'
+tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -cr 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -cr'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -cr'
+tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -cr 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "P(.x=A().y=Q())" -- -cr'
+
+echo '$ rm -f /tmp/tree-type-cache-test{,.lock,.log}'
+rm -f /tmp/tree-type-cache-test{,.lock,.log} 2>&1 ||
+echo 'command failed: rm -f /tmp/tree-type-cache-test{,.lock,.log}'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''0'\'')" -- -c'
+tree --type-cache=/tmp/tree-type-cache-test --verbose "S('0')" -- -c 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''0'\'')" -- -c'
+
+echo '$ f=/tmp/tree-type-cache-test.log; printf 1|dd of=$f bs=1 seek=$(($(stat -c%s $f) - 128)) conv=notrunc status=none'
+f=/tmp/tree-type-cache-test.log; printf 1|dd of=$f bs=1 seek=$(($(stat -c%s $f) - 128)) conv=notrunc status=none 2>&1 ||
+echo 'command failed: f=/tmp/tree-type-cache-test.log; printf 1|dd of=$f bs=1 seek=$(($(stat -c%s $f) - 128)) conv=notrunc status=none'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''0'\'')" -- -c'
+tree --type-cache=/tmp/tree-type-cache-test --verbose "S('0')" -- -c 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''0'\'')" -- -c'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''0'\'')" -- -c'
+tree --type-cache=/tmp/tree-type-cache-test --verbose "S('0')" -- -c 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''0'\'')" -- -c'
+
+echo '$ rm -f /tmp/tree-type-cache-test{,.lock,.log}'
+rm -f /tmp/tree-type-cache-test{,.lock,.log} 2>&1 ||
+echo 'command failed: rm -f /tmp/tree-type-cache-test{,.lock,.log}'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test $(for i in {0..1029}; do echo -n "S('\''$i'\'') "; done) -- -c|uniq -c'
+tree --type-cache=/tmp/tree-type-cache-test $(for i in {0..1029}; do echo -n "S('$i') "; done) -- -c|uniq -c 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test $(for i in {0..1029}; do echo -n "S('\''$i'\'') "; done) -- -c|uniq -c'
+
+echo '$ ls /tmp/tree-type-cache-test*; stat -c%s /tmp/tree-type-cache-test'
+ls /tmp/tree-type-cache-test*; stat -c%s /tmp/tree-type-cache-test 2>&1 ||
+echo 'command failed: ls /tmp/tree-type-cache-test*; stat -c%s /tmp/tree-type-cache-test'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''1000'\'')" "S('\''x'\'')" -- -c'
+tree --type-cache=/tmp/tree-type-cache-test --verbose "S('1000')" "S('x')" -- -c 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''1000'\'')" "S('\''x'\'')" -- -c'
+
+echo '$ ls /tmp/tree-type-cache-test*'
+ls /tmp/tree-type-cache-test* 2>&1 ||
+echo 'command failed: ls /tmp/tree-type-cache-test*'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''1000'\'')" "S('\''x'\'')" -- -c'
+tree --type-cache=/tmp/tree-type-cache-test --verbose "S('1000')" "S('x')" -- -c 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "S('\''1000'\'')" "S('\''x'\'')" -- -c'
+
+echo '$ rm -f /tmp/tree-type-cache-test{,.lock,.log}'
+rm -f /tmp/tree-type-cache-test{,.lock,.log} 2>&1 ||
+echo 'command failed: rm -f /tmp/tree-type-cache-test{,.lock,.log}'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test-none/x "P(.x=A().y=Q())" -- -c'
+tree --type-cache=/tmp/tree-type-cache-test-none/x "P(.x=A().y=Q())" -- -c 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test-none/x "P(.x=A().y=Q())" -- -c'
+
+echo '$ rm -f /tmp/tree-trace-test'
+rm -f /tmp/tree-trace-test 2>&1 ||
+echo 'command failed: rm -f /tmp/tree-trace-test'
+
+echo '$ tree "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "P(.x=A().y=Q())" -- -T'
+tree "M(.a=A().b=list<B>[[0]=B(.a=A())].c='x')" "P(.x=A().y=Q())" -- -T 2>&1 ||
+echo 'command failed: tree "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "P(.x=A().y=Q())" -- -T'
+
+echo '$ tree "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "P(.x=A().y=Q())" -- --trace-file=/tmp/tree-trace-test'
+tree "M(.a=A().b=list<B>[[0]=B(.a=A())].c='x')" "P(.x=A().y=Q())" -- --trace-file=/tmp/tree-trace-test 2>&1 ||
+echo 'command failed: tree "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "P(.x=A().y=Q())" -- --trace-file=/tmp/tree-trace-test'
+
+echo '$ tree -- --decode-trace --trace-file=/tmp/tree-trace-test'
+tree -- --decode-trace --trace-file=/tmp/tree-trace-test 2>&1 ||
+echo 'command failed: tree -- --decode-trace --trace-file=/tmp/tree-trace-test'
+
+echo '$ tree -- --decode-trace'
+tree -- --decode-trace 2>&1 ||
+echo 'command failed: tree -- --decode-trace'
+
+echo '$ rm -f /tmp/tree-trace-test'
+rm -f /tmp/tree-trace-test 2>&1 ||
+echo 'command failed: rm -f /tmp/tree-trace-test'
+
+echo '$ ./tree-phash $(sed -n '\''/> AST_TYPEMAKER_NEW_FUNCS/,/< AST_TYPEMAKER_NEW_FUNCS/s/^ *new_funcs_t("\([^"]*\)".*/\1/p'\'' abc/abc.cpp)|diff -u - <(sed -n '\''/^static constexpr const char\* type_names\[\]/,/^static constexpr uint32_t type_seed/p'\'' abc/abc.cpp)'
+./tree-phash $(sed -n '/> AST_TYPEMAKER_NEW_FUNCS/,/< AST_TYPEMAKER_NEW_FUNCS/s/^ *new_funcs_t("\([^"]*\)".*/\1/p' abc/abc.cpp)|diff -u - <(sed -n '/^static constexpr const char\* type_names\[\]/,/^static constexpr uint32_t type_seed/p' abc/abc.cpp) 2>&1 ||
+echo 'command failed: ./tree-phash $(sed -n '\''/> AST_TYPEMAKER_NEW_FUNCS/,/< AST_TYPEMAKER_NEW_FUNCS/s/^ *new_funcs_t("\([^"]*\)".*/\1/p'\'' abc/abc.cpp)|diff -u - <(sed -n '\''/^static constexpr const char\* type_names\[\]/,/^static constexpr uint32_t type_seed/p'\'' abc/abc.cpp)'
+
+echo '$ ./tree-phash -b3 A B C'
+./tree-phash -b3 A B C 2>&1 ||
+echo 'command failed: ./tree-phash -b3 A B C'
+
+echo '$ ./tree-phash A B A'
+./tree-phash A B A 2>&1 ||
+echo 'command failed: ./tree-phash A B A'
+
+echo '$ ./tree-phash -b2 A B C D'
+./tree-phash -b2 A B C D 2>&1 ||
+echo 'command failed: ./tree-phash -b2 A B C D'
+
+echo '$ ./tree-phash'
+./tree-phash 2>&1 ||
+echo 'command failed: ./tree-phash'
 )
 
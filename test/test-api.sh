@@ -0,0 +1,127 @@
+#!/bin/bash
+
+# Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+# 
+# This file is part of C++Py-Tree.
+# 
+# C++Py-Tree is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# C++Py-Tree is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#
+# File generated by a command like:
+# $ gen-test -T api
+#
+
+[[ "$1" =~ ^-u[0-9]+$ ]] &&
+u="${1:2}" ||
+u=""
+
+diff -u$u -L api.old <(echo \
+'$ cd ../src/tree
+$ export LD_LIBRARY_PATH=.:abc:cxxpy
+$ ./tree-api abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "B()" "A(" cxxpy/cxxpy.so "Ident('\''a'\'')" abc/abc.so "P(.x=A().y=Q())"
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''M'\''))
+tree-api: error: ast-type B: expected 1 args, but got 0
+tree-api: error: parse error: <text>:1:3: unexpected token EOS in node_args
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''Ident'\''))
+tree-api: error: ast-type P: arg #2: cannot cast from type '\''Q'\'' to '\''A'\''
+command failed: ./tree-api abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "B()" "A(" cxxpy/cxxpy.so "Ident('\''a'\'')" abc/abc.so "P(.x=A().y=Q())"
+$ ./tree-api -o abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" abc/abc.so "P(.x=A().y=Q())"
+M(.a=A().b=list<B>[[0]=B(.a=A())]'\''x'\'')
+tree-api: error: ast-type ExprStmt: arg #1: cannot cast from type '\''IdentExpr'\'' to '\''Expr'\''
+tree-api: error: ast-type P: arg #2: cannot cast from type '\''Q'\'' to '\''A'\''
+command failed: ./tree-api -o abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" abc/abc.so "P(.x=A().y=Q())"
+$ ./tree-api -o -r cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" abc/abc.so "P(.x=A().y=Q())" "S(.b=Q())"
+StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])
+P(.x=A().y=Q())
+tree-api: error: ast-type S: arg #1: cannot cast from type '\''Q'\'' to '\''bool'\''
+command failed: ./tree-api -o -r cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" abc/abc.so "P(.x=A().y=Q())" "S(.b=Q())"
+$ ./tree-api -H -o abc/abc.so "P(.x=A().y=A())" "C(.b=list<B>[[0]=B(.a=A()) [1]=B(.a=A())])"
+P(.x=A().y=A())
+C(.b=list<B>[[0]=B(.a=A())[1]=B(.a=A())])
+$ ./tree-api -r -n 10 abc/abc.so "A()"|sed '\''s/[0-9.]\+us$/Nus/'\''
+parse:  Nus
+action: Nus
+$ ./tree-api "A()"
+tree-api: error: no module given for input '\''A()'\''
+command failed: ./tree-api "A()"
+$ ./tree-api schema/schema.so "A()"
+tree-api: error: cannot find func '\''schema_session_new'\'': schema/schema.so: undefined symbol: schema_session_new
+command failed: ./tree-api schema/schema.so "A()"
+$ ./tree-api -j 8 -o -r abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "B()" cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" abc/abc.so "P(.x=A().y=Q())"
+M(.a=A().b=list<B>[[0]=B(.a=A())]'\''x'\'')
+tree-api: error: ast-type B: expected 1 args, but got 0
+StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])
+P(.x=A().y=Q())
+command failed: ./tree-api -j 8 -o -r abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "B()" cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" abc/abc.so "P(.x=A().y=Q())"
+$ ./tree-api -j 2 -n 2 abc/abc.so "A()"
+tree-api: error: repeating and jobs are exclusive
+command failed: ./tree-api -j 2 -n 2 abc/abc.so "A()"
+$ comm -12 <(nm -D --defined-only abc/abc.so|awk '\''{print $3}'\''|LC_ALL=C sort) <(nm -D --defined-only cxxpy/cxxpy.so|awk '\''{print $3}'\''|LC_ALL=C sort)|c++filt|grep -v '\''std::'\''|LC_ALL=C sort -u
+AST::AST::node_t::names
+AST::Visitor::visit(AST::Node const*)
+AST::Visitor::~Visitor()
+program
+typeinfo for AST::Visitor
+typeinfo name for AST::Visitor
+vtable for AST::Visitor'
+) -L api.new <(
+echo '$ cd ../src/tree'
+cd ../src/tree 2>&1 ||
+echo 'command failed: cd ../src/tree'
+
+echo '$ export LD_LIBRARY_PATH=.:abc:cxxpy'
+export LD_LIBRARY_PATH=.:abc:cxxpy 2>&1 ||
+echo 'command failed: export LD_LIBRARY_PATH=.:abc:cxxpy'
+
+echo '$ ./tree-api abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "B()" "A(" cxxpy/cxxpy.so "Ident('\''a'\'')" abc/abc.so "P(.x=A().y=Q())"'
+./tree-api abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='x')" "B()" "A(" cxxpy/cxxpy.so "Ident('a')" abc/abc.so "P(.x=A().y=Q())" 2>&1 ||
+echo 'command failed: ./tree-api abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "B()" "A(" cxxpy/cxxpy.so "Ident('\''a'\'')" abc/abc.so "P(.x=A().y=Q())"'
+
+echo '$ ./tree-api -o abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" abc/abc.so "P(.x=A().y=Q())"'
+./tree-api -o abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='x')" cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('self')))])" abc/abc.so "P(.x=A().y=Q())" 2>&1 ||
+echo 'command failed: ./tree-api -o abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" abc/abc.so "P(.x=A().y=Q())"'
+
+echo '$ ./tree-api -o -r cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" abc/abc.so "P(.x=A().y=Q())" "S(.b=Q())"'
+./tree-api -o -r cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('self')))])" abc/abc.so "P(.x=A().y=Q())" "S(.b=Q())" 2>&1 ||
+echo 'command failed: ./tree-api -o -r cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" abc/abc.so "P(.x=A().y=Q())" "S(.b=Q())"'
+
+echo '$ ./tree-api -H -o abc/abc.so "P(.x=A().y=A())" "C(.b=list<B>[[0]=B(.a=A()) [1]=B(.a=A())])"'
+./tree-api -H -o abc/abc.so "P(.x=A().y=A())" "C(.b=list<B>[[0]=B(.a=A()) [1]=B(.a=A())])" 2>&1 ||
+echo 'command failed: ./tree-api -H -o abc/abc.so "P(.x=A().y=A())" "C(.b=list<B>[[0]=B(.a=A()) [1]=B(.a=A())])"'
+
+echo '$ ./tree-api -r -n 10 abc/abc.so "A()"|sed '\''s/[0-9.]\+us$/Nus/'\'''
+./tree-api -r -n 10 abc/abc.so "A()"|sed 's/[0-9.]\+us$/Nus/' 2>&1 ||
+echo 'command failed: ./tree-api -r -n 10 abc/abc.so "A()"|sed '\''s/[0-9.]\+us$/Nus/'\'''
+
+echo '$ ./tree-api "A()"'
+./tree-api "A()" 2>&1 ||
+echo 'command failed: ./tree-api "A()"'
+
+echo '$ ./tree-api schema/schema.so "A()"'
+./tree-api schema/schema.so "A()" 2>&1 ||
+echo 'command failed: ./tree-api schema/schema.so "A()"'
+
+echo '$ ./tree-api -j 8 -o -r abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "B()" cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" abc/abc.so "P(.x=A().y=Q())"'
+./tree-api -j 8 -o -r abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='x')" "B()" cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('self')))])" abc/abc.so "P(.x=A().y=Q())" 2>&1 ||
+echo 'command failed: ./tree-api -j 8 -o -r abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "B()" cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" abc/abc.so "P(.x=A().y=Q())"'
+
+echo '$ ./tree-api -j 2 -n 2 abc/abc.so "A()"'
+./tree-api -j 2 -n 2 abc/abc.so "A()" 2>&1 ||
+echo 'command failed: ./tree-api -j 2 -n 2 abc/abc.so "A()"'
+
+echo '$ comm -12 <(nm -D --defined-only abc/abc.so|awk '\''{print $3}'\''|LC_ALL=C sort) <(nm -D --defined-only cxxpy/cxxpy.so|awk '\''{print $3}'\''|LC_ALL=C sort)|c++filt|grep -v '\''std::'\''|LC_ALL=C sort -u'
+comm -12 <(nm -D --defined-only abc/abc.so|awk '{print $3}'|LC_ALL=C sort) <(nm -D --defined-only cxxpy/cxxpy.so|awk '{print $3}'|LC_ALL=C sort)|c++filt|grep -v 'std::'|LC_ALL=C sort -u 2>&1 ||
+echo 'command failed: comm -12 <(nm -D --defined-only abc/abc.so|awk '\''{print $3}'\''|LC_ALL=C sort) <(nm -D --defined-only cxxpy/cxxpy.so|awk '\''{print $3}'\''|LC_ALL=C sort)|c++filt|grep -v '\''std::'\''|LC_ALL=C sort -u'
+)
+
@@ -74,7 +74,53 @@ $ tree -- -t
 <FileInput> : Node @ <StmtList>* [stmts];
 <InteractInput> : Node @ <SimpleStmtList>* [stmts];
 <EvalInput> : Node @ <Expr>* [expr];
-<InputInput> : Node @ <Expr>* [expr];'
+<InputInput> : Node @ <Expr>* [expr];
+$ tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))[1]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- -o -r -H --verbose
+tree: cxxpy: hash-cons: nodes: 7 shared: 3 ratio: 42.86% strings: 2 shared: 1 lists: 1 shared: 0
+StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))[1]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])
+$ tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- -o -r --mem-stats
+tree: cxxpy: mem-stats: pool=node objs=4 max-objs=8192 bytes=144 max-bytes=131072 padding=32 rollbacks=0 high-water=144
+tree: cxxpy: mem-stats: pool=raw objs=2 max-objs=4096 bytes=22 max-bytes=65536 padding=9 rollbacks=0 high-water=22
+tree: cxxpy: mem-stats: type=ExprStmt count=1 bytes=24
+tree: cxxpy: mem-stats: type=Ident count=1 bytes=32
+tree: cxxpy: mem-stats: type=IdentExpr count=1 bytes=24
+tree: cxxpy: mem-stats: type=StmtList count=1 bytes=32
+StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])
+$ tree "Ident('\''a'\'')" "Ident('\''a'\'')" "Ident('\''b'\'')" -- -o --fingerprint
+tree: cxxpy: fingerprint: 3ad2bc1e9acaf87af0d628002b386322
+Ident('\''a'\'')
+tree: cxxpy: fingerprint: 3ad2bc1e9acaf87af0d628002b386322
+Ident('\''a'\'')
+tree: cxxpy: fingerprint: 00d74c9ab6f4d9e7d1c254a08ae22d35
+Ident('\''b'\'')
+$ tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))[1]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- -o -r -H --extract --mem-stats --fingerprint
+tree: cxxpy: mem-stats: pool=node objs=4 max-objs=4 bytes=144 max-bytes=144 padding=32 rollbacks=0 high-water=144
+tree: cxxpy: mem-stats: pool=raw objs=2 max-objs=2 bytes=30 max-bytes=30 padding=9 rollbacks=0 high-water=30
+tree: cxxpy: mem-stats: type=ExprStmt count=1 bytes=24
+tree: cxxpy: mem-stats: type=Ident count=1 bytes=32
+tree: cxxpy: mem-stats: type=IdentExpr count=1 bytes=24
+tree: cxxpy: mem-stats: type=StmtList count=1 bytes=32
+tree: cxxpy: fingerprint: e3050c1c92286496beaad2effee32dd9
+StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))[1]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])
+$ tree "Stmts()"
+tree: error: unknown AST type name '\''Stmts'\''
+command failed: tree "Stmts()"
+$ tree "stmt()"
+tree: parse error: <text>:1:1: expected token IDENT but got NAME
+command failed: tree "stmt()"
+$ tree "StmtList(.list=list<AssertStmt1>[[0]=AssertStmt1(.expr1=Expr())])" -- -or
+StmtList(.list=list<Stmt>[[0]=AssertStmt1(.expr1=Expr())])
+$ tree "StmtList(.list=list<AssertStmt1>[[0]=AssertStmt1(.expr1=Expr())])" -- -os
+tree: error: ast-type StmtList: arg #1: cannot cast from type '\''list<AssertStmt1>'\'' to '\''list<Stmt>'\''
+command failed: tree "StmtList(.list=list<AssertStmt1>[[0]=AssertStmt1(.expr1=Expr())])" -- -os
+$ tree "SimpleStmtList(.list=list<Stmt>[[0]=AssertStmt1(.expr1=Expr())])" -- -or
+tree: error: ast-type SimpleStmtList: arg #1: cannot cast from type '\''list<Stmt>'\'' to '\''list<SimpleStmt>'\''
+command failed: tree "SimpleStmtList(.list=list<Stmt>[[0]=AssertStmt1(.expr1=Expr())])" -- -or
+$ tree "FileInput(.stmts=SimpleStmtList(.list=list<SimpleStmt>[]))" -- -or
+tree: error: ast-type FileInput: arg #1: cannot cast from type '\''SimpleStmtList'\'' to '\''StmtList'\''
+command failed: tree "FileInput(.stmts=SimpleStmtList(.list=list<SimpleStmt>[]))" -- -or
+$ tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=ArgsCallExpr(.expr=IdentExpr(.ident=Ident('\''f'\'')).args=CallArgList(.list=list<CallArg>[[0]=CallArg(.expr=IdentExpr(.ident=Ident('\''a'\'')))[1]=CallArg(.expr=IdentExpr(.ident=Ident('\''b'\'')))])))[1]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''c'\'')))])" -- -o -r
+StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=ArgsCallExpr(.expr=IdentExpr(.ident=Ident('\''f'\'')).args=CallArgList(.list=list<CallArg>[[0]=CallArg(.expr=IdentExpr(.ident=Ident('\''a'\'')))[1]=CallArg(.expr=IdentExpr(.ident=Ident('\''b'\'')))])))[1]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''c'\'')))])'
 ) -L cxxpy.new <(
 echo '$ cd ../src/tree'
 cd ../src/tree 2>&1 ||
@@ -91,5 +137,49 @@ echo 'command failed: tree() { ./tree -F cxxpy/cxxpy.so "$@"; }'
 echo '$ tree -- -t'
 tree -- -t 2>&1 ||
 echo 'command failed: tree -- -t'
+
+echo '$ tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))[1]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- -o -r -H --verbose'
+tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('self')))[1]=ExprStmt(.expr=IdentExpr(.ident=Ident('self')))])" -- -o -r -H --verbose 2>&1 ||
+echo 'command failed: tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))[1]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- -o -r -H --verbose'
+
+echo '$ tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- -o -r --mem-stats'
+tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('self')))])" -- -o -r --mem-stats 2>&1 ||
+echo 'command failed: tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- -o -r --mem-stats'
+
+echo '$ tree "Ident('\''a'\'')" "Ident('\''a'\'')" "Ident('\''b'\'')" -- -o --fingerprint'
+tree "Ident('a')" "Ident('a')" "Ident('b')" -- -o --fingerprint 2>&1 ||
+echo 'command failed: tree "Ident('\''a'\'')" "Ident('\''a'\'')" "Ident('\''b'\'')" -- -o --fingerprint'
+
+echo '$ tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))[1]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- -o -r -H --extract --mem-stats --fingerprint'
+tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('self')))[1]=ExprStmt(.expr=IdentExpr(.ident=Ident('self')))])" -- -o -r -H --extract --mem-stats --fingerprint 2>&1 ||
+echo 'command failed: tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))[1]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- -o -r -H --extract --mem-stats --fingerprint'
+
+echo '$ tree "Stmts()"'
+tree "Stmts()" 2>&1 ||
+echo 'command failed: tree "Stmts()"'
+
+echo '$ tree "stmt()"'
+tree "stmt()" 2>&1 ||
+echo 'command failed: tree "stmt()"'
+
+echo '$ tree "StmtList(.list=list<AssertStmt1>[[0]=AssertStmt1(.expr1=Expr())])" -- -or'
+tree "StmtList(.list=list<AssertStmt1>[[0]=AssertStmt1(.expr1=Expr())])" -- -or 2>&1 ||
+echo 'command failed: tree "StmtList(.list=list<AssertStmt1>[[0]=AssertStmt1(.expr1=Expr())])" -- -or'
+
+echo '$ tree "StmtList(.list=list<AssertStmt1>[[0]=AssertStmt1(.expr1=Expr())])" -- -os'
+tree "StmtList(.list=list<AssertStmt1>[[0]=AssertStmt1(.expr1=Expr())])" -- -os 2>&1 ||
+echo 'command failed: tree "StmtList(.list=list<AssertStmt1>[[0]=AssertStmt1(.expr1=Expr())])" -- -os'
+
+echo '$ tree "SimpleStmtList(.list=list<Stmt>[[0]=AssertStmt1(.expr1=Expr())])" -- -or'
+tree "SimpleStmtList(.list=list<Stmt>[[0]=AssertStmt1(.expr1=Expr())])" -- -or 2>&1 ||
+echo 'command failed: tree "SimpleStmtList(.list=list<Stmt>[[0]=AssertStmt1(.expr1=Expr())])" -- -or'
+
+echo '$ tree "FileInput(.stmts=SimpleStmtList(.list=list<SimpleStmt>[]))" -- -or'
+tree "FileInput(.stmts=SimpleStmtList(.list=list<SimpleStmt>[]))" -- -or 2>&1 ||
+echo 'command failed: tree "FileInput(.stmts=SimpleStmtList(.list=list<SimpleStmt>[]))" -- -or'
+
+echo '$ tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=ArgsCallExpr(.expr=IdentExpr(.ident=Ident('\''f'\'')).args=CallArgList(.list=list<CallArg>[[0]=CallArg(.expr=IdentExpr(.ident=Ident('\''a'\'')))[1]=CallArg(.expr=IdentExpr(.ident=Ident('\''b'\'')))])))[1]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''c'\'')))])" -- -o -r'
+tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=ArgsCallExpr(.expr=IdentExpr(.ident=Ident('f')).args=CallArgList(.list=list<CallArg>[[0]=CallArg(.expr=IdentExpr(.ident=Ident('a')))[1]=CallArg(.expr=IdentExpr(.ident=Ident('b')))])))[1]=ExprStmt(.expr=IdentExpr(.ident=Ident('c')))])" -- -o -r 2>&1 ||
+echo 'command failed: tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=ArgsCallExpr(.expr=IdentExpr(.ident=Ident('\''f'\'')).args=CallArgList(.list=list<CallArg>[[0]=CallArg(.expr=IdentExpr(.ident=Ident('\''a'\'')))[1]=CallArg(.expr=IdentExpr(.ident=Ident('\''b'\'')))])))[1]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''c'\'')))])" -- -o -r'
 )
 
@@ -44,6 +44,19 @@ where the actions are:
 the options are:
   -f|--file            input type: file
   -t|--text            input type: text (default)
+  -H|--hash-cons       hash-cons or not the parsed AST (default not)
+     --no-hash-cons
+  -R|--relayout[=NUM]  relayout or not the parsed AST in depth-first order -- into a node pool of NUM objects (default not)
+     --no-relayout
+     --extract         extract or not the parsed AST into a copy having pools sized to fit (default not)
+     --no-extract
+     --mem-stats       print or not memory statistics of the parsed AST (default not)
+     --no-mem-stats
+     --fingerprint     print or not the structural fingerprint of the parsed AST (default not)
+     --no-fingerprint
+     --type-cache=FILE cache in FILE the verdicts of the type checks of the extension module
+     --serve[=SOCKET]  serve the requests read from stdin -- or else from connections to the Unix socket SOCKET
+     --workers=NUM     serve the connections to SOCKET using NUM threads -- executing their requests concurrently (default 4)
   -d|--debug           print some debugging output
   -D|--no-debug        do not print debugging output (default)
      --debug-ext-func  pass '\''--debug'\'' to inner extension function
@@ -66,6 +79,9 @@ where the actions are:
 the options are:
   -i|--indent-dots     print or not indenting dots (default not)
   -I|--no-indent-dots
+  -c|--compact         use or not the compact AST representation when printing
+                         prettily or tersely (default not)
+  -C|--no-compact
   -d|--debug           print some debugging output
   -D|--no-debug        do not print debugging output (default)
      --debug-ext-func  pass '\''--debug'\'' to inner extension function
@@ -78,9 +94,11 @@ $ ./tree -F cxxpy/cxxpy.so --help-ext
 usage: tree (action|option)* (input)*
 where the actions are:
   -c|--type-check      type check given input (default)
+  -V|--validate        type check given input reporting all type errors
   -A|--ast-build       build the AST object of given input
   -t|--print-types     output the AST type definitions of given module
   -o|--print-obj       build and print the AST object of given input
+     --decode-trace    print out in text the binary evaluation trace of '\''--trace-file'\''
   -F|--ext-function <module-name>[::<func-name>]
                        load given module and run specified func -- 
                          when function name was not given take it as
@@ -90,6 +108,15 @@ the options are:
   -s|--strict-casts    when evaluating AST objects make exact type casts (default)
   -T|--trace-eval      trace or not the tree evaluation algorithm (default not)
      --no-trace-eval
+  -H|--hash-cons       hash-cons or not the built AST (default not)
+     --no-hash-cons
+     --extract         extract or not the built AST into a copy having pools sized to fit (default not)
+     --no-extract
+     --mem-stats       print or not memory statistics of the built AST (default not)
+     --no-mem-stats
+     --fingerprint     print or not the structural fingerprint of the built AST (default not)
+     --no-fingerprint
+     --trace-file=FILE write the binary trace of the tree evaluation algorithm into FILE
   -d|--debug           print some debugging output
   -D|--no-debug        do not print debugging output (default)
      --debug-ext-func  pass '\''--debug'\'' to inner extension function
@@ -102,9 +129,11 @@ $ ./tree -F abc/abc.so --help-ext
 usage: tree (action|option)* (input)*
 where the actions are:
   -c|--type-check      type check given input (default)
+  -V|--validate        type check given input reporting all type errors
   -A|--ast-build       build the AST object of given input
   -t|--print-types     output the AST type definitions of given module
   -o|--print-obj       build and print the AST object of given input
+     --decode-trace    print out in text the binary evaluation trace of '\''--trace-file'\''
   -F|--ext-function <module-name>[::<func-name>]
                        load given module and run specified func -- 
                          when function name was not given take it as
@@ -114,6 +143,15 @@ the options are:
   -s|--strict-casts    when evaluating AST objects make exact type casts (default)
   -T|--trace-eval      trace or not the tree evaluation algorithm (default not)
      --no-trace-eval
+  -H|--hash-cons       hash-cons or not the built AST (default not)
+     --no-hash-cons
+     --extract         extract or not the built AST into a copy having pools sized to fit (default not)
+     --no-extract
+     --mem-stats       print or not memory statistics of the built AST (default not)
+     --no-mem-stats
+     --fingerprint     print or not the structural fingerprint of the built AST (default not)
+     --no-fingerprint
+     --trace-file=FILE write the binary trace of the tree evaluation algorithm into FILE
   -d|--debug           print some debugging output
   -D|--no-debug        do not print debugging output (default)
      --debug-ext-func  pass '\''--debug'\'' to inner extension function
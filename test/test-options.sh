@@ -34,6 +34,14 @@ home-dir:       .
 action:         pretty-print
 ext-func-name:  printer::pretty_print
 input-type:     text
+hash-cons:      no
+relayout:       no
+extract:        no
+mem-stats:      no
+fingerprint:    no
+type-cache:     -
+serve:          -
+workers:        4
 debug:          no
 debug-ext-func: no
 help-ext-func:  no
@@ -45,6 +53,7 @@ home-dir:       .
 action:         print-ast
 ext-func-name:  -
 indent-dots:    no
+compact:        no
 debug:          no
 debug-ext-func: no
 help-ext-func:  no
@@ -57,6 +66,11 @@ action:         type-check
 ext-func-name:  -
 casts-type:     strict-casts
 trace-eval:     no
+hash-cons:      no
+extract:        no
+mem-stats:      no
+fingerprint:    no
+trace-file:     -
 debug:          no
 debug-ext-func: no
 help-ext-func:  no
@@ -69,6 +83,11 @@ action:         type-check
 ext-func-name:  -
 casts-type:     strict-casts
 trace-eval:     no
+hash-cons:      no
+extract:        no
+mem-stats:      no
+fingerprint:    no
+trace-file:     -
 debug:          no
 debug-ext-func: no
 help-ext-func:  no
@@ -216,7 +216,30 @@ A(
 .   .   [1] = C()
 .   .   [0] = D('\''x'\'')
 .   ]
-)'
+)
+$ tree() { ./tree "$@" -- -i -c; }
+$ tree -P "A(.x=B().y='\''C'\''.z=D('\''E'\''))"
+A(
+.   .x = B()
+.   .y = '\''C'\''
+.   .z = D('\''E'\'')
+)
+$ tree -T "A(.x=B().y='\''C'\''.z=D('\''E'\''))"
+A(.x=B().y='\''C'\''.z=D('\''E'\''))
+$ tree -P "A(.l=list<B>[[1]=C()[0]=D('\''x'\'')])"
+A(
+.   .l = list<B> [
+.   .   [1] = C()
+.   .   [0] = D('\''x'\'')
+.   ]
+)
+$ tree -T "A(.l=list<B>[[1]=C()[0]=D('\''x'\'')])"
+A(.l=list<B>[[1]=C()[0]=D('\''x'\'')])
+$ t='\''B()'\''; for i in {1..500}; do t="A(.x=$t)"; done
+$ tree -T "$t"|wc -c
+3004
+$ cmp <(./tree -T "$t" -- -i) <(tree -T "$t") && echo same
+same'
 ) -L print.new <(
 echo '$ cd ../src/tree'
 cd ../src/tree 2>&1 ||
@@ -269,5 +292,37 @@ echo 'command failed: tree -u "A(.l=list<B>[[1]=C()[0]=D('\''x'\'')])"'
 echo '$ tree -P "A(.l=list<B>[[1]=C()[0]=D('\''x'\'')])"'
 tree -P "A(.l=list<B>[[1]=C()[0]=D('x')])" 2>&1 ||
 echo 'command failed: tree -P "A(.l=list<B>[[1]=C()[0]=D('\''x'\'')])"'
+
+echo '$ tree() { ./tree "$@" -- -i -c; }'
+tree() { ./tree "$@" -- -i -c; } 2>&1 ||
+echo 'command failed: tree() { ./tree "$@" -- -i -c; }'
+
+echo '$ tree -P "A(.x=B().y='\''C'\''.z=D('\''E'\''))"'
+tree -P "A(.x=B().y='C'.z=D('E'))" 2>&1 ||
+echo 'command failed: tree -P "A(.x=B().y='\''C'\''.z=D('\''E'\''))"'
+
+echo '$ tree -T "A(.x=B().y='\''C'\''.z=D('\''E'\''))"'
+tree -T "A(.x=B().y='C'.z=D('E'))" 2>&1 ||
+echo 'command failed: tree -T "A(.x=B().y='\''C'\''.z=D('\''E'\''))"'
+
+echo '$ tree -P "A(.l=list<B>[[1]=C()[0]=D('\''x'\'')])"'
+tree -P "A(.l=list<B>[[1]=C()[0]=D('x')])" 2>&1 ||
+echo 'command failed: tree -P "A(.l=list<B>[[1]=C()[0]=D('\''x'\'')])"'
+
+echo '$ tree -T "A(.l=list<B>[[1]=C()[0]=D('\''x'\'')])"'
+tree -T "A(.l=list<B>[[1]=C()[0]=D('x')])" 2>&1 ||
+echo 'command failed: tree -T "A(.l=list<B>[[1]=C()[0]=D('\''x'\'')])"'
+
+echo '$ t='\''B()'\''; for i in {1..500}; do t="A(.x=$t)"; done'
+t='B()'; for i in {1..500}; do t="A(.x=$t)"; done 2>&1 ||
+echo 'command failed: t='\''B()'\''; for i in {1..500}; do t="A(.x=$t)"; done'
+
+echo '$ tree -T "$t"|wc -c'
+tree -T "$t"|wc -c 2>&1 ||
+echo 'command failed: tree -T "$t"|wc -c'
+
+echo '$ cmp <(./tree -T "$t" -- -i) <(tree -T "$t") && echo same'
+cmp <(./tree -T "$t" -- -i) <(tree -T "$t") && echo same 2>&1 ||
+echo 'command failed: cmp <(./tree -T "$t" -- -i) <(tree -T "$t") && echo same'
 )
 
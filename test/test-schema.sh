@@ -0,0 +1,215 @@
+#!/bin/bash
+
+# Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+# 
+# This file is part of C++Py-Tree.
+# 
+# C++Py-Tree is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# C++Py-Tree is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#
+# File generated by a command like:
+# $ gen-test -T schema
+#
+
+[[ "$1" =~ ^-u[0-9]+$ ]] &&
+u="${1:2}" ||
+u=""
+
+diff -u$u -L schema.old <(echo \
+'$ cd ../src/tree
+$ export LD_LIBRARY_PATH=.:abc:cxxpy
+$ tree() { ./tree -F schema/schema.so "$@"; }
+$ tree -- --schema=abc/grammar.g++ -t|diff -u - <(./tree -F abc/abc.so -- -t)
+$ tree -- --schema=cxxpy/grammar.g++ -t|diff -u - <(./tree -F cxxpy/cxxpy.so -- -t)
+$ tree "P(.x=A().y=Q())" -- --schema=abc/grammar.g++
+tree: error: ast-type P: arg #2: cannot cast from type '\''Q'\'' to '\''A'\''
+command failed: tree "P(.x=A().y=Q())" -- --schema=abc/grammar.g++
+$ tree "P(.x=A().y=Q())" -- --schema=abc/grammar.g++ -r
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''P'\''))
+$ tree "L(.q=list<R>[[0]=A()])" -- --schema=abc/grammar.g++ -r
+tree: error: list<R>: arg #0: cannot cast from type '\''A'\''
+command failed: tree "L(.q=list<R>[[0]=A()])" -- --schema=abc/grammar.g++ -r
+$ tree "N(.x=B(.a=Q()).y=C(.b=list<B>[[0]=B(.a=R())]).z=D(.c='\''x'\''))" -- --schema=abc/grammar.g++ -r
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''N'\''))
+$ tree '\''N(.x=Z().y=C(.b=list<B>[[0]=B(.a=A()) [1]=A() [2]=X()]).z=D(.c=A()))'\'' -- --schema=abc/grammar.g++ -V
+tree: error: N.x: unknown AST type name '\''Z'\''
+tree: error: N.y.b[2]: unknown AST type name '\''X'\''
+tree: error: N.y.b: list<B>: arg #1: cannot cast from type '\''A'\''
+tree: error: N.z: ast-type D: arg #1: cannot cast from type '\''A'\'' to '\''char*'\''
+command failed: tree '\''N(.x=Z().y=C(.b=list<B>[[0]=B(.a=A()) [1]=A() [2]=X()]).z=D(.c=A()))'\'' -- --schema=abc/grammar.g++ -V
+$ tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- --schema=cxxpy/grammar.g++
+tree: error: ast-type ExprStmt: arg #1: cannot cast from type '\''IdentExpr'\'' to '\''Expr'\''
+command failed: tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- --schema=cxxpy/grammar.g++
+$ tree "SimpleStmtList(.list=list<Stmt>[[0]=AssertStmt1(.expr1=Expr())])" -- --schema=cxxpy/grammar.g++ -r
+tree: error: ast-type SimpleStmtList: arg #1: cannot cast from type '\''list<Stmt>'\'' to '\''list<SimpleStmt>'\''
+command failed: tree "SimpleStmtList(.list=list<Stmt>[[0]=AssertStmt1(.expr1=Expr())])" -- --schema=cxxpy/grammar.g++ -r
+$ tree "P(.x=A().y=Q())"
+tree: schema: error: no schema given
+command failed: tree "P(.x=A().y=Q())"
+$ tree "P(.x=A().y=Q())" -- --schema=abc/grammar.g++ -o
+tree: schema: error: action '\''print-obj'\'' is not supported
+command failed: tree "P(.x=A().y=Q())" -- --schema=abc/grammar.g++ -o
+$ tree -- --schema=abc/grammar.g++
+tree: schema: error: no input given
+command failed: tree -- --schema=abc/grammar.g++
+$ tree -- --schema=/tmp/tree-schema-nofile -t
+tree: error: schema: /tmp/tree-schema-nofile: cannot open file: No such file or directory
+command failed: tree -- --schema=/tmp/tree-schema-nofile -t
+$ printf '\''<A> : Node;\n<B> : A @ <A>* [a];\n<A> : B;\n'\'' > /tmp/tree-schema-test
+$ tree -- --schema=/tmp/tree-schema-test -t
+tree: error: schema: /tmp/tree-schema-test:3: duplicate type '\''A'\'' -- see line 1
+command failed: tree -- --schema=/tmp/tree-schema-test -t
+$ printf '\''<A> : B;\n<B> : A;\n'\'' > /tmp/tree-schema-test
+$ tree -- --schema=/tmp/tree-schema-test -t
+tree: error: schema: /tmp/tree-schema-test:1: cyclic base of type '\''A'\''
+command failed: tree -- --schema=/tmp/tree-schema-test -t
+$ printf '\''<A> : Node @ <B> x;\n'\'' > /tmp/tree-schema-test
+$ tree -- --schema=/tmp/tree-schema-test -t
+tree: error: schema: /tmp/tree-schema-test:1: expected '\''['\''
+command failed: tree -- --schema=/tmp/tree-schema-test -t
+$ rm -f /tmp/tree-type-cache-test{,.lock,.log}
+$ printf '\''<Node>;\n<A> : Node;\n'\'' > /tmp/tree-schema-test
+$ tree --type-cache=/tmp/tree-type-cache-test --verbose "A()" -- --schema=/tmp/tree-schema-test
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''A'\''))
+$ tree --type-cache=/tmp/tree-type-cache-test --verbose "A()" -- --schema=/tmp/tree-schema-test
+tree: type-cache: hit
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''A'\''))
+$ printf '\''<Node>;\n<AB> : Node;\n'\'' > /tmp/tree-schema-test
+$ tree --type-cache=/tmp/tree-type-cache-test --verbose "A()" -- --schema=/tmp/tree-schema-test
+tree: error: unknown AST type name '\''A'\''
+command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "A()" -- --schema=/tmp/tree-schema-test
+$ rm -f /tmp/tree-type-cache-test{,.lock,.log}
+$ rm -f /tmp/tree-schema-test'
+) -L schema.new <(
+echo '$ cd ../src/tree'
+cd ../src/tree 2>&1 ||
+echo 'command failed: cd ../src/tree'
+
+echo '$ export LD_LIBRARY_PATH=.:abc:cxxpy'
+export LD_LIBRARY_PATH=.:abc:cxxpy 2>&1 ||
+echo 'command failed: export LD_LIBRARY_PATH=.:abc:cxxpy'
+
+echo '$ tree() { ./tree -F schema/schema.so "$@"; }'
+tree() { ./tree -F schema/schema.so "$@"; } 2>&1 ||
+echo 'command failed: tree() { ./tree -F schema/schema.so "$@"; }'
+
+echo '$ tree -- --schema=abc/grammar.g++ -t|diff -u - <(./tree -F abc/abc.so -- -t)'
+tree -- --schema=abc/grammar.g++ -t|diff -u - <(./tree -F abc/abc.so -- -t) 2>&1 ||
+echo 'command failed: tree -- --schema=abc/grammar.g++ -t|diff -u - <(./tree -F abc/abc.so -- -t)'
+
+echo '$ tree -- --schema=cxxpy/grammar.g++ -t|diff -u - <(./tree -F cxxpy/cxxpy.so -- -t)'
+tree -- --schema=cxxpy/grammar.g++ -t|diff -u - <(./tree -F cxxpy/cxxpy.so -- -t) 2>&1 ||
+echo 'command failed: tree -- --schema=cxxpy/grammar.g++ -t|diff -u - <(./tree -F cxxpy/cxxpy.so -- -t)'
+
+echo '$ tree "P(.x=A().y=Q())" -- --schema=abc/grammar.g++'
+tree "P(.x=A().y=Q())" -- --schema=abc/grammar.g++ 2>&1 ||
+echo 'command failed: tree "P(.x=A().y=Q())" -- --schema=abc/grammar.g++'
+
+echo '$ tree "P(.x=A().y=Q())" -- --schema=abc/grammar.g++ -r'
+tree "P(.x=A().y=Q())" -- --schema=abc/grammar.g++ -r 2>&1 ||
+echo 'command failed: tree "P(.x=A().y=Q())" -- --schema=abc/grammar.g++ -r'
+
+echo '$ tree "L(.q=list<R>[[0]=A()])" -- --schema=abc/grammar.g++ -r'
+tree "L(.q=list<R>[[0]=A()])" -- --schema=abc/grammar.g++ -r 2>&1 ||
+echo 'command failed: tree "L(.q=list<R>[[0]=A()])" -- --schema=abc/grammar.g++ -r'
+
+echo '$ tree "N(.x=B(.a=Q()).y=C(.b=list<B>[[0]=B(.a=R())]).z=D(.c='\''x'\''))" -- --schema=abc/grammar.g++ -r'
+tree "N(.x=B(.a=Q()).y=C(.b=list<B>[[0]=B(.a=R())]).z=D(.c='x'))" -- --schema=abc/grammar.g++ -r 2>&1 ||
+echo 'command failed: tree "N(.x=B(.a=Q()).y=C(.b=list<B>[[0]=B(.a=R())]).z=D(.c='\''x'\''))" -- --schema=abc/grammar.g++ -r'
+
+echo '$ tree '\''N(.x=Z().y=C(.b=list<B>[[0]=B(.a=A()) [1]=A() [2]=X()]).z=D(.c=A()))'\'' -- --schema=abc/grammar.g++ -V'
+tree 'N(.x=Z().y=C(.b=list<B>[[0]=B(.a=A()) [1]=A() [2]=X()]).z=D(.c=A()))' -- --schema=abc/grammar.g++ -V 2>&1 ||
+echo 'command failed: tree '\''N(.x=Z().y=C(.b=list<B>[[0]=B(.a=A()) [1]=A() [2]=X()]).z=D(.c=A()))'\'' -- --schema=abc/grammar.g++ -V'
+
+echo '$ tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- --schema=cxxpy/grammar.g++'
+tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('self')))])" -- --schema=cxxpy/grammar.g++ 2>&1 ||
+echo 'command failed: tree "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- --schema=cxxpy/grammar.g++'
+
+echo '$ tree "SimpleStmtList(.list=list<Stmt>[[0]=AssertStmt1(.expr1=Expr())])" -- --schema=cxxpy/grammar.g++ -r'
+tree "SimpleStmtList(.list=list<Stmt>[[0]=AssertStmt1(.expr1=Expr())])" -- --schema=cxxpy/grammar.g++ -r 2>&1 ||
+echo 'command failed: tree "SimpleStmtList(.list=list<Stmt>[[0]=AssertStmt1(.expr1=Expr())])" -- --schema=cxxpy/grammar.g++ -r'
+
+echo '$ tree "P(.x=A().y=Q())"'
+tree "P(.x=A().y=Q())" 2>&1 ||
+echo 'command failed: tree "P(.x=A().y=Q())"'
+
+echo '$ tree "P(.x=A().y=Q())" -- --schema=abc/grammar.g++ -o'
+tree "P(.x=A().y=Q())" -- --schema=abc/grammar.g++ -o 2>&1 ||
+echo 'command failed: tree "P(.x=A().y=Q())" -- --schema=abc/grammar.g++ -o'
+
+echo '$ tree -- --schema=abc/grammar.g++'
+tree -- --schema=abc/grammar.g++ 2>&1 ||
+echo 'command failed: tree -- --schema=abc/grammar.g++'
+
+echo '$ tree -- --schema=/tmp/tree-schema-nofile -t'
+tree -- --schema=/tmp/tree-schema-nofile -t 2>&1 ||
+echo 'command failed: tree -- --schema=/tmp/tree-schema-nofile -t'
+
+echo '$ printf '\''<A> : Node;\n<B> : A @ <A>* [a];\n<A> : B;\n'\'' > /tmp/tree-schema-test'
+printf '<A> : Node;\n<B> : A @ <A>* [a];\n<A> : B;\n' > /tmp/tree-schema-test 2>&1 ||
+echo 'command failed: printf '\''<A> : Node;\n<B> : A @ <A>* [a];\n<A> : B;\n'\'' > /tmp/tree-schema-test'
+
+echo '$ tree -- --schema=/tmp/tree-schema-test -t'
+tree -- --schema=/tmp/tree-schema-test -t 2>&1 ||
+echo 'command failed: tree -- --schema=/tmp/tree-schema-test -t'
+
+echo '$ printf '\''<A> : B;\n<B> : A;\n'\'' > /tmp/tree-schema-test'
+printf '<A> : B;\n<B> : A;\n' > /tmp/tree-schema-test 2>&1 ||
+echo 'command failed: printf '\''<A> : B;\n<B> : A;\n'\'' > /tmp/tree-schema-test'
+
+echo '$ tree -- --schema=/tmp/tree-schema-test -t'
+tree -- --schema=/tmp/tree-schema-test -t 2>&1 ||
+echo 'command failed: tree -- --schema=/tmp/tree-schema-test -t'
+
+echo '$ printf '\''<A> : Node @ <B> x;\n'\'' > /tmp/tree-schema-test'
+printf '<A> : Node @ <B> x;\n' > /tmp/tree-schema-test 2>&1 ||
+echo 'command failed: printf '\''<A> : Node @ <B> x;\n'\'' > /tmp/tree-schema-test'
+
+echo '$ tree -- --schema=/tmp/tree-schema-test -t'
+tree -- --schema=/tmp/tree-schema-test -t 2>&1 ||
+echo 'command failed: tree -- --schema=/tmp/tree-schema-test -t'
+
+echo '$ rm -f /tmp/tree-type-cache-test{,.lock,.log}'
+rm -f /tmp/tree-type-cache-test{,.lock,.log} 2>&1 ||
+echo 'command failed: rm -f /tmp/tree-type-cache-test{,.lock,.log}'
+
+echo '$ printf '\''<Node>;\n<A> : Node;\n'\'' > /tmp/tree-schema-test'
+printf '<Node>;\n<A> : Node;\n' > /tmp/tree-schema-test 2>&1 ||
+echo 'command failed: printf '\''<Node>;\n<A> : Node;\n'\'' > /tmp/tree-schema-test'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test --verbose "A()" -- --schema=/tmp/tree-schema-test'
+tree --type-cache=/tmp/tree-type-cache-test --verbose "A()" -- --schema=/tmp/tree-schema-test 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "A()" -- --schema=/tmp/tree-schema-test'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test --verbose "A()" -- --schema=/tmp/tree-schema-test'
+tree --type-cache=/tmp/tree-type-cache-test --verbose "A()" -- --schema=/tmp/tree-schema-test 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "A()" -- --schema=/tmp/tree-schema-test'
+
+echo '$ printf '\''<Node>;\n<AB> : Node;\n'\'' > /tmp/tree-schema-test'
+printf '<Node>;\n<AB> : Node;\n' > /tmp/tree-schema-test 2>&1 ||
+echo 'command failed: printf '\''<Node>;\n<AB> : Node;\n'\'' > /tmp/tree-schema-test'
+
+echo '$ tree --type-cache=/tmp/tree-type-cache-test --verbose "A()" -- --schema=/tmp/tree-schema-test'
+tree --type-cache=/tmp/tree-type-cache-test --verbose "A()" -- --schema=/tmp/tree-schema-test 2>&1 ||
+echo 'command failed: tree --type-cache=/tmp/tree-type-cache-test --verbose "A()" -- --schema=/tmp/tree-schema-test'
+
+echo '$ rm -f /tmp/tree-type-cache-test{,.lock,.log}'
+rm -f /tmp/tree-type-cache-test{,.lock,.log} 2>&1 ||
+echo 'command failed: rm -f /tmp/tree-type-cache-test{,.lock,.log}'
+
+echo '$ rm -f /tmp/tree-schema-test'
+rm -f /tmp/tree-schema-test 2>&1 ||
+echo 'command failed: rm -f /tmp/tree-schema-test'
+)
+
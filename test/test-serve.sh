@@ -0,0 +1,174 @@
+#!/bin/bash
+
+# Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+# 
+# This file is part of C++Py-Tree.
+# 
+# C++Py-Tree is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# C++Py-Tree is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#
+# File generated by a command like:
+# $ gen-test -T serve
+#
+
+[[ "$1" =~ ^-u[0-9]+$ ]] &&
+u="${1:2}" ||
+u=""
+
+diff -u$u -L serve.old <(echo \
+'$ cd ../src/tree
+$ export LD_LIBRARY_PATH=.:abc:cxxpy
+$ serve() { ./tree-client -e "$@"; }
+$ { serve "A()" -- -o; serve "P(.x=A().y=Q())" -- -or; serve "P(.x=A().y=Q())" -- -o; serve "S()" -- -t; }|./tree -F abc/abc.so --serve|./tree-client -d
+A()
+P(.x=A().y=Q())
+tree: error: ast-type P: arg #2: cannot cast from type '\''Q'\'' to '\''A'\''
+<Node>;
+<A> : Node;
+<B> : Node @ <A>* [a];
+<C> : Node @ list<B> [b];
+<D> : Node @ <char*> [c];
+<N> : Node @ <B>* [x], <C>* [y], <D>* [z];
+<M> : Node @ <A>* [a], list<B> [b], <char*> [c];
+<P> : Node @ <A>* [x], <A>* [y];
+<Q> : A;
+<R> : Q;
+<L> : Node @ list<Q> [q];
+<S> : Q @ <bool> [b];
+$ rm -f /tmp/tree-trace-test{,2}
+$ { serve "A()" -- --trace-file=/tmp/tree-trace-test; serve "B(.a=A())"; serve "P(.x=A().y=A())" -- --trace-file=/tmp/tree-trace-test2; }|./tree -F abc/abc.so --serve|./tree-client -d
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''A'\''))
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''B'\''))
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''P'\''))
+$ ./tree -F abc/abc.so -- --decode-trace --trace-file=/tmp/tree-trace-test
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''A'\''))
+$ ./tree -F abc/abc.so -- --decode-trace --trace-file=/tmp/tree-trace-test2
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''A'\''))
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''A'\''))
+visit(const TreeAST::TreeNode*): ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''P'\''))
+$ rm -f /tmp/tree-trace-test{,2}
+$ { serve "A()" -- -v; serve "A()" -- --dump-opt; serve "A(" -- -o; serve -S; serve "A()"; }|./tree -F abc/abc.so --serve|./tree-client -d
+tree: error: serve: request option not allowed: '\''-v'\''
+tree: error: serve: request option not allowed: '\''--dump-opt'\''
+tree: parse error: <text>:1:3: unexpected token EOS in node_args
+$ { serve "A()" -- --schema=abc/grammar.g++; serve "IdentExpr(.ident=Ident('\''a'\''))" -- --schema=cxxpy/grammar.g++; serve "P(.x=A().y=Q())" -- --schema=abc/grammar.g++ -r; serve "S()" -- -t; }|./tree -F schema/schema.so --serve|./tree-client -d
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''A'\''))
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''IdentExpr'\''))
+ObjType(.type = '\''node'\'' .node = NodeObjType(.ast_type = '\''P'\''))
+tree: schema: error: no schema given
+command failed: { serve "A()" -- --schema=abc/grammar.g++; serve "IdentExpr(.ident=Ident('\''a'\''))" -- --schema=cxxpy/grammar.g++; serve "P(.x=A().y=Q())" -- --schema=abc/grammar.g++ -r; serve "S()" -- -t; }|./tree -F schema/schema.so --serve|./tree-client -d
+$ serve "A(.x=B().y='\''C'\'')" "A()"|static/tree -P --serve|./tree-client -d
+A(
+    .x = B()
+    .y = '\''C'\''
+)
+A()
+$ ./tree --serve "A()"
+tree: error: serve: inputs are given by requests
+command failed: ./tree --serve "A()"
+$ ./tree --serve -- -o
+tree: error: serve: extension module arguments are given by requests
+command failed: ./tree --serve -- -o
+$ ./tree --serve --workers=0
+tree: error: invalid argument for '\''workers'\'' option: '\''0'\''
+command failed: ./tree --serve --workers=0
+$ sock() { local s=/tmp/tree-serve-test.$$; ./tree -F abc/abc.so --serve=$s --workers=2 & ./tree-client -s $s "$@"; local r=$?; ./tree-client -s $s -S; wait; return $r; }
+$ sock "A()" "P(.x=A().y=Q())" -- -or
+A()
+P(.x=A().y=Q())
+$ sock "P(.x=A().y=Q())" "A()" -- -o
+tree: error: ast-type P: arg #2: cannot cast from type '\''Q'\'' to '\''A'\''
+command failed: sock "P(.x=A().y=Q())" "A()" -- -o
+$ sock -n 1000 -c 4 "A()" "P(.x=A().y=Q())" -- -or|head -3
+requests:   1000
+conns:      4
+failures:   0'
+) -L serve.new <(
+echo '$ cd ../src/tree'
+cd ../src/tree 2>&1 ||
+echo 'command failed: cd ../src/tree'
+
+echo '$ export LD_LIBRARY_PATH=.:abc:cxxpy'
+export LD_LIBRARY_PATH=.:abc:cxxpy 2>&1 ||
+echo 'command failed: export LD_LIBRARY_PATH=.:abc:cxxpy'
+
+echo '$ serve() { ./tree-client -e "$@"; }'
+serve() { ./tree-client -e "$@"; } 2>&1 ||
+echo 'command failed: serve() { ./tree-client -e "$@"; }'
+
+echo '$ { serve "A()" -- -o; serve "P(.x=A().y=Q())" -- -or; serve "P(.x=A().y=Q())" -- -o; serve "S()" -- -t; }|./tree -F abc/abc.so --serve|./tree-client -d'
+{ serve "A()" -- -o; serve "P(.x=A().y=Q())" -- -or; serve "P(.x=A().y=Q())" -- -o; serve "S()" -- -t; }|./tree -F abc/abc.so --serve|./tree-client -d 2>&1 ||
+echo 'command failed: { serve "A()" -- -o; serve "P(.x=A().y=Q())" -- -or; serve "P(.x=A().y=Q())" -- -o; serve "S()" -- -t; }|./tree -F abc/abc.so --serve|./tree-client -d'
+
+echo '$ rm -f /tmp/tree-trace-test{,2}'
+rm -f /tmp/tree-trace-test{,2} 2>&1 ||
+echo 'command failed: rm -f /tmp/tree-trace-test{,2}'
+
+echo '$ { serve "A()" -- --trace-file=/tmp/tree-trace-test; serve "B(.a=A())"; serve "P(.x=A().y=A())" -- --trace-file=/tmp/tree-trace-test2; }|./tree -F abc/abc.so --serve|./tree-client -d'
+{ serve "A()" -- --trace-file=/tmp/tree-trace-test; serve "B(.a=A())"; serve "P(.x=A().y=A())" -- --trace-file=/tmp/tree-trace-test2; }|./tree -F abc/abc.so --serve|./tree-client -d 2>&1 ||
+echo 'command failed: { serve "A()" -- --trace-file=/tmp/tree-trace-test; serve "B(.a=A())"; serve "P(.x=A().y=A())" -- --trace-file=/tmp/tree-trace-test2; }|./tree -F abc/abc.so --serve|./tree-client -d'
+
+echo '$ ./tree -F abc/abc.so -- --decode-trace --trace-file=/tmp/tree-trace-test'
+./tree -F abc/abc.so -- --decode-trace --trace-file=/tmp/tree-trace-test 2>&1 ||
+echo 'command failed: ./tree -F abc/abc.so -- --decode-trace --trace-file=/tmp/tree-trace-test'
+
+echo '$ ./tree -F abc/abc.so -- --decode-trace --trace-file=/tmp/tree-trace-test2'
+./tree -F abc/abc.so -- --decode-trace --trace-file=/tmp/tree-trace-test2 2>&1 ||
+echo 'command failed: ./tree -F abc/abc.so -- --decode-trace --trace-file=/tmp/tree-trace-test2'
+
+echo '$ rm -f /tmp/tree-trace-test{,2}'
+rm -f /tmp/tree-trace-test{,2} 2>&1 ||
+echo 'command failed: rm -f /tmp/tree-trace-test{,2}'
+
+echo '$ { serve "A()" -- -v; serve "A()" -- --dump-opt; serve "A(" -- -o; serve -S; serve "A()"; }|./tree -F abc/abc.so --serve|./tree-client -d'
+{ serve "A()" -- -v; serve "A()" -- --dump-opt; serve "A(" -- -o; serve -S; serve "A()"; }|./tree -F abc/abc.so --serve|./tree-client -d 2>&1 ||
+echo 'command failed: { serve "A()" -- -v; serve "A()" -- --dump-opt; serve "A(" -- -o; serve -S; serve "A()"; }|./tree -F abc/abc.so --serve|./tree-client -d'
+
+echo '$ { serve "A()" -- --schema=abc/grammar.g++; serve "IdentExpr(.ident=Ident('\''a'\''))" -- --schema=cxxpy/grammar.g++; serve "P(.x=A().y=Q())" -- --schema=abc/grammar.g++ -r; serve "S()" -- -t; }|./tree -F schema/schema.so --serve|./tree-client -d'
+{ serve "A()" -- --schema=abc/grammar.g++; serve "IdentExpr(.ident=Ident('a'))" -- --schema=cxxpy/grammar.g++; serve "P(.x=A().y=Q())" -- --schema=abc/grammar.g++ -r; serve "S()" -- -t; }|./tree -F schema/schema.so --serve|./tree-client -d 2>&1 ||
+echo 'command failed: { serve "A()" -- --schema=abc/grammar.g++; serve "IdentExpr(.ident=Ident('\''a'\''))" -- --schema=cxxpy/grammar.g++; serve "P(.x=A().y=Q())" -- --schema=abc/grammar.g++ -r; serve "S()" -- -t; }|./tree -F schema/schema.so --serve|./tree-client -d'
+
+echo '$ serve "A(.x=B().y='\''C'\'')" "A()"|static/tree -P --serve|./tree-client -d'
+serve "A(.x=B().y='C')" "A()"|static/tree -P --serve|./tree-client -d 2>&1 ||
+echo 'command failed: serve "A(.x=B().y='\''C'\'')" "A()"|static/tree -P --serve|./tree-client -d'
+
+echo '$ ./tree --serve "A()"'
+./tree --serve "A()" 2>&1 ||
+echo 'command failed: ./tree --serve "A()"'
+
+echo '$ ./tree --serve -- -o'
+./tree --serve -- -o 2>&1 ||
+echo 'command failed: ./tree --serve -- -o'
+
+echo '$ ./tree --serve --workers=0'
+./tree --serve --workers=0 2>&1 ||
+echo 'command failed: ./tree --serve --workers=0'
+
+echo '$ sock() { local s=/tmp/tree-serve-test.$$; ./tree -F abc/abc.so --serve=$s --workers=2 & ./tree-client -s $s "$@"; local r=$?; ./tree-client -s $s -S; wait; return $r; }'
+sock() { local s=/tmp/tree-serve-test.$$; ./tree -F abc/abc.so --serve=$s --workers=2 & ./tree-client -s $s "$@"; local r=$?; ./tree-client -s $s -S; wait; return $r; } 2>&1 ||
+echo 'command failed: sock() { local s=/tmp/tree-serve-test.$$; ./tree -F abc/abc.so --serve=$s --workers=2 & ./tree-client -s $s "$@"; local r=$?; ./tree-client -s $s -S; wait; return $r; }'
+
+echo '$ sock "A()" "P(.x=A().y=Q())" -- -or'
+sock "A()" "P(.x=A().y=Q())" -- -or 2>&1 ||
+echo 'command failed: sock "A()" "P(.x=A().y=Q())" -- -or'
+
+echo '$ sock "P(.x=A().y=Q())" "A()" -- -o'
+sock "P(.x=A().y=Q())" "A()" -- -o 2>&1 ||
+echo 'command failed: sock "P(.x=A().y=Q())" "A()" -- -o'
+
+echo '$ sock -n 1000 -c 4 "A()" "P(.x=A().y=Q())" -- -or|head -3'
+sock -n 1000 -c 4 "A()" "P(.x=A().y=Q())" -- -or|head -3 2>&1 ||
+echo 'command failed: sock -n 1000 -c 4 "A()" "P(.x=A().y=Q())" -- -or|head -3'
+)
+
@@ -0,0 +1,110 @@
+#!/bin/bash
+
+# Copyright (C) 2016, 2017, 2021  Stefan Vargyas
+# 
+# This file is part of C++Py-Tree.
+# 
+# C++Py-Tree is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# C++Py-Tree is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with C++Py-Tree.  If not, see <http://www.gnu.org/licenses/>.
+
+#
+# File generated by a command like:
+# $ gen-test -T static
+#
+
+[[ "$1" =~ ^-u[0-9]+$ ]] &&
+u="${1:2}" ||
+u=""
+
+diff -u$u -L static.old <(echo \
+'$ cd ../src/tree
+$ export LD_LIBRARY_PATH=.:abc:cxxpy
+$ tree() { static/tree "$@"; }
+$ tree -F cxxpy/cxxpy.so -- -t|diff -u - <(./tree -F cxxpy/cxxpy.so -- -t)
+$ tree -F schema/schema.so -- --schema=abc/grammar.g++ -t|diff -u - <(./tree -F abc/abc.so -- -t)
+$ tree -F abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "P(.x=A().y=Q())" -- -or
+M(.a=A().b=list<B>[[0]=B(.a=A())]'\''x'\'')
+P(.x=A().y=Q())
+$ tree -F cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- -o -r
+StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])
+$ tree -F cxxpy/cxxpy.so "Ident('\''a'\'')" -- -V
+$ tree -P "A(.x=B().y='\''C'\'')"
+A(
+    .x = B()
+    .y = '\''C'\''
+)
+$ tree -F printer::dump "A()"
+Tree(
+    TreeNode(
+        NodeName('\''A'\'')
+        ListArgs(
+            list<NodeArg> []
+        )
+    )
+)
+$ tree -F foo
+tree: error: failed loading module '\''foo.so'\'': not linked in
+command failed: tree -F foo
+$ tree -F abc/abc.so::foo
+tree: error: cannot find func '\''foo'\'': not linked in
+command failed: tree -F abc/abc.so::foo'
+) -L static.new <(
+echo '$ cd ../src/tree'
+cd ../src/tree 2>&1 ||
+echo 'command failed: cd ../src/tree'
+
+echo '$ export LD_LIBRARY_PATH=.:abc:cxxpy'
+export LD_LIBRARY_PATH=.:abc:cxxpy 2>&1 ||
+echo 'command failed: export LD_LIBRARY_PATH=.:abc:cxxpy'
+
+echo '$ tree() { static/tree "$@"; }'
+tree() { static/tree "$@"; } 2>&1 ||
+echo 'command failed: tree() { static/tree "$@"; }'
+
+echo '$ tree -F cxxpy/cxxpy.so -- -t|diff -u - <(./tree -F cxxpy/cxxpy.so -- -t)'
+tree -F cxxpy/cxxpy.so -- -t|diff -u - <(./tree -F cxxpy/cxxpy.so -- -t) 2>&1 ||
+echo 'command failed: tree -F cxxpy/cxxpy.so -- -t|diff -u - <(./tree -F cxxpy/cxxpy.so -- -t)'
+
+echo '$ tree -F schema/schema.so -- --schema=abc/grammar.g++ -t|diff -u - <(./tree -F abc/abc.so -- -t)'
+tree -F schema/schema.so -- --schema=abc/grammar.g++ -t|diff -u - <(./tree -F abc/abc.so -- -t) 2>&1 ||
+echo 'command failed: tree -F schema/schema.so -- --schema=abc/grammar.g++ -t|diff -u - <(./tree -F abc/abc.so -- -t)'
+
+echo '$ tree -F abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "P(.x=A().y=Q())" -- -or'
+tree -F abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='x')" "P(.x=A().y=Q())" -- -or 2>&1 ||
+echo 'command failed: tree -F abc/abc.so "M(.a=A().b=list<B>[[0]=B(.a=A())].c='\''x'\'')" "P(.x=A().y=Q())" -- -or'
+
+echo '$ tree -F cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- -o -r'
+tree -F cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('self')))])" -- -o -r 2>&1 ||
+echo 'command failed: tree -F cxxpy/cxxpy.so "StmtList(.list=list<Stmt>[[0]=ExprStmt(.expr=IdentExpr(.ident=Ident('\''self'\'')))])" -- -o -r'
+
+echo '$ tree -F cxxpy/cxxpy.so "Ident('\''a'\'')" -- -V'
+tree -F cxxpy/cxxpy.so "Ident('a')" -- -V 2>&1 ||
+echo 'command failed: tree -F cxxpy/cxxpy.so "Ident('\''a'\'')" -- -V'
+
+echo '$ tree -P "A(.x=B().y='\''C'\'')"'
+tree -P "A(.x=B().y='C')" 2>&1 ||
+echo 'command failed: tree -P "A(.x=B().y='\''C'\'')"'
+
+echo '$ tree -F printer::dump "A()"'
+tree -F printer::dump "A()" 2>&1 ||
+echo 'command failed: tree -F printer::dump "A()"'
+
+echo '$ tree -F foo'
+tree -F foo 2>&1 ||
+echo 'command failed: tree -F foo'
+
+echo '$ tree -F abc/abc.so::foo'
+tree -F abc/abc.so::foo 2>&1 ||
+echo 'command failed: tree -F abc/abc.so::foo'
+)
+
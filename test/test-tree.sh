@@ -115,7 +115,83 @@ D(
 .   ]
 )
 $ tree -T '\''D(.l=list<B>[[0]=B()])'\''
-D(.l=list<B>[[0]=B()])'
+D(.l=list<B>[[0]=B()])
+$ tree -H --verbose -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])"
+tree: hash-cons: nodes: 57 shared: 25 ratio: 43.86% strings: 21 shared: 12 lists: 6 shared: 2
+A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])
+$ tree -R -P '\''D(.l=list<B>[[0]=B()])'\''
+D(
+.   .l = list<B> [
+.   .   [0] = B()
+.   ]
+)
+$ tree -H -R -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])"
+A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])
+$ tree --mem-stats -T "A(.x=B(.y=C('\''s'\'')).z=list<B>[[0]=B()])"
+tree: mem-stats: pool=node objs=26 max-objs=8192 bytes=1000 max-bytes=131072 padding=208 rollbacks=0 high-water=1000
+tree: mem-stats: pool=raw objs=12 max-objs=4096 bytes=80 max-bytes=65536 padding=30 rollbacks=0 high-water=80
+tree: mem-stats: type=ArgName count=3 bytes=96
+tree: mem-stats: type=ListArgs count=3 bytes=96
+tree: mem-stats: type=ListElem count=1 bytes=24
+tree: mem-stats: type=ListValue count=1 bytes=24
+tree: mem-stats: type=Literal count=1 bytes=32
+tree: mem-stats: type=LiteralArgs count=1 bytes=24
+tree: mem-stats: type=NodeArg count=3 bytes=96
+tree: mem-stats: type=NodeList count=1 bytes=40
+tree: mem-stats: type=NodeName count=5 bytes=160
+tree: mem-stats: type=NodeValue count=2 bytes=48
+tree: mem-stats: type=Tree count=1 bytes=24
+tree: mem-stats: type=TreeNode count=4 bytes=128
+A(.x=B(.y=C('\''s'\'')).z=list<B>[[0]=B()])
+$ tree --fingerprint -n '\''A(.x=B())'\'' '\''A( .x = B() )'\'' '\''A(.x=C())'\'' '\''A(.y=B())'\''
+tree: fingerprint: b036981b74e7a395e16b0fc0925db81b
+tree: fingerprint: b036981b74e7a395e16b0fc0925db81b
+tree: fingerprint: 50cc81566b4a9d0cc0cc2a7aa49155da
+tree: fingerprint: 31c2592d83acc6c7a704fa9f8d6b11fc
+$ tree --fingerprint -R -H -n '\''A(.x=B())'\''
+tree: fingerprint: b036981b74e7a395e16b0fc0925db81b
+$ tree -H --extract --mem-stats -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))])"
+tree: mem-stats: pool=node objs=24 max-objs=24 bytes=920 max-bytes=920 padding=192 rollbacks=0 high-water=920
+tree: mem-stats: pool=raw objs=11 max-objs=11 bytes=72 max-bytes=88 padding=16 rollbacks=0 high-water=72
+tree: mem-stats: type=ArgName count=4 bytes=128
+tree: mem-stats: type=ListArgs count=2 bytes=64
+tree: mem-stats: type=ListElem count=1 bytes=24
+tree: mem-stats: type=ListValue count=1 bytes=24
+tree: mem-stats: type=Literal count=1 bytes=32
+tree: mem-stats: type=LiteralArgs count=1 bytes=24
+tree: mem-stats: type=NodeArg count=4 bytes=128
+tree: mem-stats: type=NodeList count=1 bytes=40
+tree: mem-stats: type=NodeName count=3 bytes=96
+tree: mem-stats: type=NodeValue count=2 bytes=48
+tree: mem-stats: type=Tree count=1 bytes=24
+tree: mem-stats: type=TreeNode count=3 bytes=96
+A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))])
+$ tree --mem-stats -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])" 2>&1|grep -E '\''type=(Literal|NodeName|TreeNode) '\''
+tree: mem-stats: type=Literal count=4 bytes=128
+tree: mem-stats: type=NodeName count=10 bytes=320
+tree: mem-stats: type=TreeNode count=9 bytes=288
+$ tree -H --mem-stats -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])" 2>&1|grep -E '\''type=(Literal|NodeName|TreeNode) '\''
+tree: mem-stats: type=Literal count=2 bytes=64
+tree: mem-stats: type=NodeName count=3 bytes=96
+tree: mem-stats: type=TreeNode count=5 bytes=160
+$ tree -H -R --mem-stats -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])" 2>&1|grep -E '\''type=(Literal|NodeName|TreeNode) '\''
+tree: mem-stats: type=Literal count=2 bytes=64
+tree: mem-stats: type=NodeName count=3 bytes=96
+tree: mem-stats: type=TreeNode count=5 bytes=160
+$ tree --relayout=5 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"
+tree: exception: AST::PoolAllocator::BadAlloc: <node> PoolAllocator exceeded nobjs limits [nobjs=5, pool_sz=800]
+command failed: tree --relayout=5 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"
+$ tree --relayout=20 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"
+tree: exception: AST::PoolAllocator::BadAlloc: <node> PoolAllocator exceeded nobjs limits [nobjs=20, pool_sz=800]
+command failed: tree --relayout=20 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"
+$ tree --relayout=21 --mem-stats -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])" 2>&1|grep pool=node
+tree: mem-stats: pool=node objs=21 max-objs=21 bytes=800 max-bytes=800 padding=168 rollbacks=0 high-water=800
+$ tree -H --fingerprint --relayout=5 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"
+tree: exception: AST::PoolAllocator::BadAlloc: <node> PoolAllocator exceeded nobjs limits [nobjs=5, pool_sz=608]
+command failed: tree -H --fingerprint --relayout=5 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"
+$ tree --relayout=0 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"
+tree: error: invalid argument for '\''relayout'\'' option: '\''0'\''
+command failed: tree --relayout=0 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"'
 ) -L tree.new <(
 echo '$ cd ../src/tree'
 cd ../src/tree 2>&1 ||
@@ -156,5 +232,65 @@ echo 'command failed: tree -P '\''D(.l=list<B>[[0]=B()])'\'''
 echo '$ tree -T '\''D(.l=list<B>[[0]=B()])'\'''
 tree -T 'D(.l=list<B>[[0]=B()])' 2>&1 ||
 echo 'command failed: tree -T '\''D(.l=list<B>[[0]=B()])'\'''
+
+echo '$ tree -H --verbose -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])"'
+tree -H --verbose -T "A(.x=B(.y=C('s')).z=B(.y=C('s')).w=list<B>[[0]=B(.y=C('s'))[1]=B(.y=C('t'))])" 2>&1 ||
+echo 'command failed: tree -H --verbose -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])"'
+
+echo '$ tree -R -P '\''D(.l=list<B>[[0]=B()])'\'''
+tree -R -P 'D(.l=list<B>[[0]=B()])' 2>&1 ||
+echo 'command failed: tree -R -P '\''D(.l=list<B>[[0]=B()])'\'''
+
+echo '$ tree -H -R -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])"'
+tree -H -R -T "A(.x=B(.y=C('s')).z=B(.y=C('s')).w=list<B>[[0]=B(.y=C('s'))[1]=B(.y=C('t'))])" 2>&1 ||
+echo 'command failed: tree -H -R -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])"'
+
+echo '$ tree --mem-stats -T "A(.x=B(.y=C('\''s'\'')).z=list<B>[[0]=B()])"'
+tree --mem-stats -T "A(.x=B(.y=C('s')).z=list<B>[[0]=B()])" 2>&1 ||
+echo 'command failed: tree --mem-stats -T "A(.x=B(.y=C('\''s'\'')).z=list<B>[[0]=B()])"'
+
+echo '$ tree --fingerprint -n '\''A(.x=B())'\'' '\''A( .x = B() )'\'' '\''A(.x=C())'\'' '\''A(.y=B())'\'''
+tree --fingerprint -n 'A(.x=B())' 'A( .x = B() )' 'A(.x=C())' 'A(.y=B())' 2>&1 ||
+echo 'command failed: tree --fingerprint -n '\''A(.x=B())'\'' '\''A( .x = B() )'\'' '\''A(.x=C())'\'' '\''A(.y=B())'\'''
+
+echo '$ tree --fingerprint -R -H -n '\''A(.x=B())'\'''
+tree --fingerprint -R -H -n 'A(.x=B())' 2>&1 ||
+echo 'command failed: tree --fingerprint -R -H -n '\''A(.x=B())'\'''
+
+echo '$ tree -H --extract --mem-stats -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))])"'
+tree -H --extract --mem-stats -T "A(.x=B(.y=C('s')).z=B(.y=C('s')).w=list<B>[[0]=B(.y=C('s'))])" 2>&1 ||
+echo 'command failed: tree -H --extract --mem-stats -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))])"'
+
+echo '$ tree --mem-stats -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])" 2>&1|grep -E '\''type=(Literal|NodeName|TreeNode) '\'''
+tree --mem-stats -T "A(.x=B(.y=C('s')).z=B(.y=C('s')).w=list<B>[[0]=B(.y=C('s'))[1]=B(.y=C('t'))])" 2>&1|grep -E 'type=(Literal|NodeName|TreeNode) ' 2>&1 ||
+echo 'command failed: tree --mem-stats -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])" 2>&1|grep -E '\''type=(Literal|NodeName|TreeNode) '\'''
+
+echo '$ tree -H --mem-stats -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])" 2>&1|grep -E '\''type=(Literal|NodeName|TreeNode) '\'''
+tree -H --mem-stats -T "A(.x=B(.y=C('s')).z=B(.y=C('s')).w=list<B>[[0]=B(.y=C('s'))[1]=B(.y=C('t'))])" 2>&1|grep -E 'type=(Literal|NodeName|TreeNode) ' 2>&1 ||
+echo 'command failed: tree -H --mem-stats -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])" 2>&1|grep -E '\''type=(Literal|NodeName|TreeNode) '\'''
+
+echo '$ tree -H -R --mem-stats -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])" 2>&1|grep -E '\''type=(Literal|NodeName|TreeNode) '\'''
+tree -H -R --mem-stats -T "A(.x=B(.y=C('s')).z=B(.y=C('s')).w=list<B>[[0]=B(.y=C('s'))[1]=B(.y=C('t'))])" 2>&1|grep -E 'type=(Literal|NodeName|TreeNode) ' 2>&1 ||
+echo 'command failed: tree -H -R --mem-stats -T "A(.x=B(.y=C('\''s'\'')).z=B(.y=C('\''s'\'')).w=list<B>[[0]=B(.y=C('\''s'\''))[1]=B(.y=C('\''t'\''))])" 2>&1|grep -E '\''type=(Literal|NodeName|TreeNode) '\'''
+
+echo '$ tree --relayout=5 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"'
+tree --relayout=5 -T "A(.x=B('s').y=list<B>[[0]=B('s')])" 2>&1 ||
+echo 'command failed: tree --relayout=5 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"'
+
+echo '$ tree --relayout=20 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"'
+tree --relayout=20 -T "A(.x=B('s').y=list<B>[[0]=B('s')])" 2>&1 ||
+echo 'command failed: tree --relayout=20 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"'
+
+echo '$ tree --relayout=21 --mem-stats -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])" 2>&1|grep pool=node'
+tree --relayout=21 --mem-stats -T "A(.x=B('s').y=list<B>[[0]=B('s')])" 2>&1|grep pool=node 2>&1 ||
+echo 'command failed: tree --relayout=21 --mem-stats -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])" 2>&1|grep pool=node'
+
+echo '$ tree -H --fingerprint --relayout=5 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"'
+tree -H --fingerprint --relayout=5 -T "A(.x=B('s').y=list<B>[[0]=B('s')])" 2>&1 ||
+echo 'command failed: tree -H --fingerprint --relayout=5 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"'
+
+echo '$ tree --relayout=0 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"'
+tree --relayout=0 -T "A(.x=B('s').y=list<B>[[0]=B('s')])" 2>&1 ||
+echo 'command failed: tree --relayout=0 -T "A(.x=B('\''s'\'').y=list<B>[[0]=B('\''s'\'')])"'
 )
 
@@ -50,7 +50,11 @@ for t in \
     tree \
     print \
     cxxpy \
-    abc
+    abc \
+    schema \
+    static \
+    serve \
+    api
 do
     test -z "$q" &&
     printf >&2 "%-$((w + 6))s " "test: $t"